@@ -1,6 +1,9 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+/* Depth is tested before shading, even if this shader ever discards */
+layout(early_fragment_tests) in;
+
 layout(location = 0) in vec3 fragColor;
 
 layout(location = 0) out vec4 outColor;
@@ -1,8 +1,9 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+/* Invariant, the depth prepass and the shading pass must compute the same depth */
 out gl_PerVertex {
-    vec4 gl_Position;
+    invariant vec4 gl_Position;
 };
 
 vec2 positions[3] = vec2[](
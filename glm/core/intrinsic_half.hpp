@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref core
+/// @file glm/core/intrinsic_half.hpp
+/// @date 2016-11-04 / 2016-11-04
+/// @author Roberto Cano
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef glm_detail_intrinsic_half
+#define glm_detail_intrinsic_half
+
+#include "setup.hpp"
+
+// F16C conversions are used when the compiler targets them. With
+// GLM_FORCE_RUNTIME_DISPATCH they are built with a target attribute and only
+// taken on CPUs that report F16C; every other SSE2 build uses the bit
+// manipulation path below.
+#if(defined(__F16C__) || ((GLM_COMPILER & GLM_COMPILER_VC) && (GLM_ARCH & GLM_ARCH_AVX2)))
+#	include <immintrin.h>
+#	define GLM_F16C_TARGET
+#	define GLM_HAS_F16C_PATH 1
+#	define GLM_DISPATCH_F16C 1
+#elif(defined(GLM_FORCE_RUNTIME_DISPATCH) && (GLM_ARCH & GLM_ARCH_SSE2) && (GLM_COMPILER & (GLM_COMPILER_GCC | GLM_COMPILER_CLANG)))
+#	include <immintrin.h>
+#	define GLM_F16C_TARGET __attribute__((target("avx,f16c")))
+#	define GLM_HAS_F16C_PATH 1
+#	define GLM_DISPATCH_F16C glm::detail::f16c_supported()
+#else
+#	define GLM_HAS_F16C_PATH 0
+#	define GLM_DISPATCH_F16C 0
+#endif
+
+#if(GLM_ARCH & GLM_ARCH_SSE2)
+
+#include <cstddef>
+
+namespace glm{
+namespace detail
+{
+	// Four floats to four halves in the low 16 bits of each 32 bit lane,
+	// rounding to nearest even
+	__m128i sse_float_to_half_ps(__m128 x);
+
+	// Four halves in the low 16 bits of each 32 bit lane to four floats
+	__m128 sse_half_to_float_ps(__m128i x);
+
+	void sse_float_to_half(float const * in, unsigned short * out, std::size_t count);
+
+	void sse_half_to_float(unsigned short const * in, float * out, std::size_t count);
+
+#if(GLM_HAS_F16C_PATH)
+	// True when the running CPU supports F16C
+	bool f16c_supported();
+
+	GLM_F16C_TARGET void f16c_float_to_half(float const * in, unsigned short * out, std::size_t count);
+
+	GLM_F16C_TARGET void f16c_half_to_float(unsigned short const * in, float * out, std::size_t count);
+#endif//GLM_HAS_F16C_PATH
+
+}//namespace detail
+}//namespace glm
+
+#include "intrinsic_half.inl"
+
+#endif//GLM_ARCH
+#endif//glm_detail_intrinsic_half
@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref core
+/// @file glm/core/intrinsic_half.inl
+/// @date 2016-11-04 / 2016-11-04
+/// @author Roberto Cano
+///////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail{
+
+GLM_FUNC_QUALIFIER __m128i sse_float_to_half_ps(__m128 x)
+{
+	__m128i const SignMask = _mm_set1_epi32(0x80000000);
+	__m128i const Infinity = _mm_set1_epi32(255 << 23);
+	__m128i const Overflow = _mm_set1_epi32(((127 + 16) << 23) - 1);
+	__m128i const Subnormal = _mm_set1_epi32(113 << 23);
+	__m128i const DenormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	__m128i const Rebias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+	__m128i const One = _mm_set1_epi32(1);
+
+	__m128i Bits = _mm_castps_si128(x);
+	__m128i Sign = _mm_and_si128(Bits, SignMask);
+	Bits = _mm_xor_si128(Bits, Sign);
+
+	// Inf stays Inf, NaN becomes a quiet NaN, anything too large overflows to Inf
+	__m128i IsInfNan = _mm_cmpgt_epi32(Bits, Overflow);
+	__m128i InfNan = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(_mm_cmpgt_epi32(Bits, Infinity), _mm_set1_epi32(0x200)));
+
+	// Subnormal results: the float addition aligns the 10 mantissa bits at
+	// the bottom and does the rounding for us
+	__m128i IsSubnormal = _mm_cmplt_epi32(Bits, Subnormal);
+	__m128i Denorm = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Bits), _mm_castsi128_ps(DenormMagic))), DenormMagic);
+
+	// Normal results: rebias the exponent and round to nearest even
+	__m128i MantOdd = _mm_and_si128(_mm_srli_epi32(Bits, 13), One);
+	__m128i Normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(Bits, Rebias), MantOdd), 13);
+
+	__m128i Result = _mm_or_si128(_mm_and_si128(IsSubnormal, Denorm), _mm_andnot_si128(IsSubnormal, Normal));
+	Result = _mm_or_si128(_mm_and_si128(IsInfNan, InfNan), _mm_andnot_si128(IsInfNan, Result));
+	return _mm_or_si128(Result, _mm_srli_epi32(Sign, 16));
+}
+
+GLM_FUNC_QUALIFIER __m128 sse_half_to_float_ps(__m128i x)
+{
+	__m128i const ExpMantMask = _mm_set1_epi32(0x7fff);
+	__m128 const Magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+	__m128i const MaxFinite = _mm_set1_epi32(0x7bff);
+	__m128 const InfNanExp = _mm_castsi128_ps(_mm_set1_epi32(255 << 23));
+
+	// Scaling by 2^112 rebiases the exponent and normalizes subnormals
+	__m128i ExpMant = _mm_and_si128(x, ExpMantMask);
+	__m128 Scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(ExpMant, 13)), Magic);
+	__m128 IsInfNan = _mm_castsi128_ps(_mm_cmpgt_epi32(ExpMant, MaxFinite));
+	__m128 Sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_xor_si128(x, ExpMant), 16));
+	return _mm_or_ps(Scaled, _mm_or_ps(Sign, _mm_and_ps(IsInfNan, InfNanExp)));
+}
+
+// Packs the low 16 bits of each lane; the shifts keep packs_epi32 from saturating
+GLM_FUNC_QUALIFIER __m128i sse_pack_half(__m128i lo, __m128i hi)
+{
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+GLM_FUNC_QUALIFIER void sse_float_to_half(float const * in, unsigned short * out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i Lo = sse_float_to_half_ps(_mm_loadu_ps(in + i));
+		__m128i Hi = sse_float_to_half_ps(_mm_loadu_ps(in + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), sse_pack_half(Lo, Hi));
+	}
+
+	if(i == count)
+		return;
+
+	// Run the tail through the same kernel so every element rounds the same way
+	float Tail[8] = {0};
+	unsigned short Result[8];
+	for(std::size_t j = 0; i + j < count; ++j)
+		Tail[j] = in[i + j];
+	__m128i Lo = sse_float_to_half_ps(_mm_loadu_ps(Tail));
+	__m128i Hi = sse_float_to_half_ps(_mm_loadu_ps(Tail + 4));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(Result), sse_pack_half(Lo, Hi));
+	for(std::size_t j = 0; i + j < count; ++j)
+		out[i + j] = Result[j];
+}
+
+GLM_FUNC_QUALIFIER void sse_half_to_float(unsigned short const * in, float * out, std::size_t count)
+{
+	__m128i const Zero = _mm_setzero_si128();
+
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i Half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+		_mm_storeu_ps(out + i, sse_half_to_float_ps(_mm_unpacklo_epi16(Half, Zero)));
+		_mm_storeu_ps(out + i + 4, sse_half_to_float_ps(_mm_unpackhi_epi16(Half, Zero)));
+	}
+
+	if(i == count)
+		return;
+
+	unsigned short Tail[8] = {0};
+	float Result[8];
+	for(std::size_t j = 0; i + j < count; ++j)
+		Tail[j] = in[i + j];
+	__m128i Half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Tail));
+	_mm_storeu_ps(Result, sse_half_to_float_ps(_mm_unpacklo_epi16(Half, Zero)));
+	_mm_storeu_ps(Result + 4, sse_half_to_float_ps(_mm_unpackhi_epi16(Half, Zero)));
+	for(std::size_t j = 0; i + j < count; ++j)
+		out[i + j] = Result[j];
+}
+
+#if(GLM_HAS_F16C_PATH)
+
+GLM_FUNC_QUALIFIER bool f16c_supported()
+{
+#	if(defined(__F16C__) || (GLM_COMPILER & GLM_COMPILER_VC))
+		return true;
+#	else
+		static bool const Supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+		return Supported;
+#	endif
+}
+
+GLM_F16C_TARGET GLM_FUNC_QUALIFIER void f16c_float_to_half(float const * in, unsigned short * out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i Half = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), Half);
+	}
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i Half = _mm_cvtps_ph(_mm_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), Half);
+	}
+
+	if(i == count)
+		return;
+
+	float Tail[4] = {0};
+	unsigned short Result[8];
+	for(std::size_t j = 0; i + j < count; ++j)
+		Tail[j] = in[i + j];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(Result), _mm_cvtps_ph(_mm_loadu_ps(Tail), _MM_FROUND_TO_NEAREST_INT));
+	for(std::size_t j = 0; i + j < count; ++j)
+		out[i + j] = Result[j];
+}
+
+GLM_F16C_TARGET GLM_FUNC_QUALIFIER void f16c_half_to_float(unsigned short const * in, float * out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i Half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+		_mm256_storeu_ps(out + i, _mm256_cvtph_ps(Half));
+	}
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i Half = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(in + i));
+		_mm_storeu_ps(out + i, _mm_cvtph_ps(Half));
+	}
+
+	if(i == count)
+		return;
+
+	unsigned short Tail[8] = {0};
+	float Result[4];
+	for(std::size_t j = 0; i + j < count; ++j)
+		Tail[j] = in[i + j];
+	_mm_storeu_ps(Result, _mm_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(Tail))));
+	for(std::size_t j = 0; i + j < count; ++j)
+		out[i + j] = Result[j];
+}
+
+#endif//GLM_HAS_F16C_PATH
+
+}//namespace detail
+}//namespace glm
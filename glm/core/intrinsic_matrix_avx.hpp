@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref core
+/// @file glm/core/intrinsic_matrix_avx.hpp
+/// @date 2016-11-02 / 2016-11-02
+/// @author Roberto Cano
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef glm_detail_intrinsic_matrix_avx
+#define glm_detail_intrinsic_matrix_avx
+
+#include "setup.hpp"
+
+// AVX2/FMA code paths are selected at compile time through GLM_ARCH. Defining
+// GLM_FORCE_RUNTIME_DISPATCH builds them with per-function target attributes
+// instead, so a binary built for SSE2 picks them up only on CPUs that have them.
+#if(GLM_ARCH & GLM_ARCH_AVX2)
+#	define GLM_AVX2_TARGET
+#	define GLM_HAS_AVX2_PATH 1
+#	if(defined(__FMA__) || (GLM_COMPILER & GLM_COMPILER_VC))
+#		define GLM_HAS_FMA 1
+#	else
+#		define GLM_HAS_FMA 0
+#	endif
+#	define GLM_DISPATCH_AVX2 1
+#elif(defined(GLM_FORCE_RUNTIME_DISPATCH) && (GLM_ARCH & GLM_ARCH_SSE2) && (GLM_COMPILER & (GLM_COMPILER_GCC | GLM_COMPILER_CLANG)))
+#	include <immintrin.h>
+#	define GLM_AVX2_TARGET __attribute__((target("avx2,fma")))
+#	define GLM_HAS_AVX2_PATH 1
+#	define GLM_HAS_FMA 1
+#	define GLM_DISPATCH_AVX2 glm::detail::avx2_supported()
+#else
+#	define GLM_HAS_AVX2_PATH 0
+#	define GLM_DISPATCH_AVX2 0
+#endif
+
+#if(GLM_HAS_AVX2_PATH)
+
+#include "intrinsic_matrix.hpp"
+
+namespace glm{
+namespace detail
+{
+	// True when the running CPU supports both AVX2 and FMA
+	bool avx2_supported();
+
+	// One matrix: columns are stored in four __m128
+	GLM_AVX2_TARGET __m128 avx_mul_ps(__m128 const m[4], __m128 v);
+
+	GLM_AVX2_TARGET __m128 avx_mul_ps(__m128 v, __m128 const m[4]);
+
+	GLM_AVX2_TARGET void avx_mul_ps(__m128 const in1[4], __m128 const in2[4], __m128 out[4]);
+
+	GLM_AVX2_TARGET __m128 avx_det_ps(__m128 const m[4]);
+
+	GLM_AVX2_TARGET void avx_inverse_ps(__m128 const in[4], __m128 out[4]);
+
+	// Two matrices per register: the low lane of each __m256 holds a column
+	// of the first matrix, the high lane the same column of the second one
+	GLM_AVX2_TARGET __m256 avx_mul2_ps(__m256 const m[4], __m256 v);
+
+	GLM_AVX2_TARGET void avx_mul2_ps(__m256 const in1[4], __m256 const in2[4], __m256 out[4]);
+
+	GLM_AVX2_TARGET __m256 avx_det2_ps(__m256 const m[4]);
+
+	GLM_AVX2_TARGET void avx_inverse2_ps(__m256 const in[4], __m256 out[4]);
+
+	// Same as above for callers that can't hold __m256 values, i.e. code
+	// that is not itself compiled for AVX when using runtime dispatch
+	GLM_AVX2_TARGET void avx_mul2_ps(__m128 const m1[4], __m128 v1, __m128 const m2[4], __m128 v2, __m128 out[2]);
+
+	GLM_AVX2_TARGET void avx_mul2_ps(__m128 const a1[4], __m128 const b1[4], __m128 const a2[4], __m128 const b2[4], __m128 out1[4], __m128 out2[4]);
+
+	GLM_AVX2_TARGET __m128 avx_det2_ps(__m128 const m1[4], __m128 const m2[4]);
+
+	GLM_AVX2_TARGET void avx_inverse2_ps(__m128 const in1[4], __m128 const in2[4], __m128 out1[4], __m128 out2[4]);
+
+}//namespace detail
+}//namespace glm
+
+#include "intrinsic_matrix_avx.inl"
+
+#endif//GLM_HAS_AVX2_PATH
+#endif//glm_detail_intrinsic_matrix_avx
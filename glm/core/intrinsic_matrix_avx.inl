@@ -0,0 +1,511 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref core
+/// @file glm/core/intrinsic_matrix_avx.inl
+/// @date 2016-11-02 / 2016-11-02
+/// @author Roberto Cano
+///////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail{
+
+GLM_FUNC_QUALIFIER bool avx2_supported()
+{
+#	if(GLM_ARCH & GLM_ARCH_AVX2)
+		return true;
+#	else
+		static bool const Supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		return Supported;
+#	endif
+}
+
+// a * b + c, fused when FMA is available
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m128 avx_madd_ps(__m128 a, __m128 b, __m128 c)
+{
+#	if(GLM_HAS_FMA)
+		return _mm_fmadd_ps(a, b, c);
+#	else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#	endif
+}
+
+// a * b - c, fused when FMA is available
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m128 avx_msub_ps(__m128 a, __m128 b, __m128 c)
+{
+#	if(GLM_HAS_FMA)
+		return _mm_fmsub_ps(a, b, c);
+#	else
+		return _mm_sub_ps(_mm_mul_ps(a, b), c);
+#	endif
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_madd_ps(__m256 a, __m256 b, __m256 c)
+{
+#	if(GLM_HAS_FMA)
+		return _mm256_fmadd_ps(a, b, c);
+#	else
+		return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#	endif
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_msub_ps(__m256 a, __m256 b, __m256 c)
+{
+#	if(GLM_HAS_FMA)
+		return _mm256_fmsub_ps(a, b, c);
+#	else
+		return _mm256_sub_ps(_mm256_mul_ps(a, b), c);
+#	endif
+}
+
+// -(a * b) + c, fused when FMA is available
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_nmadd_ps(__m256 a, __m256 b, __m256 c)
+{
+#	if(GLM_HAS_FMA)
+		return _mm256_fnmadd_ps(a, b, c);
+#	else
+		return _mm256_sub_ps(c, _mm256_mul_ps(a, b));
+#	endif
+}
+
+// Builds a register holding a in the low lane and b in the high lane
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_pair_ps(__m128 a, __m128 b)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(a), b, 1);
+}
+
+// Dot product of each 128 bits lane, broadcast to the whole lane
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_dot2_ps(__m256 v1, __m256 v2)
+{
+	__m256 mul0 = _mm256_mul_ps(v1, v2);
+	__m256 add0 = _mm256_hadd_ps(mul0, mul0);
+	__m256 add1 = _mm256_hadd_ps(add0, add0);
+	return add1;
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m128 avx_mul_ps(__m128 const m[4], __m128 v)
+{
+	// Columns 0 and 1 are weighted by v.x and v.y, columns 2 and 3 by v.z and v.w
+	__m256 m01 = avx_pair_ps(m[0], m[1]);
+	__m256 m23 = avx_pair_ps(m[2], m[3]);
+	__m256 vv = avx_pair_ps(v, v);
+
+	__m256 v01 = _mm256_permutevar_ps(vv, _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1));
+	__m256 v23 = _mm256_permutevar_ps(vv, _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3));
+
+	__m256 mul0 = _mm256_mul_ps(m01, v01);
+	__m256 add0 = avx_madd_ps(m23, v23, mul0);
+
+	return _mm_add_ps(_mm256_castps256_ps128(add0), _mm256_extractf128_ps(add0, 1));
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m128 avx_mul_ps(__m128 v, __m128 const m[4])
+{
+	__m256 vv = avx_pair_ps(v, v);
+	__m256 mul0 = _mm256_mul_ps(avx_pair_ps(m[0], m[1]), vv);
+	__m256 mul1 = _mm256_mul_ps(avx_pair_ps(m[2], m[3]), vv);
+
+	// Low lane: d0, d2, d0, d2 - High lane: d1, d3, d1, d3
+	__m256 add0 = _mm256_hadd_ps(mul0, mul1);
+	__m256 add1 = _mm256_hadd_ps(add0, add0);
+
+	return _mm_unpacklo_ps(_mm256_castps256_ps128(add1), _mm256_extractf128_ps(add1, 1));
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_mul_ps(__m128 const in1[4], __m128 const in2[4], __m128 out[4])
+{
+	// Load everything first, out may alias any of the inputs
+	__m256 a0 = _mm256_broadcast_ps(&in1[0]);
+	__m256 a1 = _mm256_broadcast_ps(&in1[1]);
+	__m256 a2 = _mm256_broadcast_ps(&in1[2]);
+	__m256 a3 = _mm256_broadcast_ps(&in1[3]);
+
+	__m256 b01 = avx_pair_ps(in2[0], in2[1]);
+	__m256 b23 = avx_pair_ps(in2[2], in2[3]);
+
+	{
+		__m256 e0 = _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0));
+		__m256 e1 = _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1));
+		__m256 e2 = _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2));
+		__m256 e3 = _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m256 r0 = _mm256_mul_ps(a0, e0);
+		__m256 r1 = _mm256_mul_ps(a1, e1);
+		r0 = avx_madd_ps(a2, e2, r0);
+		r1 = avx_madd_ps(a3, e3, r1);
+		b01 = _mm256_add_ps(r0, r1);
+	}
+	{
+		__m256 e0 = _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0));
+		__m256 e1 = _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1));
+		__m256 e2 = _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2));
+		__m256 e3 = _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m256 r0 = _mm256_mul_ps(a0, e0);
+		__m256 r1 = _mm256_mul_ps(a1, e1);
+		r0 = avx_madd_ps(a2, e2, r0);
+		r1 = avx_madd_ps(a3, e3, r1);
+		b23 = _mm256_add_ps(r0, r1);
+	}
+
+	out[0] = _mm256_castps256_ps128(b01);
+	out[1] = _mm256_extractf128_ps(b01, 1);
+	out[2] = _mm256_castps256_ps128(b23);
+	out[3] = _mm256_extractf128_ps(b23, 1);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m128 avx_det_ps(__m128 const m[4])
+{
+	// Same factorization as sse_det_ps with the multiply-add pairs fused
+
+	// First 2 columns
+	__m128 Swp2A = _mm_shuffle_ps(m[2], m[2], _MM_SHUFFLE(0, 1, 1, 2));
+	__m128 Swp3A = _mm_shuffle_ps(m[3], m[3], _MM_SHUFFLE(3, 2, 3, 3));
+
+	// Second 2 columns
+	__m128 Swp2B = _mm_shuffle_ps(m[2], m[2], _MM_SHUFFLE(3, 2, 3, 3));
+	__m128 Swp3B = _mm_shuffle_ps(m[3], m[3], _MM_SHUFFLE(0, 1, 1, 2));
+	__m128 MulB = _mm_mul_ps(Swp2B, Swp3B);
+
+	// Columns subtraction
+	__m128 SubE = avx_msub_ps(Swp2A, Swp3A, MulB);
+
+	// Last 2 rows
+	__m128 Swp2C = _mm_shuffle_ps(m[2], m[2], _MM_SHUFFLE(0, 0, 1, 2));
+	__m128 Swp3C = _mm_shuffle_ps(m[3], m[3], _MM_SHUFFLE(1, 2, 0, 0));
+	__m128 MulC = _mm_mul_ps(Swp2C, Swp3C);
+	__m128 SubF = _mm_sub_ps(_mm_movehl_ps(MulC, MulC), MulC);
+
+	__m128 SubFacA = _mm_shuffle_ps(SubE, SubE, _MM_SHUFFLE(2, 1, 0, 0));
+	__m128 SwpFacA = _mm_shuffle_ps(m[1], m[1], _MM_SHUFFLE(0, 0, 0, 1));
+
+	__m128 SubTmpB = _mm_shuffle_ps(SubE, SubF, _MM_SHUFFLE(0, 0, 3, 1));
+	__m128 SubFacB = _mm_shuffle_ps(SubTmpB, SubTmpB, _MM_SHUFFLE(3, 1, 1, 0));
+	__m128 SwpFacB = _mm_shuffle_ps(m[1], m[1], _MM_SHUFFLE(1, 1, 2, 2));
+	__m128 MulFacB = _mm_mul_ps(SwpFacB, SubFacB);
+
+	__m128 SubRes = avx_msub_ps(SwpFacA, SubFacA, MulFacB);
+
+	__m128 SubTmpC = _mm_shuffle_ps(SubE, SubF, _MM_SHUFFLE(1, 0, 2, 2));
+	__m128 SubFacC = _mm_shuffle_ps(SubTmpC, SubTmpC, _MM_SHUFFLE(3, 3, 2, 0));
+	__m128 SwpFacC = _mm_shuffle_ps(m[1], m[1], _MM_SHUFFLE(2, 3, 3, 3));
+
+	__m128 AddRes = avx_madd_ps(SwpFacC, SubFacC, SubRes);
+	__m128 DetCof = _mm_mul_ps(AddRes, _mm_setr_ps( 1.0f,-1.0f, 1.0f,-1.0f));
+
+	return sse_dot_ps(m[0], DetCof);
+}
+
+// Computes two of the sub-factors of sse_inverse_ps at once, FacA in the low
+// lane and FacB in the high lane. Each one is defined by the components a and
+// b of the columns it reads:
+//	Fac[0] = m[2][a] * m[3][b] - m[3][a] * m[2][b]
+//	Fac[1] = m[2][a] * m[3][b] - m[3][a] * m[2][b]
+//	Fac[2] = m[1][a] * m[3][b] - m[3][a] * m[1][b]
+//	Fac[3] = m[1][a] * m[2][b] - m[2][a] * m[1][b]
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_inverse_factors_ps
+(
+	__m256 const & col1,
+	__m256 const & col2,
+	__m256 const & col3,
+	__m256i const & a,
+	__m256i const & b
+)
+{
+	__m256 A1 = _mm256_permutevar_ps(col1, a);
+	__m256 A2 = _mm256_permutevar_ps(col2, a);
+	__m256 A3 = _mm256_permutevar_ps(col3, a);
+	__m256 B1 = _mm256_permutevar_ps(col1, b);
+	__m256 B2 = _mm256_permutevar_ps(col2, b);
+	__m256 B3 = _mm256_permutevar_ps(col3, b);
+
+	__m256 Swp00 = _mm256_blend_ps(A2, A1, 0xCC);
+	__m256 Swp01 = _mm256_blend_ps(B3, B2, 0x88);
+	__m256 Swp02 = _mm256_blend_ps(A3, A2, 0x88);
+	__m256 Swp03 = _mm256_blend_ps(B2, B1, 0xCC);
+
+	return avx_msub_ps(Swp00, Swp01, _mm256_mul_ps(Swp02, Swp03));
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_inverse_ps(__m128 const in[4], __m128 out[4])
+{
+	__m256 Col1 = _mm256_broadcast_ps(&in[1]);
+	__m256 Col2 = _mm256_broadcast_ps(&in[2]);
+	__m256 Col3 = _mm256_broadcast_ps(&in[3]);
+
+	// Same sub-factors as sse_inverse_ps, two per register
+	__m256 Fac01 = avx_inverse_factors_ps(Col1, Col2, Col3,
+		_mm256_setr_epi32(2, 2, 2, 2, 1, 1, 1, 1),
+		_mm256_setr_epi32(3, 3, 3, 3, 3, 3, 3, 3));
+	__m256 Fac23 = avx_inverse_factors_ps(Col1, Col2, Col3,
+		_mm256_setr_epi32(1, 1, 1, 1, 0, 0, 0, 0),
+		_mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3));
+	__m256 Fac45 = avx_inverse_factors_ps(Col1, Col2, Col3,
+		_mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, 0),
+		_mm256_setr_epi32(2, 2, 2, 2, 1, 1, 1, 1));
+
+	// Vec[i] = (m[1][i], m[0][i], m[0][i], m[0][i])
+	__m128 Temp0 = _mm_shuffle_ps(in[1], in[0], _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 Vec0 = _mm_shuffle_ps(Temp0, Temp0, _MM_SHUFFLE(2, 2, 2, 0));
+	__m128 Temp1 = _mm_shuffle_ps(in[1], in[0], _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 Vec1 = _mm_shuffle_ps(Temp1, Temp1, _MM_SHUFFLE(2, 2, 2, 0));
+	__m128 Temp2 = _mm_shuffle_ps(in[1], in[0], _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 Vec2 = _mm_shuffle_ps(Temp2, Temp2, _MM_SHUFFLE(2, 2, 2, 0));
+	__m128 Temp3 = _mm_shuffle_ps(in[1], in[0], _MM_SHUFFLE(3, 3, 3, 3));
+	__m128 Vec3 = _mm_shuffle_ps(Temp3, Temp3, _MM_SHUFFLE(2, 2, 2, 0));
+
+	// SignB in the low lane, SignA in the high lane
+	__m256 Sign = _mm256_setr_ps(1.0f,-1.0f, 1.0f,-1.0f,-1.0f, 1.0f,-1.0f, 1.0f);
+
+	// col0 = SignB * (Vec1 * Fac0 - Vec2 * Fac1 + Vec3 * Fac2)
+	// col1 = SignA * (Vec0 * Fac0 - Vec2 * Fac3 + Vec3 * Fac4)
+	__m256 Inv01;
+	{
+		__m256 FacA = _mm256_permute2f128_ps(Fac01, Fac01, 0x00);
+		__m256 FacB = _mm256_permute2f128_ps(Fac01, Fac23, 0x31);
+		__m256 FacC = _mm256_permute2f128_ps(Fac23, Fac45, 0x20);
+
+		__m256 Mul0 = _mm256_mul_ps(avx_pair_ps(Vec1, Vec0), FacA);
+		__m256 Sub0 = avx_nmadd_ps(avx_pair_ps(Vec2, Vec2), FacB, Mul0);
+		__m256 Add0 = avx_madd_ps(avx_pair_ps(Vec3, Vec3), FacC, Sub0);
+		Inv01 = _mm256_mul_ps(Sign, Add0);
+	}
+
+	// col2 = SignB * (Vec0 * Fac1 - Vec1 * Fac3 + Vec3 * Fac5)
+	// col3 = SignA * (Vec0 * Fac2 - Vec1 * Fac4 + Vec2 * Fac5)
+	__m256 Inv23;
+	{
+		__m256 FacA = _mm256_permute2f128_ps(Fac01, Fac23, 0x21);
+		__m256 FacB = _mm256_permute2f128_ps(Fac23, Fac45, 0x21);
+		__m256 FacC = _mm256_permute2f128_ps(Fac45, Fac45, 0x11);
+
+		__m256 Mul0 = _mm256_mul_ps(avx_pair_ps(Vec0, Vec0), FacA);
+		__m256 Sub0 = avx_nmadd_ps(avx_pair_ps(Vec1, Vec1), FacB, Mul0);
+		__m256 Add0 = avx_madd_ps(avx_pair_ps(Vec3, Vec2), FacC, Sub0);
+		Inv23 = _mm256_mul_ps(Sign, Add0);
+	}
+
+	__m128 Inv0 = _mm256_castps256_ps128(Inv01);
+	__m128 Inv1 = _mm256_extractf128_ps(Inv01, 1);
+	__m128 Inv2 = _mm256_castps256_ps128(Inv23);
+	__m128 Inv3 = _mm256_extractf128_ps(Inv23, 1);
+
+	__m128 Row0 = _mm_shuffle_ps(Inv0, Inv1, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 Row1 = _mm_shuffle_ps(Inv2, Inv3, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 Row2 = _mm_shuffle_ps(Row0, Row1, _MM_SHUFFLE(2, 0, 2, 0));
+
+	__m128 Det0 = sse_dot_ps(in[0], Row2);
+	__m256 Rcp0 = _mm256_div_ps(_mm256_set1_ps(1.0f), avx_pair_ps(Det0, Det0));
+
+	Inv01 = _mm256_mul_ps(Inv01, Rcp0);
+	Inv23 = _mm256_mul_ps(Inv23, Rcp0);
+
+	out[0] = _mm256_castps256_ps128(Inv01);
+	out[1] = _mm256_extractf128_ps(Inv01, 1);
+	out[2] = _mm256_castps256_ps128(Inv23);
+	out[3] = _mm256_extractf128_ps(Inv23, 1);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_mul2_ps(__m256 const m[4], __m256 v)
+{
+	__m256 v0 = _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0));
+	__m256 v1 = _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1));
+	__m256 v2 = _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2));
+	__m256 v3 = _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3));
+
+	__m256 m0 = _mm256_mul_ps(m[0], v0);
+	__m256 m1 = _mm256_mul_ps(m[1], v1);
+	m0 = avx_madd_ps(m[2], v2, m0);
+	m1 = avx_madd_ps(m[3], v3, m1);
+
+	return _mm256_add_ps(m0, m1);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_mul2_ps(__m256 const in1[4], __m256 const in2[4], __m256 out[4])
+{
+	__m256 r0 = avx_mul2_ps(in1, in2[0]);
+	__m256 r1 = avx_mul2_ps(in1, in2[1]);
+	__m256 r2 = avx_mul2_ps(in1, in2[2]);
+	__m256 r3 = avx_mul2_ps(in1, in2[3]);
+
+	out[0] = r0;
+	out[1] = r1;
+	out[2] = r2;
+	out[3] = r3;
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_det2_ps(__m256 const m[4])
+{
+	// sse_det_ps on each lane
+	__m256 Swp2A = _mm256_shuffle_ps(m[2], m[2], _MM_SHUFFLE(0, 1, 1, 2));
+	__m256 Swp3A = _mm256_shuffle_ps(m[3], m[3], _MM_SHUFFLE(3, 2, 3, 3));
+
+	__m256 Swp2B = _mm256_shuffle_ps(m[2], m[2], _MM_SHUFFLE(3, 2, 3, 3));
+	__m256 Swp3B = _mm256_shuffle_ps(m[3], m[3], _MM_SHUFFLE(0, 1, 1, 2));
+	__m256 MulB = _mm256_mul_ps(Swp2B, Swp3B);
+
+	__m256 SubE = avx_msub_ps(Swp2A, Swp3A, MulB);
+
+	__m256 Swp2C = _mm256_shuffle_ps(m[2], m[2], _MM_SHUFFLE(0, 0, 1, 2));
+	__m256 Swp3C = _mm256_shuffle_ps(m[3], m[3], _MM_SHUFFLE(1, 2, 0, 0));
+	__m256 MulC = _mm256_mul_ps(Swp2C, Swp3C);
+	__m256 SubF = _mm256_sub_ps(_mm256_shuffle_ps(MulC, MulC, _MM_SHUFFLE(3, 2, 3, 2)), MulC);
+
+	__m256 SubFacA = _mm256_shuffle_ps(SubE, SubE, _MM_SHUFFLE(2, 1, 0, 0));
+	__m256 SwpFacA = _mm256_shuffle_ps(m[1], m[1], _MM_SHUFFLE(0, 0, 0, 1));
+
+	__m256 SubTmpB = _mm256_shuffle_ps(SubE, SubF, _MM_SHUFFLE(0, 0, 3, 1));
+	__m256 SubFacB = _mm256_shuffle_ps(SubTmpB, SubTmpB, _MM_SHUFFLE(3, 1, 1, 0));
+	__m256 SwpFacB = _mm256_shuffle_ps(m[1], m[1], _MM_SHUFFLE(1, 1, 2, 2));
+	__m256 MulFacB = _mm256_mul_ps(SwpFacB, SubFacB);
+
+	__m256 SubRes = avx_msub_ps(SwpFacA, SubFacA, MulFacB);
+
+	__m256 SubTmpC = _mm256_shuffle_ps(SubE, SubF, _MM_SHUFFLE(1, 0, 2, 2));
+	__m256 SubFacC = _mm256_shuffle_ps(SubTmpC, SubTmpC, _MM_SHUFFLE(3, 3, 2, 0));
+	__m256 SwpFacC = _mm256_shuffle_ps(m[1], m[1], _MM_SHUFFLE(2, 3, 3, 3));
+
+	__m256 AddRes = avx_madd_ps(SwpFacC, SubFacC, SubRes);
+	__m256 DetCof = _mm256_mul_ps(AddRes, _mm256_setr_ps(1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f));
+
+	return avx_dot2_ps(m[0], DetCof);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m256 avx_inverse2_factor_ps
+(
+	__m256 const in[4],
+	int const a,
+	int const b
+)
+{
+	// Same layout as the Fac blocks of sse_inverse_ps, with the component
+	// indices passed in through variable permutes
+	__m256i A = _mm256_set1_epi32(a);
+	__m256i B = _mm256_set1_epi32(b);
+
+	__m256 Swp00 = _mm256_blend_ps(_mm256_permutevar_ps(in[2], A), _mm256_permutevar_ps(in[1], A), 0xCC);
+	__m256 Swp01 = _mm256_blend_ps(_mm256_permutevar_ps(in[3], B), _mm256_permutevar_ps(in[2], B), 0x88);
+	__m256 Swp02 = _mm256_blend_ps(_mm256_permutevar_ps(in[3], A), _mm256_permutevar_ps(in[2], A), 0x88);
+	__m256 Swp03 = _mm256_blend_ps(_mm256_permutevar_ps(in[2], B), _mm256_permutevar_ps(in[1], B), 0xCC);
+
+	return avx_msub_ps(Swp00, Swp01, _mm256_mul_ps(Swp02, Swp03));
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_inverse2_ps(__m256 const in[4], __m256 out[4])
+{
+	__m256 Fac0 = avx_inverse2_factor_ps(in, 2, 3);
+	__m256 Fac1 = avx_inverse2_factor_ps(in, 1, 3);
+	__m256 Fac2 = avx_inverse2_factor_ps(in, 1, 2);
+	__m256 Fac3 = avx_inverse2_factor_ps(in, 0, 3);
+	__m256 Fac4 = avx_inverse2_factor_ps(in, 0, 2);
+	__m256 Fac5 = avx_inverse2_factor_ps(in, 0, 1);
+
+	__m256 SignA = _mm256_setr_ps(-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f);
+	__m256 SignB = _mm256_setr_ps( 1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f);
+
+	__m256 Temp0 = _mm256_shuffle_ps(in[1], in[0], _MM_SHUFFLE(0, 0, 0, 0));
+	__m256 Vec0 = _mm256_shuffle_ps(Temp0, Temp0, _MM_SHUFFLE(2, 2, 2, 0));
+	__m256 Temp1 = _mm256_shuffle_ps(in[1], in[0], _MM_SHUFFLE(1, 1, 1, 1));
+	__m256 Vec1 = _mm256_shuffle_ps(Temp1, Temp1, _MM_SHUFFLE(2, 2, 2, 0));
+	__m256 Temp2 = _mm256_shuffle_ps(in[1], in[0], _MM_SHUFFLE(2, 2, 2, 2));
+	__m256 Vec2 = _mm256_shuffle_ps(Temp2, Temp2, _MM_SHUFFLE(2, 2, 2, 0));
+	__m256 Temp3 = _mm256_shuffle_ps(in[1], in[0], _MM_SHUFFLE(3, 3, 3, 3));
+	__m256 Vec3 = _mm256_shuffle_ps(Temp3, Temp3, _MM_SHUFFLE(2, 2, 2, 0));
+
+	__m256 Inv0 = _mm256_mul_ps(SignB, avx_madd_ps(Vec3, Fac2, avx_nmadd_ps(Vec2, Fac1, _mm256_mul_ps(Vec1, Fac0))));
+	__m256 Inv1 = _mm256_mul_ps(SignA, avx_madd_ps(Vec3, Fac4, avx_nmadd_ps(Vec2, Fac3, _mm256_mul_ps(Vec0, Fac0))));
+	__m256 Inv2 = _mm256_mul_ps(SignB, avx_madd_ps(Vec3, Fac5, avx_nmadd_ps(Vec1, Fac3, _mm256_mul_ps(Vec0, Fac1))));
+	__m256 Inv3 = _mm256_mul_ps(SignA, avx_madd_ps(Vec2, Fac5, avx_nmadd_ps(Vec1, Fac4, _mm256_mul_ps(Vec0, Fac2))));
+
+	__m256 Row0 = _mm256_shuffle_ps(Inv0, Inv1, _MM_SHUFFLE(0, 0, 0, 0));
+	__m256 Row1 = _mm256_shuffle_ps(Inv2, Inv3, _MM_SHUFFLE(0, 0, 0, 0));
+	__m256 Row2 = _mm256_shuffle_ps(Row0, Row1, _MM_SHUFFLE(2, 0, 2, 0));
+
+	__m256 Det0 = avx_dot2_ps(in[0], Row2);
+	__m256 Rcp0 = _mm256_div_ps(_mm256_set1_ps(1.0f), Det0);
+
+	out[0] = _mm256_mul_ps(Inv0, Rcp0);
+	out[1] = _mm256_mul_ps(Inv1, Rcp0);
+	out[2] = _mm256_mul_ps(Inv2, Rcp0);
+	out[3] = _mm256_mul_ps(Inv3, Rcp0);
+}
+
+// Packs the columns of two matrices, in1 in the low lanes and in2 in the high lanes
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_pack2_ps(__m128 const in1[4], __m128 const in2[4], __m256 out[4])
+{
+	out[0] = avx_pair_ps(in1[0], in2[0]);
+	out[1] = avx_pair_ps(in1[1], in2[1]);
+	out[2] = avx_pair_ps(in1[2], in2[2]);
+	out[3] = avx_pair_ps(in1[3], in2[3]);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_unpack2_ps(__m256 const in[4], __m128 out1[4], __m128 out2[4])
+{
+	out1[0] = _mm256_castps256_ps128(in[0]);
+	out1[1] = _mm256_castps256_ps128(in[1]);
+	out1[2] = _mm256_castps256_ps128(in[2]);
+	out1[3] = _mm256_castps256_ps128(in[3]);
+	out2[0] = _mm256_extractf128_ps(in[0], 1);
+	out2[1] = _mm256_extractf128_ps(in[1], 1);
+	out2[2] = _mm256_extractf128_ps(in[2], 1);
+	out2[3] = _mm256_extractf128_ps(in[3], 1);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_mul2_ps(__m128 const m1[4], __m128 v1, __m128 const m2[4], __m128 v2, __m128 out[2])
+{
+	__m256 m[4];
+	avx_pack2_ps(m1, m2, m);
+
+	__m256 r = avx_mul2_ps(m, avx_pair_ps(v1, v2));
+	out[0] = _mm256_castps256_ps128(r);
+	out[1] = _mm256_extractf128_ps(r, 1);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_mul2_ps(__m128 const a1[4], __m128 const b1[4], __m128 const a2[4], __m128 const b2[4], __m128 out1[4], __m128 out2[4])
+{
+	__m256 a[4], b[4], r[4];
+	avx_pack2_ps(a1, a2, a);
+	avx_pack2_ps(b1, b2, b);
+	avx_mul2_ps(a, b, r);
+	avx_unpack2_ps(r, out1, out2);
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER __m128 avx_det2_ps(__m128 const m1[4], __m128 const m2[4])
+{
+	__m256 m[4];
+	avx_pack2_ps(m1, m2, m);
+
+	// det(m1) in x, det(m2) in y
+	__m256 Det = avx_det2_ps(m);
+	return _mm_unpacklo_ps(_mm256_castps256_ps128(Det), _mm256_extractf128_ps(Det, 1));
+}
+
+GLM_AVX2_TARGET GLM_FUNC_QUALIFIER void avx_inverse2_ps(__m128 const in1[4], __m128 const in2[4], __m128 out1[4], __m128 out2[4])
+{
+	__m256 m[4], r[4];
+	avx_pack2_ps(in1, in2, m);
+	avx_inverse2_ps(m, r);
+	avx_unpack2_ps(r, out1, out2);
+}
+
+}//namespace detail
+}//namespace glm
@@ -330,6 +330,8 @@
 #		define GLM_COMPILER (GLM_COMPILER_GCC49)
 #	elif (__GNUC__ == 5) && (__GNUC_MINOR__ == 0)
 #		define GLM_COMPILER (GLM_COMPILER_GCC50)
+#	elif (__GNUC__ >= 5)
+#		define GLM_COMPILER (GLM_COMPILER_GCC50)
 #	else
 #		define GLM_COMPILER (GLM_COMPILER_GCC)
 #	endif
@@ -474,7 +476,7 @@
 /////////////////
 // Platform 
 
-// User defines: GLM_FORCE_PURE GLM_FORCE_SSE2 GLM_FORCE_AVX
+// User defines: GLM_FORCE_PURE GLM_FORCE_SSE2 GLM_FORCE_AVX GLM_FORCE_AVX2 GLM_FORCE_RUNTIME_DISPATCH
 
 #define GLM_ARCH_PURE		0x0000
 #define GLM_ARCH_SSE2		0x0001
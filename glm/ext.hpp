@@ -80,7 +80,9 @@
 #include "./gtc/ulp.hpp"
 
 #include "./gtx/associated_min_max.hpp"
+#include "./gtx/batch_packing.hpp"
 #include "./gtx/bit.hpp"
+#include "./gtx/bvh.hpp"
 #include "./gtx/closest_point.hpp"
 #include "./gtx/color_cast.hpp"
 #include "./gtx/color_space.hpp"
@@ -107,6 +109,7 @@
 #include "./gtx/matrix_query.hpp"
 #include "./gtx/mixed_product.hpp"
 #include "./gtx/multiple.hpp"
+#include "./gtx/noise_batch.hpp"
 #include "./gtx/norm.hpp"
 #include "./gtx/normal.hpp"
 #include "./gtx/normalize_dot.hpp"
@@ -126,6 +129,7 @@
 #include "./gtx/transform.hpp"
 #include "./gtx/transform2.hpp"
 #include "./gtx/vec1.hpp"
+#include "./gtx/vec_soa.hpp"
 #include "./gtx/vector_access.hpp"
 #include "./gtx/vector_angle.hpp"
 #include "./gtx/vector_query.hpp"
@@ -39,6 +39,7 @@
 
 // Dependency:
 #include "../glm.hpp"
+#include "../core/intrinsic_half.hpp"
 
 #if(defined(GLM_MESSAGES) && !defined(glm_ext))
 #	pragma message("GLM: GLM_GTC_half_float extension included")
@@ -432,6 +433,16 @@ namespace detail
 	/// @see gtc_half_float
 	hvec4 abs(hvec4 const & x);
 
+	/// Converts count single-precision values to half precision.
+	/// Uses F16C when available and SSE2 otherwise, both rounding to nearest even.
+	/// @see gtc_half_float
+	void packHalf(float const * in, half * out, std::size_t count);
+
+	/// Converts count half-precision values to single precision.
+	/// Uses F16C when available and SSE2 otherwise.
+	/// @see gtc_half_float
+	void unpackHalf(half const * in, float * out, std::size_t count);
+
 	/// @}
 }// namespace glm
 
@@ -1036,4 +1036,34 @@ namespace detail
 			float(v.w) >= float(0) ? v.w : -v.w);
 	}
 
+	GLM_FUNC_QUALIFIER void packHalf(float const * in, half * out, std::size_t count)
+	{
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			unsigned short * Out = reinterpret_cast<unsigned short *>(out);
+#			if(GLM_HAS_F16C_PATH)
+				if(GLM_DISPATCH_F16C)
+					return detail::f16c_float_to_half(in, Out, count);
+#			endif
+			detail::sse_float_to_half(in, Out, count);
+#		else
+			for(std::size_t i = 0; i < count; ++i)
+				out[i] = half(in[i]);
+#		endif
+	}
+
+	GLM_FUNC_QUALIFIER void unpackHalf(half const * in, float * out, std::size_t count)
+	{
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			unsigned short const * In = reinterpret_cast<unsigned short const *>(in);
+#			if(GLM_HAS_F16C_PATH)
+				if(GLM_DISPATCH_F16C)
+					return detail::f16c_half_to_float(In, out, count);
+#			endif
+			detail::sse_half_to_float(In, out, count);
+#		else
+			for(std::size_t i = 0; i < count; ++i)
+				out[i] = float(in[i]);
+#		endif
+	}
+
 }//namespace glm
@@ -105,6 +105,81 @@ namespace glm
 	template <typename T>
 	GLM_FUNC_QUALIFIER detail::tvec3<T> ballRand(
 		T const & Radius);
+
+	/// Seed the generator of the calling thread. Every thread has its own
+	/// generator, seeded with 0 until this is called, so a given seed always
+	/// gives the same sequence whatever the other threads do.
+	/// 
+	/// @param Seed
+	/// @see gtc_random
+	void seedRand(
+		detail::uint64 const & Seed);
+
+	/// Fill out with count random numbers in the interval [Min, Max), according a linear distribution.
+	/// Values are generated 4 at a time with SSE2.
+	/// 
+	/// @param Min 
+	/// @param Max 
+	/// @tparam T Value type. Currently supported: float or double scalars.
+	/// @see gtc_random
+	template <typename T> 
+	void linearRand(
+		T const & Min, 
+		T const & Max, 
+		T * out, 
+		std::size_t count);
+
+	/// Fill out with count random numbers according a gaussian distribution.
+	/// 
+	/// @param Mean
+	/// @param Deviation
+	/// @see gtc_random
+	template <typename T> 
+	void gaussRand(
+		T const & Mean, 
+		T const & Deviation, 
+		T * out, 
+		std::size_t count);
+
+	/// Fill out with count 2D vectors regulary distributed on a circle of a given radius.
+	/// 
+	/// @param Radius 
+	/// @see gtc_random
+	template <typename T> 
+	void circularRand(
+		T const & Radius, 
+		detail::tvec2<T> * out, 
+		std::size_t count);
+
+	/// Fill out with count 3D vectors regulary distributed on a sphere of a given radius.
+	/// 
+	/// @param Radius 
+	/// @see gtc_random
+	template <typename T> 
+	void sphericalRand(
+		T const & Radius, 
+		detail::tvec3<T> * out, 
+		std::size_t count);
+
+	/// Fill out with count 2D vectors regulary distributed within the area of a disk of a given radius.
+	/// 
+	/// @param Radius 
+	/// @see gtc_random
+	template <typename T> 
+	void diskRand(
+		T const & Radius, 
+		detail::tvec2<T> * out, 
+		std::size_t count);
+
+	/// Fill out with count 3D vectors regulary distributed within the volume of a ball of a given radius.
+	/// 
+	/// @param Radius 
+	/// @see gtc_random
+	template <typename T> 
+	void ballRand(
+		T const & Radius, 
+		detail::tvec3<T> * out, 
+		std::size_t count);
 	
 	/// @}
 }//namespace glm
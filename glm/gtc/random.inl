@@ -29,9 +29,165 @@
 #include <ctime>
 #include <cassert>
 
+#if(__cplusplus >= 201103L)
+#	define GLM_RAND_THREAD_LOCAL thread_local
+#elif(GLM_COMPILER & GLM_COMPILER_VC)
+#	define GLM_RAND_THREAD_LOCAL __declspec(thread)
+#else
+#	define GLM_RAND_THREAD_LOCAL __thread
+#endif
+
 namespace glm{
 namespace detail
 {
+	//////////////////////////////////////
+	// Generator
+
+	// xoshiro128+. Only the high bits are used, to build floating point
+	// values, so the weaker low bits of the + scrambler don't matter and a
+	// step only needs SSE2 integer instructions.
+	struct rand_state
+	{
+		uint32 Seeded;
+		uint32 Scalar[4];		// Generator of the single value functions
+		uint32 Lanes[4][4];		// Four generators, one per lane, for the batch functions: [word][lane]
+	};
+
+	GLM_FUNC_QUALIFIER uint64 rand_splitmix64(uint64 & x)
+	{
+		uint64 z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	GLM_FUNC_QUALIFIER void rand_seed(rand_state & State, uint64 Seed)
+	{
+		for(int w = 0; w < 4; w += 2)
+		{
+			uint64 z = rand_splitmix64(Seed);
+			State.Scalar[w + 0] = uint32(z);
+			State.Scalar[w + 1] = uint32(z >> 32);
+		}
+		for(int w = 0; w < 4; ++w)
+		for(int l = 0; l < 4; l += 2)
+		{
+			uint64 z = rand_splitmix64(Seed);
+			State.Lanes[w][l + 0] = uint32(z);
+			State.Lanes[w][l + 1] = uint32(z >> 32);
+		}
+		State.Seeded = 1;
+	}
+
+	// Each thread owns its generator, so threads never contend for it and
+	// a seeded thread gets the same sequence on every run
+	GLM_FUNC_QUALIFIER rand_state & rand_thread_state()
+	{
+		static GLM_RAND_THREAD_LOCAL rand_state State;
+		if(!State.Seeded)
+			rand_seed(State, 0);
+		return State;
+	}
+
+	GLM_FUNC_QUALIFIER uint32 rand_step(uint32 & s0, uint32 & s1, uint32 & s2, uint32 & s3)
+	{
+		uint32 const Result = s0 + s3;
+		uint32 const t = s1 << 9;
+		s2 ^= s0;
+		s3 ^= s1;
+		s1 ^= s2;
+		s0 ^= s3;
+		s2 ^= t;
+		s3 = (s3 << 11) | (s3 >> 21);
+		return Result;
+	}
+
+	GLM_FUNC_QUALIFIER uint32 rand_uint32()
+	{
+		uint32 * s = rand_thread_state().Scalar;
+		return rand_step(s[0], s[1], s[2], s[3]);
+	}
+
+	// [0, 1) from the 24 high bits
+	GLM_FUNC_QUALIFIER float rand_unit(uint32 x)
+	{
+		return float(x >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// [0, 1) from the 53 high bits of two values
+	GLM_FUNC_QUALIFIER double rand_unit(uint32 a, uint32 b)
+	{
+		return (double(a >> 5) * 67108864.0 + double(b >> 6)) * (1.0 / 9007199254740992.0);
+	}
+
+	// Fills out with count values, four per step, one from each lane. The
+	// scalar loop produces the same sequence as the SSE2 one.
+	GLM_FUNC_QUALIFIER void rand_fill(uint32 * out, std::size_t count, float * unit)
+	{
+		uint32 (&Lanes)[4][4] = rand_thread_state().Lanes;
+
+		std::size_t i = 0;
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			__m128i s0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lanes[0]));
+			__m128i s1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lanes[1]));
+			__m128i s2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lanes[2]));
+			__m128i s3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lanes[3]));
+			__m128 const Scale = _mm_set1_ps(1.0f / 16777216.0f);
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128i const Result = _mm_add_epi32(s0, s3);
+				__m128i const t = _mm_slli_epi32(s1, 9);
+				s2 = _mm_xor_si128(s2, s0);
+				s3 = _mm_xor_si128(s3, s1);
+				s1 = _mm_xor_si128(s1, s2);
+				s0 = _mm_xor_si128(s0, s3);
+				s2 = _mm_xor_si128(s2, t);
+				s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+				if(unit)
+					_mm_storeu_ps(unit + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(Result, 8)), Scale));
+				else
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), Result);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes[0]), s0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes[1]), s1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes[2]), s2);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes[3]), s3);
+#		endif
+
+		// Whole steps for the tail too, the unused values are dropped
+		for(; i < count; i += 4)
+		for(std::size_t l = 0; l < 4; ++l)
+		{
+			uint32 Result = rand_step(Lanes[0][l], Lanes[1][l], Lanes[2][l], Lanes[3][l]);
+			if(i + l >= count)
+				continue;
+			if(unit)
+				unit[i + l] = rand_unit(Result);
+			else
+				out[i + l] = Result;
+		}
+	}
+
+	GLM_FUNC_QUALIFIER void rand_fill_unit(float * out, std::size_t count)
+	{
+		rand_fill(0, count, out);
+	}
+
+	GLM_FUNC_QUALIFIER void rand_fill_unit(double * out, std::size_t count)
+	{
+		uint32 Bits[256];
+		for(std::size_t i = 0; i < count; i += 128)
+		{
+			std::size_t const Size = count - i < 128 ? count - i : 128;
+			rand_fill(Bits, Size * 2, 0);
+			for(std::size_t j = 0; j < Size; ++j)
+				out[i + j] = rand_unit(Bits[j * 2 + 0], Bits[j * 2 + 1]);
+		}
+	}
+
+	//////////////////////////////////////
+	// Distributions
+
 	struct compute_linearRand
 	{
 		template <typename T>
@@ -47,25 +203,25 @@ namespace detail
 	template <>
 	GLM_FUNC_QUALIFIER half compute_linearRand::operator()<half> (half const & Min, half const & Max) const
 	{
-		return half(float(std::rand()) / float(RAND_MAX) * (float(Max) - float(Min)) + float(Min));
+		return half(rand_unit(rand_uint32()) * (float(Max) - float(Min)) + float(Min));
 	}
 
 	template <>
 	GLM_FUNC_QUALIFIER float compute_linearRand::operator()<float> (float const & Min, float const & Max) const
 	{
-		return float(std::rand()) / float(RAND_MAX) * (Max - Min) + Min;
+		return rand_unit(rand_uint32()) * (Max - Min) + Min;
 	}
 
 	template <>
 	GLM_FUNC_QUALIFIER double compute_linearRand::operator()<double> (double const & Min, double const & Max) const
 	{
-		return double(std::rand()) / double(RAND_MAX) * (Max - Min) + Min;
+		return rand_unit(rand_uint32(), rand_uint32()) * (Max - Min) + Min;
 	}
     
 	template <>
 	GLM_FUNC_QUALIFIER long double compute_linearRand::operator()<long double> (long double const & Min, long double const & Max) const
 	{
-		return (long double)(std::rand()) / (long double)(RAND_MAX) * (Max - Min) + Min;
+		return (long double)(rand_unit(rand_uint32(), rand_uint32())) * (Max - Min) + Min;
 	}
 }//namespace detail
 
@@ -98,7 +254,7 @@ namespace detail
 			w = x1 * x1 + x2 * x2;
 		} while(w > genType(1));
 	
-		return x2 * Deviation * Deviation * sqrt((genType(-2) * log(w)) / w) + Mean;
+		return x2 * Deviation * sqrt((genType(-2) * log(w)) / w) + Mean;
 	}
 
 	VECTORIZE_VEC_VEC(gaussRand)
@@ -167,4 +323,145 @@ namespace detail
 	
 		return detail::tvec3<T>(x, y, z) * Radius;	
 	}
+
+	GLM_FUNC_QUALIFIER void seedRand
+	(
+		detail::uint64 const & Seed
+	)
+	{
+		detail::rand_seed(detail::rand_thread_state(), Seed);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void linearRand
+	(
+		T const & Min, 
+		T const & Max, 
+		T * out, 
+		std::size_t count
+	)
+	{
+		detail::rand_fill_unit(out, count);
+		for(std::size_t i = 0; i < count; ++i)
+			out[i] = out[i] * (Max - Min) + Min;
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void gaussRand
+	(
+		T const & Mean, 
+		T const & Deviation, 
+		T * out, 
+		std::size_t count
+	)
+	{
+		// Box-Muller: each pair of uniform values gives two gaussian ones
+		T Unit[256];
+		for(std::size_t i = 0; i < count; i += 256)
+		{
+			std::size_t const Size = count - i < 256 ? count - i : 256;
+			detail::rand_fill_unit(Unit, Size + Size % 2);
+			for(std::size_t j = 0; j < Size; j += 2)
+			{
+				T r = Deviation * sqrt(T(-2) * log(T(1) - Unit[j + 0]));
+				T a = T(6.283185307179586476925286766559) * Unit[j + 1];
+				out[i + j] = r * cos(a) + Mean;
+				if(j + 1 < Size)
+					out[i + j + 1] = r * sin(a) + Mean;
+			}
+		}
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void circularRand
+	(
+		T const & Radius, 
+		detail::tvec2<T> * out, 
+		std::size_t count
+	)
+	{
+		T Unit[256];
+		for(std::size_t i = 0; i < count; i += 256)
+		{
+			std::size_t const Size = count - i < 256 ? count - i : 256;
+			detail::rand_fill_unit(Unit, Size);
+			for(std::size_t j = 0; j < Size; ++j)
+			{
+				T a = T(6.283185307179586476925286766559) * Unit[j];
+				out[i + j] = detail::tvec2<T>(cos(a), sin(a)) * Radius;
+			}
+		}
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void sphericalRand
+	(
+		T const & Radius, 
+		detail::tvec3<T> * out, 
+		std::size_t count
+	)
+	{
+		T Unit[256];
+		for(std::size_t i = 0; i < count; i += 128)
+		{
+			std::size_t const Size = count - i < 128 ? count - i : 128;
+			detail::rand_fill_unit(Unit, Size * 2);
+			for(std::size_t j = 0; j < Size; ++j)
+			{
+				T z = Unit[j * 2 + 0] * T(2) - T(1);
+				T a = Unit[j * 2 + 1] * T(6.283185307179586476925286766559);
+				T r = sqrt(T(1) - z * z);
+				out[i + j] = detail::tvec3<T>(r * cos(a), r * sin(a), z) * Radius;
+			}
+		}
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void diskRand
+	(
+		T const & Radius, 
+		detail::tvec2<T> * out, 
+		std::size_t count
+	)
+	{
+		// Square root of the uniform radius instead of rejection, so every
+		// value costs the same
+		T Unit[256];
+		for(std::size_t i = 0; i < count; i += 128)
+		{
+			std::size_t const Size = count - i < 128 ? count - i : 128;
+			detail::rand_fill_unit(Unit, Size * 2);
+			for(std::size_t j = 0; j < Size; ++j)
+			{
+				T r = Radius * sqrt(Unit[j * 2 + 0]);
+				T a = Unit[j * 2 + 1] * T(6.283185307179586476925286766559);
+				out[i + j] = detail::tvec2<T>(cos(a), sin(a)) * r;
+			}
+		}
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void ballRand
+	(
+		T const & Radius, 
+		detail::tvec3<T> * out, 
+		std::size_t count
+	)
+	{
+		// Cube root of the uniform radius instead of rejection
+		T Unit[255];
+		for(std::size_t i = 0; i < count; i += 85)
+		{
+			std::size_t const Size = count - i < 85 ? count - i : 85;
+			detail::rand_fill_unit(Unit, Size * 3);
+			for(std::size_t j = 0; j < Size; ++j)
+			{
+				T z = Unit[j * 3 + 0] * T(2) - T(1);
+				T a = Unit[j * 3 + 1] * T(6.283185307179586476925286766559);
+				T r = sqrt(T(1) - z * z);
+				T l = Radius * pow(Unit[j * 3 + 2], T(1) / T(3));
+				out[i + j] = detail::tvec3<T>(r * cos(a), r * sin(a), z) * l;
+			}
+		}
+	}
 }//namespace glm
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref gtx_batch_packing
+/// @file glm/gtx/batch_packing.hpp
+/// @date 2016-11-06 / 2016-11-06
+/// @author Roberto Cano
+///
+/// @see core (dependence)
+/// @see gtc_half_float (dependence)
+///
+/// @defgroup gtx_batch_packing GLM_GTX_batch_packing
+/// @ingroup gtx
+/// 
+/// @brief Array versions of the packing functions, meant for vertex streams.
+/// 
+/// Every function converts count values from in to out. With SSE2 four
+/// values are packed per iteration; results are the same as calling the
+/// scalar packing functions on each element.
+/// 
+/// <glm/gtx/batch_packing.hpp> need to be included to use these functionalities.
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GLM_GTX_batch_packing
+#define GLM_GTX_batch_packing GLM_VERSION
+
+// Dependency:
+#include "../glm.hpp"
+#include "../gtc/half_float.hpp"
+#include <cstddef>
+
+#if(defined(GLM_MESSAGES) && !defined(glm_ext))
+#	pragma message("GLM: GLM_GTX_batch_packing extension included")
+#endif
+
+namespace glm
+{
+	/// @addtogroup gtx_batch_packing
+	/// @{
+
+	//! Packs each vector into a signed normalized 10_10_10_2 value: x in the
+	//! lowest 10 bits, then y and z, w left to 0. Matches A2B10G10R10_SNORM.
+	//! From GLM_GTX_batch_packing extension.
+	detail::uint32 packSnorm3x10_1x2(detail::tvec3<detail::float32> const & v);
+
+	//! Array version of packSnorm3x10_1x2.
+	//! From GLM_GTX_batch_packing extension.
+	void packSnorm3x10_1x2(detail::tvec3<detail::float32> const * in, detail::uint32 * out, std::size_t count);
+
+	//! Array version of packUnorm2x16.
+	//! From GLM_GTX_batch_packing extension.
+	void packUnorm2x16(detail::tvec2<detail::float32> const * in, detail::uint32 * out, std::size_t count);
+
+	//! Array version of packHalf2x16. Rounds half away from zero like it,
+	//! not to nearest even like packHalf.
+	//! From GLM_GTX_batch_packing extension.
+	void packHalf2x16(detail::tvec2<detail::float32> const * in, detail::uint32 * out, std::size_t count);
+
+	//! Packs each vector relative to the [minBound, maxBound] box into four
+	//! unsigned normalized 16 bits values, w set to 1. Writes 4 values per vector.
+	//! From GLM_GTX_batch_packing extension.
+	void packBoundedUnorm4x16(
+		detail::tvec3<detail::float32> const * in, 
+		detail::tvec3<detail::float32> const & minBound, 
+		detail::tvec3<detail::float32> const & maxBound, 
+		detail::uint16 * out, 
+		std::size_t count);
+
+	/// @}
+}//namespace glm
+
+#include "batch_packing.inl"
+
+#endif//GLM_GTX_batch_packing
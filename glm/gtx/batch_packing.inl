@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2016-11-06
+// Updated : 2016-11-06
+// Licence : This source is under MIT License
+// File    : glm/gtx/batch_packing.inl
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail
+{
+	GLM_FUNC_QUALIFIER void packBoundedUnorm4x16
+	(
+		tvec3<float32> const & v, 
+		tvec3<float32> const & minBound, 
+		tvec3<float32> const & scale, 
+		uint16 * out
+	)
+	{
+		tvec3<float32> Unpack = clamp((v - minBound) * scale, 0.0f, 1.0f) * 65535.0f;
+		out[0] = uint16(round(Unpack.x));
+		out[1] = uint16(round(Unpack.y));
+		out[2] = uint16(round(Unpack.z));
+		out[3] = uint16(65535);
+	}
+
+#if(GLM_ARCH & GLM_ARCH_SSE2)
+	// Same rounding as glm::round: half away from zero
+	GLM_FUNC_QUALIFIER __m128i batch_round_ps(__m128 x)
+	{
+		__m128 const Half = _mm_set1_ps(0.5f);
+		__m128 const SignMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+		return _mm_cvttps_epi32(_mm_add_ps(x, _mm_or_ps(_mm_and_ps(x, SignMask), Half)));
+	}
+
+	GLM_FUNC_QUALIFIER __m128 batch_clamp_ps(__m128 x, float minVal, float maxVal)
+	{
+		return _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(minVal)), _mm_set1_ps(maxVal));
+	}
+
+	// Same conversion as detail::toFloat16: rounds half away from zero and
+	// keeps the payload of NaNs, where packHalf rounds to nearest even
+	GLM_FUNC_QUALIFIER __m128i batch_float_to_half_ps(__m128 x)
+	{
+		__m128i const SignMask = _mm_set1_epi32(0x80000000);
+		__m128i const Infinity = _mm_set1_epi32(255 << 23);
+		__m128i const Overflow = _mm_set1_epi32(((127 + 16) << 23) - 1);
+		__m128i const Subnormal = _mm_set1_epi32((127 - 14) << 23);
+		__m128i const Rebias = _mm_set1_epi32(0x1000 - ((127 - 15) << 23));
+		__m128i const Mant10 = _mm_set1_epi32(0x3ff);
+		__m128 const DenormScale = _mm_set1_ps(16777216.0f);
+		__m128 const Half = _mm_set1_ps(0.5f);
+
+		__m128i Bits = _mm_castps_si128(x);
+		__m128i Sign = _mm_and_si128(Bits, SignMask);
+		Bits = _mm_xor_si128(Bits, Sign);
+
+		// 2^16 and above is Inf; NaNs keep their top 10 bits, at least one set
+		__m128i IsInfNan = _mm_cmpgt_epi32(Bits, Overflow);
+		__m128i NanMant = _mm_and_si128(_mm_srli_epi32(Bits, 13), Mant10);
+		NanMant = _mm_or_si128(NanMant, _mm_srli_epi32(_mm_cmpeq_epi32(NanMant, _mm_setzero_si128()), 31));
+		__m128i InfNan = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(_mm_cmpgt_epi32(Bits, Infinity), NanMant));
+
+		// Subnormal results count units of 2^-24, exact after the scale, and
+		// round the fraction up from 0.5
+		__m128i IsSubnormal = _mm_cmplt_epi32(Bits, Subnormal);
+		__m128 Units = _mm_mul_ps(_mm_castsi128_ps(Bits), DenormScale);
+		__m128i Denorm = _mm_cvttps_epi32(Units);
+		__m128 Fraction = _mm_sub_ps(Units, _mm_cvtepi32_ps(Denorm));
+		Denorm = _mm_sub_epi32(Denorm, _mm_castps_si128(_mm_cmpge_ps(Fraction, Half)));
+
+		// Normal results: rebias the exponent, a carry out of the mantissa
+		// moves to the next exponent and up to Inf
+		__m128i Normal = _mm_srli_epi32(_mm_add_epi32(Bits, Rebias), 13);
+
+		__m128i Result = _mm_or_si128(_mm_and_si128(IsSubnormal, Denorm), _mm_andnot_si128(IsSubnormal, Normal));
+		Result = _mm_or_si128(_mm_and_si128(IsInfNan, InfNan), _mm_andnot_si128(IsInfNan, Result));
+		return _mm_or_si128(Result, _mm_srli_epi32(Sign, 16));
+	}
+#endif//GLM_ARCH
+}//namespace detail
+
+	GLM_FUNC_QUALIFIER detail::uint32 packSnorm3x10_1x2(detail::tvec3<detail::float32> const & v)
+	{
+		detail::tvec3<detail::float32> Unpack = clamp(v, -1.0f, 1.0f) * 511.0f;
+		detail::uint32 Mask10((1 << 10) - 1);
+		detail::uint32 A(detail::uint32(detail::int32(round(Unpack.x))) & Mask10);
+		detail::uint32 B(detail::uint32(detail::int32(round(Unpack.y))) & Mask10);
+		detail::uint32 C(detail::uint32(detail::int32(round(Unpack.z))) & Mask10);
+		return (C << 20) | (B << 10) | (A << 0);
+	}
+
+	GLM_FUNC_QUALIFIER void packSnorm3x10_1x2
+	(
+		detail::tvec3<detail::float32> const * in, 
+		detail::uint32 * out, 
+		std::size_t count
+	)
+	{
+		std::size_t i = 0;
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			__m128i const Mask10 = _mm_set1_epi32((1 << 10) - 1);
+			__m128 const Scale = _mm_set1_ps(511.0f);
+			for(; i + 4 <= count; i += 4)
+			{
+				detail::tvec3<detail::float32> const * v = in + i;
+				__m128 X = _mm_setr_ps(v[0].x, v[1].x, v[2].x, v[3].x);
+				__m128 Y = _mm_setr_ps(v[0].y, v[1].y, v[2].y, v[3].y);
+				__m128 Z = _mm_setr_ps(v[0].z, v[1].z, v[2].z, v[3].z);
+				__m128i A = _mm_and_si128(detail::batch_round_ps(_mm_mul_ps(detail::batch_clamp_ps(X, -1.0f, 1.0f), Scale)), Mask10);
+				__m128i B = _mm_and_si128(detail::batch_round_ps(_mm_mul_ps(detail::batch_clamp_ps(Y, -1.0f, 1.0f), Scale)), Mask10);
+				__m128i C = _mm_and_si128(detail::batch_round_ps(_mm_mul_ps(detail::batch_clamp_ps(Z, -1.0f, 1.0f), Scale)), Mask10);
+				__m128i Pack = _mm_or_si128(A, _mm_or_si128(_mm_slli_epi32(B, 10), _mm_slli_epi32(C, 20)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), Pack);
+			}
+#		endif
+		for(; i < count; ++i)
+			out[i] = packSnorm3x10_1x2(in[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void packUnorm2x16
+	(
+		detail::tvec2<detail::float32> const * in, 
+		detail::uint32 * out, 
+		std::size_t count
+	)
+	{
+		std::size_t i = 0;
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			__m128 const Scale = _mm_set1_ps(65535.0f);
+			__m128 const Half = _mm_set1_ps(0.5f);
+			for(; i + 4 <= count; i += 4)
+			{
+				// Two vectors per register, already in x, y order
+				float const * v = &in[i].x;
+				__m128 Lo = _mm_mul_ps(detail::batch_clamp_ps(_mm_loadu_ps(v + 0), 0.0f, 1.0f), Scale);
+				__m128 Hi = _mm_mul_ps(detail::batch_clamp_ps(_mm_loadu_ps(v + 4), 0.0f, 1.0f), Scale);
+				__m128i A = _mm_cvttps_epi32(_mm_add_ps(Lo, Half));
+				__m128i B = _mm_cvttps_epi32(_mm_add_ps(Hi, Half));
+				// Sign extend the low 16 bits so packs_epi32 doesn't saturate
+				A = _mm_srai_epi32(_mm_slli_epi32(A, 16), 16);
+				B = _mm_srai_epi32(_mm_slli_epi32(B, 16), 16);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(A, B));
+			}
+#		endif
+		for(; i < count; ++i)
+			out[i] = packUnorm2x16(in[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void packHalf2x16
+	(
+		detail::tvec2<detail::float32> const * in, 
+		detail::uint32 * out, 
+		std::size_t count
+	)
+	{
+		std::size_t i = 0;
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			// Not packHalf: neither F16C nor its SSE2 path round as packHalf2x16
+			for(; i + 4 <= count; i += 4)
+			{
+				// x lands in the low 16 bits of each output, as with packHalf2x16
+				float const * v = &in[i].x;
+				__m128i Lo = detail::batch_float_to_half_ps(_mm_loadu_ps(v + 0));
+				__m128i Hi = detail::batch_float_to_half_ps(_mm_loadu_ps(v + 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), detail::sse_pack_half(Lo, Hi));
+			}
+#		endif
+		for(; i < count; ++i)
+			out[i] = packHalf2x16(in[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void packBoundedUnorm4x16
+	(
+		detail::tvec3<detail::float32> const * in, 
+		detail::tvec3<detail::float32> const & minBound, 
+		detail::tvec3<detail::float32> const & maxBound, 
+		detail::uint16 * out, 
+		std::size_t count
+	)
+	{
+		// A flat axis maps every value to 0 instead of dividing by zero
+		detail::tvec3<detail::float32> Extent = maxBound - minBound;
+		detail::tvec3<detail::float32> Scale(
+			Extent.x > 0.0f ? 1.0f / Extent.x : 0.0f,
+			Extent.y > 0.0f ? 1.0f / Extent.y : 0.0f,
+			Extent.z > 0.0f ? 1.0f / Extent.z : 0.0f);
+
+		std::size_t i = 0;
+#		if(GLM_ARCH & GLM_ARCH_SSE2)
+			__m128 const Range = _mm_set1_ps(65535.0f);
+			__m128 const Half = _mm_set1_ps(0.5f);
+			__m128i const One = _mm_slli_epi32(_mm_set1_epi32(65535), 16);
+			for(; i + 4 <= count; i += 4)
+			{
+				detail::tvec3<detail::float32> const * v = in + i;
+				__m128 X = _mm_setr_ps(v[0].x, v[1].x, v[2].x, v[3].x);
+				__m128 Y = _mm_setr_ps(v[0].y, v[1].y, v[2].y, v[3].y);
+				__m128 Z = _mm_setr_ps(v[0].z, v[1].z, v[2].z, v[3].z);
+				X = _mm_mul_ps(_mm_sub_ps(X, _mm_set1_ps(minBound.x)), _mm_set1_ps(Scale.x));
+				Y = _mm_mul_ps(_mm_sub_ps(Y, _mm_set1_ps(minBound.y)), _mm_set1_ps(Scale.y));
+				Z = _mm_mul_ps(_mm_sub_ps(Z, _mm_set1_ps(minBound.z)), _mm_set1_ps(Scale.z));
+				__m128i A = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(detail::batch_clamp_ps(X, 0.0f, 1.0f), Range), Half));
+				__m128i B = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(detail::batch_clamp_ps(Y, 0.0f, 1.0f), Range), Half));
+				__m128i C = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(detail::batch_clamp_ps(Z, 0.0f, 1.0f), Range), Half));
+				// Lane k holds x | y << 16 and z | w << 16 of vector k
+				__m128i XY = _mm_or_si128(A, _mm_slli_epi32(B, 16));
+				__m128i ZW = _mm_or_si128(C, One);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4 + 0), _mm_unpacklo_epi32(XY, ZW));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4 + 8), _mm_unpackhi_epi32(XY, ZW));
+			}
+#		endif
+		for(; i < count; ++i)
+			detail::packBoundedUnorm4x16(in[i], minBound, Scale, out + i * 4);
+	}
+
+}//namespace glm
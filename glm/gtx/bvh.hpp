@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref gtx_bvh
+/// @file glm/gtx/bvh.hpp
+/// @date 2016-11-08 / 2016-11-08
+/// @author Roberto Cano
+///
+/// @see core (dependence)
+/// @see gtx_intersect (dependence)
+/// @see gtx_vec_soa (dependence)
+///
+/// @defgroup gtx_bvh GLM_GTX_bvh
+/// @ingroup gtx
+/// 
+/// @brief Bounding volume hierarchy over the triangles of an indexed mesh,
+/// for picking, visibility and other ray queries.
+/// 
+/// The hierarchy is built with a binned surface area heuristic; the top of
+/// the tree can be split across several threads when the compiler supports
+/// C++11 threads. Rays are traced one at a time or as packets of 4 (SSE) or
+/// 8 (AVX) rays for float, with the same results.
+/// 
+/// <glm/gtx/bvh.hpp> need to be included to use these functionalities.
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GLM_GTX_bvh
+#define GLM_GTX_bvh GLM_VERSION
+
+// Dependency:
+#include "../glm.hpp"
+#include "../gtx/intersect.hpp"
+#include "../gtx/vec_soa.hpp"
+#include <vector>
+
+#if((__cplusplus >= 201103L) || ((GLM_COMPILER & GLM_COMPILER_VC) && (GLM_COMPILER >= GLM_COMPILER_VC2012)))
+#	define GLM_BVH_THREADS 1
+#	include <thread>
+#	include <functional>
+#else
+#	define GLM_BVH_THREADS 0
+#endif
+
+#if(defined(GLM_MESSAGES) && !defined(glm_ext))
+#	pragma message("GLM: GLM_GTX_bvh extension included")
+#endif
+
+namespace glm{
+namespace detail
+{
+	/// Node of a tbvh, 32 bytes for float. The first child of an inner node
+	/// is stored right after it and Offset is the index of the second one;
+	/// a leaf references Count triangles starting at Offset.
+	template <typename T>
+	struct tbvh_node
+	{
+		tvec3<T> Min;
+		uint32 Offset;
+		tvec3<T> Max;
+		uint16 Count;
+		uint16 Axis;
+	};
+
+	/// Bounding volume hierarchy over the triangles of an indexed mesh.
+	/// Triangles are tested from both sides. The hierarchy keeps its own
+	/// copy of the vertices, so the mesh can be released after the build.
+	/// \ingroup gtx_bvh
+	template <typename T>
+	class tbvh
+	{
+	public:
+		typedef T value_type;
+		typedef std::size_t size_type;
+		typedef tbvh_node<T> node_type;
+
+		tbvh();
+
+		//! Build over the indexCount / 3 triangles of an indexed mesh,
+		//! see build
+		tbvh(
+			tvec3<T> const * positions, 
+			uint32 const * indices, 
+			size_type indexCount, 
+			size_type threads = 1);
+
+		//! Replace the hierarchy with one over the indexCount / 3 triangles
+		//! of an indexed mesh. threads = 0 uses every core.
+		void build(
+			tvec3<T> const * positions, 
+			uint32 const * indices, 
+			size_type indexCount, 
+			size_type threads = 1);
+
+		void clear();
+		bool empty() const;
+
+		//! Number of triangles
+		size_type size() const;
+
+		std::vector<node_type> const & nodes() const;
+
+		//! Closest hit along a ray. baryPosition.z holds the maximum distance
+		//! on input; on a hit baryPosition gets the barycentric position and
+		//! distance of the hit, as intersectRayTriangle, and triangle its
+		//! index in the mesh. Both are left untouched otherwise.
+		bool intersect(
+			tvec3<T> const & orig, tvec3<T> const & dir, 
+			tvec3<T> & baryPosition, uint32 & triangle) const;
+
+		//! Whether any triangle is hit closer than maxDistance, stopping at
+		//! the first one found.
+		bool occluded(
+			tvec3<T> const & orig, tvec3<T> const & dir, 
+			T const & maxDistance) const;
+
+		//! Closest hit of count rays, given as structures of arrays and traced
+		//! as packets. Same convention as the single ray version with
+		//! triangle[0..count). Returns the number of rays hitting the mesh.
+		size_type intersect(
+			tvec3soa<T> const & orig, tvec3soa<T> const & dir, 
+			tvec3soa<T> & baryPosition, uint32 * triangle) const;
+
+		//! Any hit of count rays, given as structures of arrays and traced
+		//! as packets: out[i] tells whether ray i hits a triangle closer than
+		//! maxDistance[i]. Returns the number of occluded rays.
+		size_type occluded(
+			tvec3soa<T> const & orig, tvec3soa<T> const & dir, 
+			T const * maxDistance, bool * out) const;
+
+	private:
+		std::vector<node_type> Nodes;
+		std::vector<tvec3<T> > Vertices;		// Three per triangle, in leaf order
+		std::vector<uint32> Triangles;			// Mesh index of the triangles, in leaf order
+	};
+}//namespace detail
+
+	typedef detail::tbvh<float> bvh;
+	typedef detail::tbvh<double> dbvh;
+}// namespace glm
+
+#include "bvh.inl"
+
+#endif//GLM_GTX_bvh
@@ -0,0 +1,558 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2016-11-08
+// Updated : 2016-11-08
+// Licence : This source is under MIT License
+// File    : glm/gtx/bvh.inl
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+namespace glm{
+namespace detail
+{
+	//////////////////////////////////////
+	// Build
+
+	enum
+	{
+		bvh_bins = 16,				// Candidate splits per axis
+		bvh_max_leaf = 16,			// Leaves are split past this size even when the SAH would keep them
+		bvh_max_depth = 64,			// Deeper nodes are split at the median to bound the traversal stack
+		bvh_stack_size = 128,
+		bvh_thread_size = 4096		// Smallest subtree given to another thread
+	};
+
+	template <typename T>
+	struct bvh_bounds
+	{
+		tvec3<T> Min;
+		tvec3<T> Max;
+
+		GLM_FUNC_QUALIFIER bvh_bounds() :
+			Min(std::numeric_limits<T>::max()),
+			Max(-std::numeric_limits<T>::max())
+		{}
+
+		GLM_FUNC_QUALIFIER void grow(tvec3<T> const & p)
+		{
+			Min = min(Min, p);
+			Max = max(Max, p);
+		}
+
+		GLM_FUNC_QUALIFIER void grow(bvh_bounds<T> const & b)
+		{
+			Min = min(Min, b.Min);
+			Max = max(Max, b.Max);
+		}
+
+		// Half the surface area, all the SAH needs
+		GLM_FUNC_QUALIFIER T area() const
+		{
+			if(Max.x < Min.x)
+				return T(0);
+			tvec3<T> e = Max - Min;
+			return e.x * e.y + e.y * e.z + e.z * e.x;
+		}
+	};
+
+	// Per triangle bounds and centroids, and the triangle references that
+	// get partitioned in place while going down the tree
+	template <typename T>
+	struct bvh_build_context
+	{
+		std::vector<bvh_bounds<T> > Bounds;
+		std::vector<tvec3<T> > Centroids;
+		std::vector<uint32> Refs;
+	};
+
+	template <typename T>
+	struct bvh_centroid_less
+	{
+		bvh_build_context<T> const * Context;
+		int Axis;
+
+		GLM_FUNC_QUALIFIER bool operator()(uint32 a, uint32 b) const
+		{
+			return Context->Centroids[a][Axis] < Context->Centroids[b][Axis];
+		}
+	};
+
+	template <typename T>
+	struct bvh_bin_below
+	{
+		bvh_build_context<T> const * Context;
+		int Axis;
+		T Origin;
+		T Scale;
+		int Split;
+
+		GLM_FUNC_QUALIFIER bool operator()(uint32 Ref) const
+		{
+			int Bin = int((Context->Centroids[Ref][Axis] - Origin) * Scale);
+			return (Bin < int(bvh_bins) - 1 ? Bin : int(bvh_bins) - 1) < Split;
+		}
+	};
+
+	// Appends the subtree of Refs[First, Last) to Nodes. The right child is
+	// built on another thread while Threads > 1; its nodes are collected
+	// apart and moved after the left ones.
+	template <typename T>
+	GLM_FUNC_QUALIFIER void bvh_build_node
+	(
+		bvh_build_context<T> & Context,
+		std::size_t First,
+		std::size_t Last,
+		std::size_t Depth,
+		std::size_t Threads,
+		std::vector<tbvh_node<T> > & Nodes
+	)
+	{
+		std::size_t const Index = Nodes.size();
+		Nodes.push_back(tbvh_node<T>());
+
+		bvh_bounds<T> Bounds, Centroids;
+		for(std::size_t i = First; i < Last; ++i)
+		{
+			Bounds.grow(Context.Bounds[Context.Refs[i]]);
+			Centroids.grow(Context.Centroids[Context.Refs[i]]);
+		}
+		Nodes[Index].Min = Bounds.Min;
+		Nodes[Index].Max = Bounds.Max;
+		Nodes[Index].Offset = uint32(First);
+		Nodes[Index].Count = uint16(Last - First);
+		Nodes[Index].Axis = 0;
+
+		std::size_t const Count = Last - First;
+		if(Count <= 2)
+			return;
+
+		// Binned SAH, with traversal and intersection costs of 1
+		T BestCost = T(Count);
+		int BestAxis = -1;
+		int BestSplit = 0;
+		for(int Axis = 0; Axis < 3 && Depth < std::size_t(bvh_max_depth); ++Axis)
+		{
+			T const Extent = Centroids.Max[Axis] - Centroids.Min[Axis];
+			if(Extent <= T(0))
+				continue;
+
+			bvh_bin_below<T> Bin = {&Context, Axis, Centroids.Min[Axis], T(bvh_bins) / Extent, 0};
+			bvh_bounds<T> BinBounds[bvh_bins];
+			std::size_t BinCount[bvh_bins] = {0};
+			for(std::size_t i = First; i < Last; ++i)
+			{
+				uint32 Ref = Context.Refs[i];
+				int b = int((Context.Centroids[Ref][Axis] - Bin.Origin) * Bin.Scale);
+				b = b < int(bvh_bins) - 1 ? b : int(bvh_bins) - 1;
+				BinBounds[b].grow(Context.Bounds[Ref]);
+				++BinCount[b];
+			}
+
+			// Right sweep to get the cost of every right side
+			T RightArea[bvh_bins];
+			std::size_t RightCount[bvh_bins];
+			bvh_bounds<T> Right;
+			std::size_t N = 0;
+			for(int b = bvh_bins - 1; b > 0; --b)
+			{
+				Right.grow(BinBounds[b]);
+				N += BinCount[b];
+				RightArea[b] = Right.area();
+				RightCount[b] = N;
+			}
+
+			bvh_bounds<T> Left;
+			N = 0;
+			T const InvArea = T(1) / Bounds.area();
+			for(int Split = 1; Split < bvh_bins; ++Split)
+			{
+				Left.grow(BinBounds[Split - 1]);
+				N += BinCount[Split - 1];
+				if(N == 0 || RightCount[Split] == 0)
+					continue;
+				T Cost = T(1) + (Left.area() * T(N) + RightArea[Split] * T(RightCount[Split])) * InvArea;
+				if(Cost < BestCost)
+				{
+					BestCost = Cost;
+					BestAxis = Axis;
+					BestSplit = Split;
+				}
+			}
+		}
+
+		std::size_t Middle;
+		if(BestAxis >= 0)
+		{
+			bvh_bin_below<T> Below = {&Context, BestAxis, Centroids.Min[BestAxis], T(bvh_bins) / (Centroids.Max[BestAxis] - Centroids.Min[BestAxis]), BestSplit};
+			Middle = std::partition(Context.Refs.begin() + First, Context.Refs.begin() + Last, Below) - Context.Refs.begin();
+		}
+		else if(Count > std::size_t(bvh_max_leaf) || Depth >= std::size_t(bvh_max_depth))
+		{
+			// Cheaper as a leaf but too big, or too deep: median split on
+			// the widest axis
+			tvec3<T> Extent = Centroids.Max - Centroids.Min;
+			BestAxis = Extent.x > Extent.y ? (Extent.x > Extent.z ? 0 : 2) : (Extent.y > Extent.z ? 1 : 2);
+			Middle = First + Count / 2;
+			bvh_centroid_less<T> Less = {&Context, BestAxis};
+			std::nth_element(Context.Refs.begin() + First, Context.Refs.begin() + Middle, Context.Refs.begin() + Last, Less);
+		}
+		else
+			return;
+
+		Nodes[Index].Count = 0;
+		Nodes[Index].Axis = uint16(BestAxis);
+
+#		if(GLM_BVH_THREADS)
+			if(Threads > 1 && Last - Middle >= std::size_t(bvh_thread_size))
+			{
+				std::vector<tbvh_node<T> > RightNodes;
+				std::thread Worker(&bvh_build_node<T>, std::ref(Context), Middle, Last, Depth + 1, Threads - Threads / 2, std::ref(RightNodes));
+				bvh_build_node(Context, First, Middle, Depth + 1, Threads / 2, Nodes);
+				Worker.join();
+
+				uint32 const Base = uint32(Nodes.size());
+				Nodes[Index].Offset = Base;
+				for(std::size_t i = 0; i < RightNodes.size(); ++i)
+				{
+					if(!RightNodes[i].Count)
+						RightNodes[i].Offset += Base;
+					Nodes.push_back(RightNodes[i]);
+				}
+				return;
+			}
+#		endif
+
+		bvh_build_node(Context, First, Middle, Depth + 1, Threads, Nodes);
+		Nodes[Index].Offset = uint32(Nodes.size());
+		bvh_build_node(Context, Middle, Last, Depth + 1, Threads, Nodes);
+	}
+
+	//////////////////////////////////////
+	// Traversal
+
+	// Traces P::size rays, closest hit or any hit. x, y and Distance follow
+	// soa_intersect_ray_triangle; triangle, when not null, gets the mesh
+	// index of the triangle hit by each lane. Returns the lanes that hit.
+	template <bool Any, typename P, typename T>
+	GLM_FUNC_QUALIFIER typename P::mask bvh_traverse
+	(
+		std::vector<tbvh_node<T> > const & Nodes,
+		tvec3<T> const * Vertices,
+		uint32 const * Triangles,
+		typename P::type const orig[3], typename P::type const dir[3],
+		typename P::type & x, typename P::type & y, typename P::type & Distance,
+		uint32 * triangle
+	)
+	{
+		typedef typename P::type type;
+		typedef typename P::mask mask;
+
+		type const Zero = P::set1(T(0));
+		mask Active = P::lessThan(Zero, Distance);
+		mask Hit = P::mask_andnot(Active, Active);
+		if(Nodes.empty())
+			return Hit;
+
+		// Children are visited front to back along the direction of the
+		// first ray, the other rays of a coherent packet mostly agree
+		type Inv[3];
+		int Negative[3];
+		for(int c = 0; c < 3; ++c)
+		{
+			Inv[c] = P::div(P::set1(T(1)), dir[c]);
+			Negative[c] = P::movemask(P::lessThan(dir[c], Zero)) & 1;
+		}
+
+		uint32 Stack[bvh_stack_size];
+		int Top = 0;
+		Stack[Top++] = 0;
+		while(Top)
+		{
+			uint32 const Index = Stack[--Top];
+			tbvh_node<T> const & Node = Nodes[Index];
+
+			type Near = Zero;
+			type Far = Distance;
+			for(int c = 0; c < 3; ++c)
+			{
+				type t0 = P::mul(P::sub(P::set1(Node.Min[c]), orig[c]), Inv[c]);
+				type t1 = P::mul(P::sub(P::set1(Node.Max[c]), orig[c]), Inv[c]);
+				Near = P::max(Near, P::min(t0, t1));
+				Far = P::min(Far, P::max(t0, t1));
+			}
+			if(!P::movemask(P::mask_and(Active, P::lessThanEqual(Near, Far))))
+				continue;
+
+			if(Node.Count)
+			{
+				for(uint32 i = Node.Offset; i < Node.Offset + Node.Count; ++i)
+				{
+					mask Lanes = soa_intersect_ray_triangle<P>(orig, dir, Vertices[i * 3 + 0], Vertices[i * 3 + 1], Vertices[i * 3 + 2], x, y, Distance, true);
+					int Bits = P::movemask(Lanes);
+					if(!Bits)
+						continue;
+
+					Hit = P::mask_or(Hit, Lanes);
+					if(triangle)
+						for(int Lane = 0; Lane < int(P::size); ++Lane)
+							if(Bits & (1 << Lane))
+								triangle[Lane] = Triangles[i];
+
+					if(Any)
+					{
+						Active = P::mask_andnot(Active, Lanes);
+						if(!P::movemask(Active))
+							return Hit;
+					}
+				}
+			}
+			else
+			{
+				uint32 Front = Index + 1;
+				uint32 Back = Node.Offset;
+				if(Negative[Node.Axis])
+					std::swap(Front, Back);
+				assert(Top + 2 <= int(bvh_stack_size));
+				Stack[Top++] = Back;
+				Stack[Top++] = Front;
+			}
+		}
+		return Hit;
+	}
+
+	template <bool Any, typename P, typename T>
+	GLM_FUNC_QUALIFIER std::size_t bvh_traverse
+	(
+		std::vector<tbvh_node<T> > const & Nodes,
+		tvec3<T> const * Vertices,
+		uint32 const * Triangles,
+		T const * const orig[3], T const * const dir[3],
+		T * const baryPosition[3], T const * maxDistance,
+		uint32 * triangle, bool * out,
+		std::size_t First, std::size_t Last
+	)
+	{
+		std::size_t Count = 0;
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			typename P::type o[3], d[3];
+			for(int c = 0; c < 3; ++c)
+			{
+				o[c] = P::load(orig[c] + i);
+				d[c] = P::load(dir[c] + i);
+			}
+
+			if(Any)
+			{
+				typename P::type x = P::set1(T(0));
+				typename P::type y = P::set1(T(0));
+				typename P::type z = P::loadu(maxDistance + i);
+				int Bits = P::movemask(bvh_traverse<true, P>(Nodes, Vertices, Triangles, o, d, x, y, z, 0));
+				for(int Lane = 0; Lane < int(P::size); ++Lane)
+				{
+					out[i + Lane] = (Bits & (1 << Lane)) != 0;
+					Count += out[i + Lane] ? 1 : 0;
+				}
+			}
+			else
+			{
+				typename P::type x = P::load(baryPosition[0] + i);
+				typename P::type y = P::load(baryPosition[1] + i);
+				typename P::type z = P::load(baryPosition[2] + i);
+				int Bits = P::movemask(bvh_traverse<false, P>(Nodes, Vertices, Triangles, o, d, x, y, z, triangle + i));
+				if(!Bits)
+					continue;
+				P::store(baryPosition[0] + i, x);
+				P::store(baryPosition[1] + i, y);
+				P::store(baryPosition[2] + i, z);
+				for(; Bits; Bits &= Bits - 1)
+					++Count;
+			}
+		}
+		return Count;
+	}
+
+	//////////////////////////////////////
+	// tbvh
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tbvh<T>::tbvh()
+	{}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tbvh<T>::tbvh
+	(
+		tvec3<T> const * positions,
+		uint32 const * indices,
+		size_type indexCount,
+		size_type threads
+	)
+	{
+		this->build(positions, indices, indexCount, threads);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tbvh<T>::build
+	(
+		tvec3<T> const * positions,
+		uint32 const * indices,
+		size_type indexCount,
+		size_type threads
+	)
+	{
+		this->clear();
+
+		size_type const Count = indexCount / 3;
+		if(Count == 0)
+			return;
+
+		bvh_build_context<T> Context;
+		Context.Bounds.resize(Count);
+		Context.Centroids.resize(Count);
+		Context.Refs.resize(Count);
+		for(size_type i = 0; i < Count; ++i)
+		{
+			bvh_bounds<T> & Bounds = Context.Bounds[i];
+			Bounds.grow(positions[indices[i * 3 + 0]]);
+			Bounds.grow(positions[indices[i * 3 + 1]]);
+			Bounds.grow(positions[indices[i * 3 + 2]]);
+			Context.Centroids[i] = (Bounds.Min + Bounds.Max) * T(0.5);
+			Context.Refs[i] = uint32(i);
+		}
+
+#		if(GLM_BVH_THREADS)
+			if(threads == 0)
+				threads = size_type(std::thread::hardware_concurrency());
+#		endif
+
+		this->Nodes.reserve(Count / 2);
+		bvh_build_node(Context, 0, Count, 0, threads, this->Nodes);
+
+		// Vertices are copied in leaf order so a leaf reads contiguous memory
+		this->Vertices.resize(Count * 3);
+		this->Triangles.swap(Context.Refs);
+		for(size_type i = 0; i < Count; ++i)
+		for(size_type v = 0; v < 3; ++v)
+			this->Vertices[i * 3 + v] = positions[indices[this->Triangles[i] * 3 + v]];
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tbvh<T>::clear()
+	{
+		this->Nodes.clear();
+		this->Vertices.clear();
+		this->Triangles.clear();
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER bool tbvh<T>::empty() const
+	{
+		return this->Triangles.empty();
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER typename tbvh<T>::size_type tbvh<T>::size() const
+	{
+		return this->Triangles.size();
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER std::vector<typename tbvh<T>::node_type> const & tbvh<T>::nodes() const
+	{
+		return this->Nodes;
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER bool tbvh<T>::intersect
+	(
+		tvec3<T> const & orig, tvec3<T> const & dir,
+		tvec3<T> & baryPosition, uint32 & triangle
+	) const
+	{
+		if(this->empty())
+			return false;
+
+		T const o[3] = {orig.x, orig.y, orig.z};
+		T const d[3] = {dir.x, dir.y, dir.z};
+		T x = baryPosition.x;
+		T y = baryPosition.y;
+		T z = baryPosition.z;
+		uint32 Triangle = 0;
+		if(!bvh_traverse<false, soa_scalar<T>, T>(this->Nodes, &this->Vertices[0], &this->Triangles[0], o, d, x, y, z, &Triangle))
+			return false;
+		baryPosition = tvec3<T>(x, y, z);
+		triangle = Triangle;
+		return true;
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER bool tbvh<T>::occluded
+	(
+		tvec3<T> const & orig, tvec3<T> const & dir,
+		T const & maxDistance
+	) const
+	{
+		if(this->empty())
+			return false;
+
+		T const o[3] = {orig.x, orig.y, orig.z};
+		T const d[3] = {dir.x, dir.y, dir.z};
+		T x = T(0);
+		T y = T(0);
+		T z = maxDistance;
+		return bvh_traverse<true, soa_scalar<T>, T>(this->Nodes, &this->Vertices[0], &this->Triangles[0], o, d, x, y, z, 0);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER typename tbvh<T>::size_type tbvh<T>::intersect
+	(
+		tvec3soa<T> const & orig, tvec3soa<T> const & dir,
+		tvec3soa<T> & baryPosition, uint32 * triangle
+	) const
+	{
+		assert(orig.size() == dir.size() && orig.size() == baryPosition.size());
+		if(this->empty())
+			return 0;
+
+		T const * o[3], * d[3];
+		T * b[3];
+		soa_streams(orig, o);
+		soa_streams(dir, d);
+		for(int c = 0; c < 3; ++c)
+			b[c] = baryPosition.stream(c);
+
+		size_type Bulk = soa_bulk<T>(orig.size());
+		return
+			bvh_traverse<false, soa_packet<T>, T>(this->Nodes, &this->Vertices[0], &this->Triangles[0], o, d, b, 0, triangle, 0, 0, Bulk) +
+			bvh_traverse<false, soa_scalar<T>, T>(this->Nodes, &this->Vertices[0], &this->Triangles[0], o, d, b, 0, triangle, 0, Bulk, orig.size());
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER typename tbvh<T>::size_type tbvh<T>::occluded
+	(
+		tvec3soa<T> const & orig, tvec3soa<T> const & dir,
+		T const * maxDistance, bool * out
+	) const
+	{
+		assert(orig.size() == dir.size());
+		if(this->empty())
+		{
+			std::fill(out, out + orig.size(), false);
+			return 0;
+		}
+
+		T const * o[3], * d[3];
+		soa_streams(orig, o);
+		soa_streams(dir, d);
+
+		size_type Bulk = soa_bulk<T>(orig.size());
+		return
+			bvh_traverse<true, soa_packet<T>, T>(this->Nodes, &this->Vertices[0], &this->Triangles[0], o, d, 0, maxDistance, 0, out, 0, Bulk) +
+			bvh_traverse<true, soa_scalar<T>, T>(this->Nodes, &this->Vertices[0], &this->Triangles[0], o, d, 0, maxDistance, 0, out, Bulk, orig.size());
+	}
+}//namespace detail
+}//namespace glm
@@ -27,6 +27,7 @@
 ///
 /// @see core (dependence)
 /// @see gtx_closest_point (dependence)
+/// @see gtx_vec_soa (dependence)
 ///
 /// @defgroup gtx_intersect GLM_GTX_intersect
 /// @ingroup gtx
@@ -42,6 +43,7 @@
 // Dependency:
 #include "../glm.hpp"
 #include "../gtx/closest_point.hpp"
+#include "../gtx/vec_soa.hpp"
 
 #if(defined(GLM_MESSAGES) && !defined(glm_ext))
 #	pragma message("GLM: GLM_GTX_closest_point extension included")
@@ -60,6 +62,18 @@ namespace glm
 		genType const & vert0, genType const & vert1, genType const & vert2,
 		genType & baryPosition);
 
+	//! Compute the intersection of count rays, given as structures of
+	//! arrays, and a triangle, 4 (SSE) or 8 (AVX) rays at a time for float.
+	//! baryPosition.z holds the maximum distance of each ray on input;
+	//! baryPosition is only written for the rays hitting the triangle
+	//! closer than that. Returns the number of rays hitting the triangle.
+	//! From GLM_GTX_intersect extension.
+	template <typename T>
+	std::size_t intersectRayTriangle(
+		detail::tvec3soa<T> const & orig, detail::tvec3soa<T> const & dir,
+		detail::tvec3<T> const & vert0, detail::tvec3<T> const & vert1, detail::tvec3<T> const & vert2,
+		detail::tvec3soa<T> & baryPosition);
+
 	//! Compute the intersection of a line and a triangle.
 	//! From GLM_GTX_intersect extension.
 	template <typename genType>
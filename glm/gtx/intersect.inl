@@ -2,16 +2,106 @@
 // OpenGL Mathematics Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Created : 2007-04-03
-// Updated : 2009-01-20
+// Updated : 2016-11-08
 // Licence : This source is under MIT licence
 // File    : glm/gtx/intersect.inl
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <cfloat>
 #include <limits>
+#include <cassert>
 
-namespace glm
+namespace glm{
+namespace detail
 {
+	// Ray triangle test of P::size rays at once, with the same operations
+	// as intersectRayTriangle. Lanes hitting the triangle closer than
+	// Distance get x, y and Distance updated and are returned in the mask.
+	// TwoSided also accepts back facing triangles.
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER typename P::mask soa_intersect_ray_triangle
+	(
+		typename P::type const orig[3], typename P::type const dir[3],
+		tvec3<T> const & v0, tvec3<T> const & v1, tvec3<T> const & v2,
+		typename P::type & x, typename P::type & y, typename P::type & Distance,
+		bool TwoSided
+	)
+	{
+		typedef typename P::type type;
+
+		tvec3<T> const e1 = v1 - v0;
+		tvec3<T> const e2 = v2 - v0;
+		type const e1x = P::set1(e1.x), e1y = P::set1(e1.y), e1z = P::set1(e1.z);
+		type const e2x = P::set1(e2.x), e2y = P::set1(e2.y), e2z = P::set1(e2.z);
+
+		// p = cross(dir, e2)
+		type const px = P::sub(P::mul(dir[1], e2z), P::mul(dir[2], e2y));
+		type const py = P::sub(P::mul(dir[2], e2x), P::mul(dir[0], e2z));
+		type const pz = P::sub(P::mul(dir[0], e2y), P::mul(dir[1], e2x));
+
+		type const a = P::add(P::add(P::mul(e1x, px), P::mul(e1y, py)), P::mul(e1z, pz));
+		type const Epsilon = P::set1(std::numeric_limits<T>::epsilon());
+		type const f = P::div(P::set1(T(1)), a);
+
+		type const sx = P::sub(orig[0], P::set1(v0.x));
+		type const sy = P::sub(orig[1], P::set1(v0.y));
+		type const sz = P::sub(orig[2], P::set1(v0.z));
+		type const u = P::mul(f, P::add(P::add(P::mul(sx, px), P::mul(sy, py)), P::mul(sz, pz)));
+
+		// q = cross(s, e1)
+		type const qx = P::sub(P::mul(sy, e1z), P::mul(sz, e1y));
+		type const qy = P::sub(P::mul(sz, e1x), P::mul(sx, e1z));
+		type const qz = P::sub(P::mul(sx, e1y), P::mul(sy, e1x));
+		type const v = P::mul(f, P::add(P::add(P::mul(dir[0], qx), P::mul(dir[1], qy)), P::mul(dir[2], qz)));
+		type const t = P::mul(f, P::add(P::add(P::mul(e2x, qx), P::mul(e2y, qy)), P::mul(e2z, qz)));
+
+		type const Zero = P::set1(T(0));
+		typename P::mask Hit = P::lessThan(Epsilon, TwoSided ? P::abs(a) : a);
+		Hit = P::mask_and(Hit, P::lessThanEqual(Zero, u));
+		Hit = P::mask_and(Hit, P::lessThanEqual(Zero, v));
+		Hit = P::mask_and(Hit, P::lessThanEqual(P::add(u, v), P::set1(T(1))));
+		Hit = P::mask_and(Hit, P::lessThanEqual(Zero, t));
+		Hit = P::mask_and(Hit, P::lessThan(t, Distance));
+
+		x = P::select(Hit, u, x);
+		y = P::select(Hit, v, y);
+		Distance = P::select(Hit, t, Distance);
+		return Hit;
+	}
+
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER std::size_t soa_intersect_ray_triangle
+	(
+		T const * const orig[3], T const * const dir[3],
+		tvec3<T> const & v0, tvec3<T> const & v1, tvec3<T> const & v2,
+		T * const baryPosition[3], std::size_t First, std::size_t Last
+	)
+	{
+		std::size_t Count = 0;
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			typename P::type o[3], d[3];
+			for(int c = 0; c < 3; ++c)
+			{
+				o[c] = P::load(orig[c] + i);
+				d[c] = P::load(dir[c] + i);
+			}
+			typename P::type x = P::load(baryPosition[0] + i);
+			typename P::type y = P::load(baryPosition[1] + i);
+			typename P::type z = P::load(baryPosition[2] + i);
+			int Hits = P::movemask(soa_intersect_ray_triangle<P>(o, d, v0, v1, v2, x, y, z, false));
+			if(!Hits)
+				continue;
+			P::store(baryPosition[0] + i, x);
+			P::store(baryPosition[1] + i, y);
+			P::store(baryPosition[2] + i, z);
+			for(; Hits; Hits &= Hits - 1)
+				++Count;
+		}
+		return Count;
+	}
+}//namespace detail
+
 	template <typename genType>
 	GLM_FUNC_QUALIFIER bool intersectRayTriangle
 	(
@@ -52,6 +142,29 @@ namespace glm
 		return baryPosition.z >= typename genType::value_type(0.0f);
 	}
 
+	template <typename T>
+	GLM_FUNC_QUALIFIER std::size_t intersectRayTriangle
+	(
+		detail::tvec3soa<T> const & orig, detail::tvec3soa<T> const & dir,
+		detail::tvec3<T> const & vert0, detail::tvec3<T> const & vert1, detail::tvec3<T> const & vert2,
+		detail::tvec3soa<T> & baryPosition
+	)
+	{
+		assert(orig.size() == dir.size() && orig.size() == baryPosition.size());
+
+		T const * o[3], * d[3];
+		T * b[3];
+		detail::soa_streams(orig, o);
+		detail::soa_streams(dir, d);
+		for(int c = 0; c < 3; ++c)
+			b[c] = baryPosition.stream(c);
+
+		std::size_t Bulk = detail::soa_bulk<T>(orig.size());
+		return 
+			detail::soa_intersect_ray_triangle<detail::soa_packet<T> >(o, d, vert0, vert1, vert2, b, 0, Bulk) + 
+			detail::soa_intersect_ray_triangle<detail::soa_scalar<T> >(o, d, vert0, vert1, vert2, b, Bulk, orig.size());
+	}
+
 	//template <typename genType>
 	//GLM_FUNC_QUALIFIER bool intersectRayTriangle
 	//(
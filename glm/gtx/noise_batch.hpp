@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref gtx_noise_batch
+/// @file glm/gtx/noise_batch.hpp
+/// @date 2016-11-07 / 2016-11-07
+/// @author Roberto Cano
+///
+/// @see core (dependence)
+/// @see gtc_noise (dependence)
+/// @see gtx_vec_soa (dependence)
+///
+/// @defgroup gtx_noise_batch GLM_GTX_noise_batch
+/// @ingroup gtx
+/// 
+/// @brief Perlin and simplex noise evaluated over point arrays and grids.
+/// 
+/// Each SIMD lane evaluates one point with the same operations as the
+/// gtc_noise functions, 4 (SSE) or 8 (AVX) points at a time for float.
+/// Grid functions can split their rows across several threads when the
+/// compiler supports C++11 threads, and run on the calling thread otherwise.
+/// 
+/// <glm/gtx/noise_batch.hpp> need to be included to use these functionalities.
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GLM_GTX_noise_batch
+#define GLM_GTX_noise_batch GLM_VERSION
+
+// Dependency:
+#include "../glm.hpp"
+#include "../gtc/noise.hpp"
+#include "../gtx/vec_soa.hpp"
+
+#if((__cplusplus >= 201103L) || ((GLM_COMPILER & GLM_COMPILER_VC) && (GLM_COMPILER >= GLM_COMPILER_VC2012)))
+#	define GLM_NOISE_BATCH_THREADS 1
+#	include <thread>
+#	include <vector>
+#else
+#	define GLM_NOISE_BATCH_THREADS 0
+#endif
+
+#if(defined(GLM_MESSAGES) && !defined(glm_ext))
+#	pragma message("GLM: GLM_GTX_noise_batch extension included")
+#endif
+
+namespace glm
+{
+	/// @addtogroup gtx_noise_batch
+	/// @{
+
+	//! Classic perlin noise of count points.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void perlin(detail::tvec2<T> const * p, T * out, std::size_t count);
+
+	//! Classic perlin noise of count points.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void perlin(detail::tvec3<T> const * p, T * out, std::size_t count);
+
+	//! Simplex noise of count points.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void simplex(detail::tvec2<T> const * p, T * out, std::size_t count);
+
+	//! Simplex noise of count points.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void simplex(detail::tvec3<T> const * p, T * out, std::size_t count);
+
+	//! Fractal sum of perlin noise over a width x height grid: out[y * width + x]
+	//! is the noise at origin + delta * (x, y). Each octave scales the frequency
+	//! by lacunarity and the amplitude by gain. threads = 0 uses every core.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void perlinFbm(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		int octaves, 
+		T const & lacunarity, 
+		T const & gain, 
+		T * out, 
+		std::size_t threads = 1);
+
+	//! Fractal sum of simplex noise over a width x height grid, see perlinFbm.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void simplexFbm(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		int octaves, 
+		T const & lacunarity, 
+		T const & gain, 
+		T * out, 
+		std::size_t threads = 1);
+
+	//! Perlin noise over a width x height grid, perlinFbm with a single octave.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void perlinGrid(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		T * out, 
+		std::size_t threads = 1);
+
+	//! Simplex noise over a width x height grid, simplexFbm with a single octave.
+	//! From GLM_GTX_noise_batch extension.
+	template <typename T> 
+	void simplexGrid(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		T * out, 
+		std::size_t threads = 1);
+
+	/// @}
+}//namespace glm
+
+#include "noise_batch.inl"
+
+#endif//GLM_GTX_noise_batch
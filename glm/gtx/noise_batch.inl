@@ -0,0 +1,561 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2016-11-07
+// Updated : 2016-11-07
+// Licence : This source is under MIT License
+// File    : glm/gtx/noise_batch.inl
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail
+{
+	//////////////////////////////////////
+	// Lane values
+
+	// One noise point per lane, so the kernels below read like gtc_noise
+	template <typename P, typename T>
+	struct noise_value
+	{
+		typename P::type v;
+
+		GLM_FUNC_QUALIFIER noise_value(){}
+		GLM_FUNC_QUALIFIER explicit noise_value(typename P::type const & x) : v(x){}
+	};
+
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator+ (noise_value<P, T> const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::add(a.v, b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator+ (noise_value<P, T> const & a, T const & b){return noise_value<P, T>(P::add(a.v, P::set1(b)));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator- (noise_value<P, T> const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::sub(a.v, b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator- (noise_value<P, T> const & a, T const & b){return noise_value<P, T>(P::sub(a.v, P::set1(b)));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator- (T const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::sub(P::set1(a), b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator- (noise_value<P, T> const & a){return noise_value<P, T>(P::sub(P::set1(T(0)), a.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator* (noise_value<P, T> const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::mul(a.v, b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator* (noise_value<P, T> const & a, T const & b){return noise_value<P, T>(P::mul(a.v, P::set1(b)));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator* (T const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::mul(P::set1(a), b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> operator/ (noise_value<P, T> const & a, T const & b){return noise_value<P, T>(P::div(a.v, P::set1(b)));}
+
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_floor(noise_value<P, T> const & x){return noise_value<P, T>(P::floor(x.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_fract(noise_value<P, T> const & x){return x - noise_floor(x);}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_abs(noise_value<P, T> const & x){return noise_value<P, T>(P::abs(x.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_step(noise_value<P, T> const & edge, noise_value<P, T> const & x){return noise_value<P, T>(P::step(edge.v, x.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_step(noise_value<P, T> const & edge, T const & x){return noise_value<P, T>(P::step(edge.v, P::set1(x)));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_step(T const & edge, noise_value<P, T> const & x){return noise_value<P, T>(P::step(P::set1(edge), x.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_min(noise_value<P, T> const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::min(a.v, b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_max(noise_value<P, T> const & a, noise_value<P, T> const & b){return noise_value<P, T>(P::max(a.v, b.v));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_max(noise_value<P, T> const & a, T const & b){return noise_value<P, T>(P::max(a.v, P::set1(b)));}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_mix(noise_value<P, T> const & x, noise_value<P, T> const & y, noise_value<P, T> const & a){return x + a * (y - x);}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_mod(noise_value<P, T> const & x, T const & y){return x - y * noise_floor(x / y);}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_mod289(noise_value<P, T> const & x){return x - noise_floor(x * T(1.0 / 289.0)) * T(289.0);}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_permute(noise_value<P, T> const & x){return noise_mod289(((x * T(34)) + T(1)) * x);}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_taylorInvSqrt(noise_value<P, T> const & r){return T(1.79284291400159) - T(0.85373472095314) * r;}
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER noise_value<P, T> noise_fade(noise_value<P, T> const & t){return t * t * t * (t * (t * T(6) - T(15)) + T(10));}
+
+	//////////////////////////////////////
+	// Kernels, one lane per point, same operations as gtc_noise
+
+	struct noise_perlin
+	{
+		// Contribution of one of the 4 corners around a 2D point
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> corner(
+			noise_value<P, T> const & ix, noise_value<P, T> const & iy, 
+			noise_value<P, T> const & fx, noise_value<P, T> const & fy)
+		{
+			noise_value<P, T> i = noise_permute(noise_permute(ix) + iy);
+
+			noise_value<P, T> gx = T(2) * noise_fract(i / T(41)) - T(1);
+			noise_value<P, T> gy = noise_abs(gx) - T(0.5);
+			noise_value<P, T> tx = noise_floor(gx + T(0.5));
+			gx = gx - tx;
+
+			noise_value<P, T> norm = noise_taylorInvSqrt(gx * gx + gy * gy);
+			gx = gx * norm;
+			gy = gy * norm;
+
+			return gx * fx + gy * fy;
+		}
+
+		// Contribution of one of the 8 corners around a 3D point, ixy being
+		// the hash of the corner x and y
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> corner(
+			noise_value<P, T> const & ixy, noise_value<P, T> const & iz, 
+			noise_value<P, T> const & fx, noise_value<P, T> const & fy, noise_value<P, T> const & fz)
+		{
+			noise_value<P, T> ixyz = noise_permute(ixy + iz);
+
+			noise_value<P, T> gx = ixyz * T(1.0 / 7.0);
+			noise_value<P, T> gy = noise_fract(noise_floor(gx) * T(1.0 / 7.0)) - T(0.5);
+			gx = noise_fract(gx);
+			noise_value<P, T> gz = T(0.5) - noise_abs(gx) - noise_abs(gy);
+			noise_value<P, T> sz = noise_step(gz, T(0.0));
+			gx = gx - sz * (noise_step(T(0), gx) - T(0.5));
+			gy = gy - sz * (noise_step(T(0), gy) - T(0.5));
+
+			noise_value<P, T> norm = noise_taylorInvSqrt(gx * gx + gy * gy + gz * gz);
+			gx = gx * norm;
+			gy = gy * norm;
+			gz = gz * norm;
+
+			return gx * fx + gy * fy + gz * fz;
+		}
+
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> call(noise_value<P, T> const & x, noise_value<P, T> const & y)
+		{
+			noise_value<P, T> Fx = noise_floor(x);
+			noise_value<P, T> Fy = noise_floor(y);
+			noise_value<P, T> ix0 = noise_mod(Fx, T(289));
+			noise_value<P, T> iy0 = noise_mod(Fy, T(289));
+			noise_value<P, T> ix1 = noise_mod(Fx + T(1), T(289));
+			noise_value<P, T> iy1 = noise_mod(Fy + T(1), T(289));
+			noise_value<P, T> fx0 = noise_fract(x);
+			noise_value<P, T> fy0 = noise_fract(y);
+			noise_value<P, T> fx1 = fx0 - T(1);
+			noise_value<P, T> fy1 = fy0 - T(1);
+
+			noise_value<P, T> n00 = corner(ix0, iy0, fx0, fy0);
+			noise_value<P, T> n10 = corner(ix1, iy0, fx1, fy0);
+			noise_value<P, T> n01 = corner(ix0, iy1, fx0, fy1);
+			noise_value<P, T> n11 = corner(ix1, iy1, fx1, fy1);
+
+			noise_value<P, T> fade_x = noise_fade(fx0);
+			noise_value<P, T> fade_y = noise_fade(fy0);
+			noise_value<P, T> n_x0 = noise_mix(n00, n10, fade_x);
+			noise_value<P, T> n_x1 = noise_mix(n01, n11, fade_x);
+			return T(2.3) * noise_mix(n_x0, n_x1, fade_y);
+		}
+
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> call(noise_value<P, T> const & x, noise_value<P, T> const & y, noise_value<P, T> const & z)
+		{
+			noise_value<P, T> ix0 = noise_mod289(noise_floor(x));
+			noise_value<P, T> iy0 = noise_mod289(noise_floor(y));
+			noise_value<P, T> iz0 = noise_mod289(noise_floor(z));
+			noise_value<P, T> ix1 = noise_mod289(noise_floor(x) + T(1));
+			noise_value<P, T> iy1 = noise_mod289(noise_floor(y) + T(1));
+			noise_value<P, T> iz1 = noise_mod289(noise_floor(z) + T(1));
+			noise_value<P, T> fx0 = noise_fract(x);
+			noise_value<P, T> fy0 = noise_fract(y);
+			noise_value<P, T> fz0 = noise_fract(z);
+			noise_value<P, T> fx1 = fx0 - T(1);
+			noise_value<P, T> fy1 = fy0 - T(1);
+			noise_value<P, T> fz1 = fz0 - T(1);
+
+			noise_value<P, T> ixy00 = noise_permute(noise_permute(ix0) + iy0);
+			noise_value<P, T> ixy10 = noise_permute(noise_permute(ix1) + iy0);
+			noise_value<P, T> ixy01 = noise_permute(noise_permute(ix0) + iy1);
+			noise_value<P, T> ixy11 = noise_permute(noise_permute(ix1) + iy1);
+
+			noise_value<P, T> n000 = corner(ixy00, iz0, fx0, fy0, fz0);
+			noise_value<P, T> n100 = corner(ixy10, iz0, fx1, fy0, fz0);
+			noise_value<P, T> n010 = corner(ixy01, iz0, fx0, fy1, fz0);
+			noise_value<P, T> n110 = corner(ixy11, iz0, fx1, fy1, fz0);
+			noise_value<P, T> n001 = corner(ixy00, iz1, fx0, fy0, fz1);
+			noise_value<P, T> n101 = corner(ixy10, iz1, fx1, fy0, fz1);
+			noise_value<P, T> n011 = corner(ixy01, iz1, fx0, fy1, fz1);
+			noise_value<P, T> n111 = corner(ixy11, iz1, fx1, fy1, fz1);
+
+			noise_value<P, T> fade_x = noise_fade(fx0);
+			noise_value<P, T> fade_y = noise_fade(fy0);
+			noise_value<P, T> fade_z = noise_fade(fz0);
+			noise_value<P, T> n_z00 = noise_mix(n000, n001, fade_z);
+			noise_value<P, T> n_z10 = noise_mix(n100, n101, fade_z);
+			noise_value<P, T> n_z01 = noise_mix(n010, n011, fade_z);
+			noise_value<P, T> n_z11 = noise_mix(n110, n111, fade_z);
+			noise_value<P, T> n_yz0 = noise_mix(n_z00, n_z01, fade_y);
+			noise_value<P, T> n_yz1 = noise_mix(n_z10, n_z11, fade_y);
+			return T(2.2) * noise_mix(n_yz0, n_yz1, fade_x);
+		}
+	};
+
+	struct noise_simplex
+	{
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> call(noise_value<P, T> const & x, noise_value<P, T> const & y)
+		{
+			T const Cx = T( 0.211324865405187);  // (3.0 -  sqrt(3.0)) / 6.0
+			T const Cy = T( 0.366025403784439);  //  0.5 * (sqrt(3.0)  - 1.0)
+			T const Cz = T(-0.577350269189626);  // -1.0 + 2.0 * C.x
+			T const Cw = T( 0.024390243902439);  //  1.0 / 41.0
+
+			// First corner
+			noise_value<P, T> s = x * Cy + y * Cy;
+			noise_value<P, T> ix = noise_floor(x + s);
+			noise_value<P, T> iy = noise_floor(y + s);
+			noise_value<P, T> t = ix * Cx + iy * Cx;
+			noise_value<P, T> x0 = x - ix + t;
+			noise_value<P, T> y0 = y - iy + t;
+
+			// Other corners, i1 = x0 > y0 ? (1, 0) : (0, 1)
+			noise_value<P, T> i1x = T(1) - noise_step(x0, y0);
+			noise_value<P, T> i1y = T(1) - i1x;
+			noise_value<P, T> x1 = x0 + Cx - i1x;
+			noise_value<P, T> y1 = y0 + Cx - i1y;
+			noise_value<P, T> x2 = x0 + Cz;
+			noise_value<P, T> y2 = y0 + Cz;
+
+			// Permutations
+			ix = noise_mod(ix, T(289));
+			iy = noise_mod(iy, T(289));
+			noise_value<P, T> p0 = noise_permute(noise_permute(iy) + ix);
+			noise_value<P, T> p1 = noise_permute(noise_permute(iy + i1y) + ix + i1x);
+			noise_value<P, T> p2 = noise_permute(noise_permute(iy + T(1)) + ix + T(1));
+
+			noise_value<P, T> m0 = noise_max(T(0.5) - (x0 * x0 + y0 * y0), T(0));
+			noise_value<P, T> m1 = noise_max(T(0.5) - (x1 * x1 + y1 * y1), T(0));
+			noise_value<P, T> m2 = noise_max(T(0.5) - (x2 * x2 + y2 * y2), T(0));
+			m0 = m0 * m0; m0 = m0 * m0;
+			m1 = m1 * m1; m1 = m1 * m1;
+			m2 = m2 * m2; m2 = m2 * m2;
+
+			return T(130) * (gradient(p0, x0, y0, m0, Cw) + gradient(p1, x1, y1, m1, Cw) + gradient(p2, x2, y2, m2, Cw));
+		}
+
+		// Gradient of a 2D corner: 41 points over a line, mapped onto a diamond
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> gradient(
+			noise_value<P, T> const & p, noise_value<P, T> const & x0, noise_value<P, T> const & y0, 
+			noise_value<P, T> const & m, T const & Cw)
+		{
+			noise_value<P, T> x = T(2) * noise_fract(p * Cw) - T(1);
+			noise_value<P, T> h = noise_abs(x) - T(0.5);
+			noise_value<P, T> ox = noise_floor(x + T(0.5));
+			noise_value<P, T> a0 = x - ox;
+
+			noise_value<P, T> Scaled = m * (T(1.79284291400159) - T(0.85373472095314) * (a0 * a0 + h * h));
+			return Scaled * (a0 * x0 + h * y0);
+		}
+
+		// Contribution of a 3D corner, p being the hash of the corner
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> corner(
+			noise_value<P, T> const & p, 
+			noise_value<P, T> const & x0, noise_value<P, T> const & y0, noise_value<P, T> const & z0)
+		{
+			// Gradients: 7x7 points over a square, mapped onto an octahedron.
+			T const n_ = T(0.142857142857); // 1.0/7.0
+			T const nsx = n_ * T(2.0) - T(0.0);
+			T const nsy = n_ * T(0.5) - T(1.0);
+			T const nsz = n_ * T(1.0) - T(0.0);
+
+			noise_value<P, T> j = p - T(49) * noise_floor(p * nsz * nsz);  //  mod(p,7*7)
+
+			noise_value<P, T> x_ = noise_floor(j * nsz);
+			noise_value<P, T> y_ = noise_floor(j - T(7) * x_);    // mod(j,N)
+
+			noise_value<P, T> x = x_ * nsx + nsy;
+			noise_value<P, T> y = y_ * nsx + nsy;
+			noise_value<P, T> h = T(1) - noise_abs(x) - noise_abs(y);
+
+			noise_value<P, T> sx = noise_floor(x) * T(2) + T(1);
+			noise_value<P, T> sy = noise_floor(y) * T(2) + T(1);
+			noise_value<P, T> sh = -noise_step(h, T(0.0));
+
+			noise_value<P, T> gx = x + sx * sh;
+			noise_value<P, T> gy = y + sy * sh;
+			noise_value<P, T> gz = h;
+
+			// Normalise gradients
+			noise_value<P, T> norm = noise_taylorInvSqrt(gx * gx + gy * gy + gz * gz);
+			gx = gx * norm;
+			gy = gy * norm;
+			gz = gz * norm;
+
+			noise_value<P, T> m = noise_max(T(0.6) - (x0 * x0 + y0 * y0 + z0 * z0), T(0));
+			m = m * m;
+			return m * m * (gx * x0 + gy * y0 + gz * z0);
+		}
+
+		template <typename P, typename T>
+		static GLM_FUNC_QUALIFIER noise_value<P, T> call(noise_value<P, T> const & x, noise_value<P, T> const & y, noise_value<P, T> const & z)
+		{
+			T const Cx = T(1.0 / 6.0);
+			T const Cy = T(1.0 / 3.0);
+
+			// First corner
+			noise_value<P, T> s = x * Cy + y * Cy + z * Cy;
+			noise_value<P, T> ix = noise_floor(x + s);
+			noise_value<P, T> iy = noise_floor(y + s);
+			noise_value<P, T> iz = noise_floor(z + s);
+			noise_value<P, T> t = ix * Cx + iy * Cx + iz * Cx;
+			noise_value<P, T> x0 = x - ix + t;
+			noise_value<P, T> y0 = y - iy + t;
+			noise_value<P, T> z0 = z - iz + t;
+
+			// Other corners
+			noise_value<P, T> gx = noise_step(y0, x0);
+			noise_value<P, T> gy = noise_step(z0, y0);
+			noise_value<P, T> gz = noise_step(x0, z0);
+			noise_value<P, T> lx = T(1) - gx;
+			noise_value<P, T> ly = T(1) - gy;
+			noise_value<P, T> lz = T(1) - gz;
+			noise_value<P, T> i1x = noise_min(gx, lz);
+			noise_value<P, T> i1y = noise_min(gy, lx);
+			noise_value<P, T> i1z = noise_min(gz, ly);
+			noise_value<P, T> i2x = noise_max(gx, lz);
+			noise_value<P, T> i2y = noise_max(gy, lx);
+			noise_value<P, T> i2z = noise_max(gz, ly);
+
+			noise_value<P, T> x1 = x0 - i1x + Cx;
+			noise_value<P, T> y1 = y0 - i1y + Cx;
+			noise_value<P, T> z1 = z0 - i1z + Cx;
+			noise_value<P, T> x2 = x0 - i2x + Cy;
+			noise_value<P, T> y2 = y0 - i2y + Cy;
+			noise_value<P, T> z2 = z0 - i2z + Cy;
+			noise_value<P, T> x3 = x0 - T(0.5);
+			noise_value<P, T> y3 = y0 - T(0.5);
+			noise_value<P, T> z3 = z0 - T(0.5);
+
+			// Permutations
+			ix = noise_mod289(ix);
+			iy = noise_mod289(iy);
+			iz = noise_mod289(iz);
+			noise_value<P, T> p0 = noise_permute(noise_permute(noise_permute(iz) + iy) + ix);
+			noise_value<P, T> p1 = noise_permute(noise_permute(noise_permute(iz + i1z) + iy + i1y) + ix + i1x);
+			noise_value<P, T> p2 = noise_permute(noise_permute(noise_permute(iz + i2z) + iy + i2y) + ix + i2x);
+			noise_value<P, T> p3 = noise_permute(noise_permute(noise_permute(iz + T(1)) + iy + T(1)) + ix + T(1));
+
+			// Mix final noise value
+			return T(42) * (
+				corner(p0, x0, y0, z0) + 
+				corner(p1, x1, y1, z1) + 
+				corner(p2, x2, y2, z2) + 
+				corner(p3, x3, y3, z3));
+		}
+	};
+
+	//////////////////////////////////////
+	// Drivers
+
+	template <typename K, typename P, typename T>
+	GLM_FUNC_QUALIFIER void noise_points(tvec2<T> const * p, T * out, std::size_t First, std::size_t Last)
+	{
+		T X[P::size];
+		T Y[P::size];
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			for(std::size_t l = 0; l < std::size_t(P::size); ++l)
+			{
+				X[l] = p[i + l].x;
+				Y[l] = p[i + l].y;
+			}
+			noise_value<P, T> Result = K::call(noise_value<P, T>(P::loadu(X)), noise_value<P, T>(P::loadu(Y)));
+			P::storeu(out + i, Result.v);
+		}
+	}
+
+	template <typename K, typename P, typename T>
+	GLM_FUNC_QUALIFIER void noise_points(tvec3<T> const * p, T * out, std::size_t First, std::size_t Last)
+	{
+		T X[P::size];
+		T Y[P::size];
+		T Z[P::size];
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			for(std::size_t l = 0; l < std::size_t(P::size); ++l)
+			{
+				X[l] = p[i + l].x;
+				Y[l] = p[i + l].y;
+				Z[l] = p[i + l].z;
+			}
+			noise_value<P, T> Result = K::call(noise_value<P, T>(P::loadu(X)), noise_value<P, T>(P::loadu(Y)), noise_value<P, T>(P::loadu(Z)));
+			P::storeu(out + i, Result.v);
+		}
+	}
+
+	template <typename K, typename T, template <typename> class vecType>
+	GLM_FUNC_QUALIFIER void noise_points(vecType<T> const * p, T * out, std::size_t count)
+	{
+		std::size_t Bulk = soa_bulk<T>(count);
+		noise_points<K, soa_packet<T> >(p, out, 0, Bulk);
+		noise_points<K, soa_scalar<T> >(p, out, Bulk, count);
+	}
+
+	template <typename K, typename P, typename T>
+	GLM_FUNC_QUALIFIER void noise_fbm_row(
+		tvec2<T> const & origin, tvec2<T> const & delta, std::size_t row, 
+		int octaves, T const & lacunarity, T const & gain, 
+		T * out, std::size_t First, std::size_t Last)
+	{
+		noise_value<P, T> const Y(P::set1(origin.y + delta.y * T(row)));
+
+		T X[P::size];
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			for(std::size_t l = 0; l < std::size_t(P::size); ++l)
+				X[l] = origin.x + delta.x * T(i + l);
+
+			noise_value<P, T> const x(P::loadu(X));
+			noise_value<P, T> Sum(P::set1(T(0)));
+			T Frequency(1);
+			T Amplitude(1);
+			for(int o = 0; o < octaves; ++o)
+			{
+				Sum = Sum + K::call(x * Frequency, Y * Frequency) * Amplitude;
+				Frequency *= lacunarity;
+				Amplitude *= gain;
+			}
+			P::storeu(out + i, Sum.v);
+		}
+	}
+
+	template <typename K, typename T>
+	GLM_FUNC_QUALIFIER void noise_fbm_rows(
+		tvec2<T> const & origin, tvec2<T> const & delta, std::size_t width, 
+		int octaves, T const & lacunarity, T const & gain, 
+		T * out, std::size_t FirstRow, std::size_t LastRow)
+	{
+		std::size_t Bulk = soa_bulk<T>(width);
+		for(std::size_t row = FirstRow; row < LastRow; ++row)
+		{
+			noise_fbm_row<K, soa_packet<T> >(origin, delta, row, octaves, lacunarity, gain, out + row * width, 0, Bulk);
+			noise_fbm_row<K, soa_scalar<T> >(origin, delta, row, octaves, lacunarity, gain, out + row * width, Bulk, width);
+		}
+	}
+
+	// Splits the rows in one contiguous band per thread, the calling thread
+	// taking the first one
+	template <typename K, typename T>
+	GLM_FUNC_QUALIFIER void noise_fbm(
+		tvec2<T> const & origin, tvec2<T> const & delta, std::size_t width, std::size_t height, 
+		int octaves, T const & lacunarity, T const & gain, 
+		T * out, std::size_t threads)
+	{
+#		if(GLM_NOISE_BATCH_THREADS)
+			if(threads == 0)
+				threads = std::size_t(std::thread::hardware_concurrency());
+			if(threads > height)
+				threads = height;
+			if(threads > 1)
+			{
+				std::size_t const Band = (height + threads - 1) / threads;
+				std::vector<std::thread> Workers;
+				Workers.reserve(threads - 1);
+				for(std::size_t First = Band; First < height; First += Band)
+				{
+					std::size_t Last = First + Band < height ? First + Band : height;
+					Workers.push_back(std::thread(&noise_fbm_rows<K, T>, origin, delta, width, octaves, lacunarity, gain, out, First, Last));
+				}
+				noise_fbm_rows<K, T>(origin, delta, width, octaves, lacunarity, gain, out, 0, Band);
+				for(std::size_t i = 0; i < Workers.size(); ++i)
+					Workers[i].join();
+				return;
+			}
+#		endif
+		noise_fbm_rows<K, T>(origin, delta, width, octaves, lacunarity, gain, out, 0, height);
+	}
+}//namespace detail
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void perlin(detail::tvec2<T> const * p, T * out, std::size_t count)
+	{
+		detail::noise_points<detail::noise_perlin>(p, out, count);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void perlin(detail::tvec3<T> const * p, T * out, std::size_t count)
+	{
+		detail::noise_points<detail::noise_perlin>(p, out, count);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void simplex(detail::tvec2<T> const * p, T * out, std::size_t count)
+	{
+		detail::noise_points<detail::noise_simplex>(p, out, count);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void simplex(detail::tvec3<T> const * p, T * out, std::size_t count)
+	{
+		detail::noise_points<detail::noise_simplex>(p, out, count);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void perlinFbm
+	(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		int octaves, 
+		T const & lacunarity, 
+		T const & gain, 
+		T * out, 
+		std::size_t threads
+	)
+	{
+		detail::noise_fbm<detail::noise_perlin>(origin, delta, width, height, octaves, lacunarity, gain, out, threads);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void simplexFbm
+	(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		int octaves, 
+		T const & lacunarity, 
+		T const & gain, 
+		T * out, 
+		std::size_t threads
+	)
+	{
+		detail::noise_fbm<detail::noise_simplex>(origin, delta, width, height, octaves, lacunarity, gain, out, threads);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void perlinGrid
+	(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		T * out, 
+		std::size_t threads
+	)
+	{
+		detail::noise_fbm<detail::noise_perlin>(origin, delta, width, height, 1, T(1), T(1), out, threads);
+	}
+
+	template <typename T> 
+	GLM_FUNC_QUALIFIER void simplexGrid
+	(
+		detail::tvec2<T> const & origin, 
+		detail::tvec2<T> const & delta, 
+		std::size_t width, 
+		std::size_t height, 
+		T * out, 
+		std::size_t threads
+	)
+	{
+		detail::noise_fbm<detail::noise_simplex>(origin, delta, width, height, 1, T(1), T(1), out, threads);
+	}
+
+}//namespace glm
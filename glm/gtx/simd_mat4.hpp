@@ -45,6 +45,7 @@
 
 #if(GLM_ARCH & GLM_ARCH_SSE2)
 #	include "../core/intrinsic_matrix.hpp"
+#	include "../core/intrinsic_matrix_avx.hpp"
 #	include "../gtx/simd_vec4.hpp"
 #else
 #	error "GLM: GLM_GTX_simd_mat4 requires compiler support of SSE2 through intrinsics"
@@ -196,6 +197,41 @@ namespace detail
 	detail::fmat4x4SIMD inverse(
 		detail::fmat4x4SIMD const & m);
 
+	//! Multiply two pairs of matrices at once: r1 = a1 * b1 and r2 = a2 * b2.
+	//! Both products share 256 bits registers when AVX2 is available.
+	//! (From GLM_GTX_simd_mat4 extension).
+	void multiply2(
+		detail::fmat4x4SIMD const & a1,
+		detail::fmat4x4SIMD const & b1,
+		detail::fmat4x4SIMD const & a2,
+		detail::fmat4x4SIMD const & b2,
+		detail::fmat4x4SIMD & r1,
+		detail::fmat4x4SIMD & r2);
+
+	//! Transform two vectors by two matrices at once: r1 = m1 * v1 and r2 = m2 * v2.
+	//! (From GLM_GTX_simd_mat4 extension).
+	void multiply2(
+		detail::fmat4x4SIMD const & m1,
+		detail::fvec4SIMD const & v1,
+		detail::fmat4x4SIMD const & m2,
+		detail::fvec4SIMD const & v2,
+		detail::fvec4SIMD & r1,
+		detail::fvec4SIMD & r2);
+
+	//! Return the determinants of two mat4 matrices computed at once.
+	//! (From GLM_GTX_simd_mat4 extension).
+	detail::tvec2<float> determinant2(
+		detail::fmat4x4SIMD const & m1,
+		detail::fmat4x4SIMD const & m2);
+
+	//! Return the inverses of two mat4 matrices computed at once.
+	//! (From GLM_GTX_simd_mat4 extension).
+	void inverse2(
+		detail::fmat4x4SIMD const & m1,
+		detail::fmat4x4SIMD const & m2,
+		detail::fmat4x4SIMD & r1,
+		detail::fmat4x4SIMD & r2);
+
 	/// @}
 }// namespace glm
 
@@ -10,6 +10,63 @@
 namespace glm{
 namespace detail{
 
+//////////////////////////////////////
+// Instruction set selection
+
+// The AVX2 versions are used when GLM_ARCH enables them, or at runtime when
+// built with GLM_FORCE_RUNTIME_DISPATCH and the CPU supports them.
+
+GLM_FUNC_QUALIFIER void simd_mul_ps(__m128 const in1[4], __m128 const in2[4], __m128 out[4])
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+	{
+		avx_mul_ps(in1, in2, out);
+		return;
+	}
+#endif
+	sse_mul_ps(in1, in2, out);
+}
+
+GLM_FUNC_QUALIFIER __m128 simd_mul_ps(__m128 const m[4], __m128 v)
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+		return avx_mul_ps(m, v);
+#endif
+	return sse_mul_ps(m, v);
+}
+
+GLM_FUNC_QUALIFIER __m128 simd_mul_ps(__m128 v, __m128 const m[4])
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+		return avx_mul_ps(v, m);
+#endif
+	return sse_mul_ps(v, m);
+}
+
+GLM_FUNC_QUALIFIER __m128 simd_det_ps(__m128 const m[4])
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+		return avx_det_ps(m);
+#endif
+	return sse_det_ps(m);
+}
+
+GLM_FUNC_QUALIFIER void simd_inverse_ps(__m128 const in[4], __m128 out[4])
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+	{
+		avx_inverse_ps(in, out);
+		return;
+	}
+#endif
+	sse_inverse_ps(in, out);
+}
+
 GLM_FUNC_QUALIFIER fmat4x4SIMD::size_type fmat4x4SIMD::value_size()
 {
 	return sizeof(value_type);
@@ -165,7 +222,7 @@ GLM_FUNC_QUALIFIER fmat4x4SIMD & fmat4x4SIMD::operator*=
 	fmat4x4SIMD const & m
 )
 {
-	sse_mul_ps(&this->Data[0].Data, &m.Data[0].Data, &this->Data[0].Data);
+	simd_mul_ps(&this->Data[0].Data, &m.Data[0].Data, &this->Data[0].Data);
     return *this;
 }
 
@@ -175,8 +232,8 @@ GLM_FUNC_QUALIFIER fmat4x4SIMD & fmat4x4SIMD::operator/=
 )
 {
 	__m128 Inv[4];
-	sse_inverse_ps(&m.Data[0].Data, Inv);
-	sse_mul_ps(&this->Data[0].Data, Inv, &this->Data[0].Data);
+	simd_inverse_ps(&m.Data[0].Data, Inv);
+	simd_mul_ps(&this->Data[0].Data, Inv, &this->Data[0].Data);
     return *this;
 }
 
@@ -382,7 +439,7 @@ GLM_FUNC_QUALIFIER fvec4SIMD operator*
     fvec4SIMD const & v
 )
 {
-    return sse_mul_ps(&m.Data[0].Data, v.Data);
+    return simd_mul_ps(&m.Data[0].Data, v.Data);
 }
 
 GLM_FUNC_QUALIFIER fvec4SIMD operator*
@@ -391,7 +448,7 @@ GLM_FUNC_QUALIFIER fvec4SIMD operator*
     const fmat4x4SIMD &m
 )
 {
-    return sse_mul_ps(v.Data, &m.Data[0].Data);
+    return simd_mul_ps(v.Data, &m.Data[0].Data);
 }
 
 GLM_FUNC_QUALIFIER fmat4x4SIMD operator*
@@ -401,7 +458,7 @@ GLM_FUNC_QUALIFIER fmat4x4SIMD operator*
 )
 {
     fmat4x4SIMD result;
-    sse_mul_ps(&m1.Data[0].Data, &m2.Data[0].Data, &result.Data[0].Data);
+    simd_mul_ps(&m1.Data[0].Data, &m2.Data[0].Data, &result.Data[0].Data);
     
     return result;
 }
@@ -465,8 +522,8 @@ GLM_FUNC_QUALIFIER fmat4x4SIMD operator/
     __m128 result[4];
     __m128 inv[4];
 
-	sse_inverse_ps(&m2.Data[0].Data, inv);
-	sse_mul_ps(&m1.Data[0].Data, inv, result);
+	simd_inverse_ps(&m2.Data[0].Data, inv);
+	simd_mul_ps(&m1.Data[0].Data, inv, result);
 
     return fmat4x4SIMD(result);
 }
@@ -576,15 +633,100 @@ GLM_FUNC_QUALIFIER detail::fmat4x4SIMD transpose(detail::fmat4x4SIMD const & m)
 GLM_FUNC_QUALIFIER float determinant(detail::fmat4x4SIMD const & m)
 {
 	float Result;
-	_mm_store_ss(&Result, detail::sse_det_ps(&m[0].Data));
+	_mm_store_ss(&Result, detail::simd_det_ps(&m[0].Data));
 	return Result;
 }
 
 GLM_FUNC_QUALIFIER detail::fmat4x4SIMD inverse(detail::fmat4x4SIMD const & m)
 {
 	detail::fmat4x4SIMD result;
-	detail::sse_inverse_ps(&m[0].Data, &result[0].Data);
+	detail::simd_inverse_ps(&m[0].Data, &result[0].Data);
 	return result;
 }
 
+GLM_FUNC_QUALIFIER void multiply2
+(
+	detail::fmat4x4SIMD const & a1,
+	detail::fmat4x4SIMD const & b1,
+	detail::fmat4x4SIMD const & a2,
+	detail::fmat4x4SIMD const & b2,
+	detail::fmat4x4SIMD & r1,
+	detail::fmat4x4SIMD & r2
+)
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+	{
+		detail::avx_mul2_ps(&a1[0].Data, &b1[0].Data, &a2[0].Data, &b2[0].Data, &r1[0].Data, &r2[0].Data);
+		return;
+	}
+#endif
+	detail::sse_mul_ps(&a1[0].Data, &b1[0].Data, &r1[0].Data);
+	detail::sse_mul_ps(&a2[0].Data, &b2[0].Data, &r2[0].Data);
+}
+
+GLM_FUNC_QUALIFIER void multiply2
+(
+	detail::fmat4x4SIMD const & m1,
+	detail::fvec4SIMD const & v1,
+	detail::fmat4x4SIMD const & m2,
+	detail::fvec4SIMD const & v2,
+	detail::fvec4SIMD & r1,
+	detail::fvec4SIMD & r2
+)
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+	{
+		__m128 r[2];
+		detail::avx_mul2_ps(&m1[0].Data, v1.Data, &m2[0].Data, v2.Data, r);
+		r1.Data = r[0];
+		r2.Data = r[1];
+		return;
+	}
+#endif
+	r1.Data = detail::sse_mul_ps(&m1[0].Data, v1.Data);
+	r2.Data = detail::sse_mul_ps(&m2[0].Data, v2.Data);
+}
+
+GLM_FUNC_QUALIFIER detail::tvec2<float> determinant2
+(
+	detail::fmat4x4SIMD const & m1,
+	detail::fmat4x4SIMD const & m2
+)
+{
+	detail::tvec2<float> Result;
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+	{
+		__m128 Det = detail::avx_det2_ps(&m1[0].Data, &m2[0].Data);
+		_mm_store_ss(&Result.x, Det);
+		_mm_store_ss(&Result.y, _mm_shuffle_ps(Det, Det, _MM_SHUFFLE(1, 1, 1, 1)));
+		return Result;
+	}
+#endif
+	_mm_store_ss(&Result.x, detail::sse_det_ps(&m1[0].Data));
+	_mm_store_ss(&Result.y, detail::sse_det_ps(&m2[0].Data));
+	return Result;
+}
+
+GLM_FUNC_QUALIFIER void inverse2
+(
+	detail::fmat4x4SIMD const & m1,
+	detail::fmat4x4SIMD const & m2,
+	detail::fmat4x4SIMD & r1,
+	detail::fmat4x4SIMD & r2
+)
+{
+#if(GLM_HAS_AVX2_PATH)
+	if(GLM_DISPATCH_AVX2)
+	{
+		detail::avx_inverse2_ps(&m1[0].Data, &m2[0].Data, &r1[0].Data, &r2[0].Data);
+		return;
+	}
+#endif
+	detail::sse_inverse_ps(&m1[0].Data, &r1[0].Data);
+	detail::sse_inverse_ps(&m2[0].Data, &r2[0].Data);
+}
+
 }//namespace glm
@@ -0,0 +1,274 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+/// 
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+/// 
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @ref gtx_vec_soa
+/// @file glm/gtx/vec_soa.hpp
+/// @date 2016-11-05 / 2016-11-05
+/// @author Roberto Cano
+///
+/// @see core (dependence)
+///
+/// @defgroup gtx_vec_soa GLM_GTX_vec_soa
+/// @ingroup gtx
+/// 
+/// @brief Structure of arrays containers for vec3 and vec4 with batch operations.
+/// 
+/// Components are stored in separate 32 bytes aligned streams (xxxx, yyyy,
+/// zzzz) so the batch functions process 4 (SSE) or 8 (AVX) vectors per
+/// instruction when the value type is float.
+/// 
+/// <glm/gtx/vec_soa.hpp> need to be included to use these functionalities.
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GLM_GTX_vec_soa
+#define GLM_GTX_vec_soa GLM_VERSION
+
+// Dependency:
+#include "../glm.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#if(GLM_ARCH & GLM_ARCH_SSE2)
+#	include "../core/intrinsic_common.hpp"
+#endif
+
+#if(defined(GLM_MESSAGES) && !defined(glm_ext))
+#	pragma message("GLM: GLM_GTX_vec_soa extension included")
+#endif
+
+namespace glm{
+namespace detail
+{
+	/// Aligned storage shared by the structure of arrays containers: L
+	/// streams of capacity() values each, every stream 32 bytes aligned.
+	template <typename T, std::size_t L>
+	class tsoa_storage
+	{
+	public:
+		typedef T value_type;
+		typedef std::size_t size_type;
+
+		enum{alignment = 32};
+
+		tsoa_storage();
+		tsoa_storage(tsoa_storage<T, L> const & s);
+		~tsoa_storage();
+
+		tsoa_storage<T, L> & operator= (tsoa_storage<T, L> const & s);
+
+		size_type size() const;
+		size_type capacity() const;
+		bool empty() const;
+
+		void reserve(size_type count);
+		void resize(size_type count);
+		void clear();
+
+		//! Stream of the i-th component
+		T * stream(size_type i);
+		T const * stream(size_type i) const;
+
+		//! Size rounded up to a multiple of 8. Values between size() and
+		//! padded_size() are always zero, so custom kernels can work on
+		//! whole registers without a scalar tail.
+		size_type padded_size() const;
+
+	private:
+		void * Memory;
+		T * Data;
+		size_type Size;
+		size_type Capacity;
+	};
+
+	/// Structure of arrays container of 3 components vectors.
+	/// \ingroup gtx_vec_soa
+	template <typename T>
+	class tvec3soa : public tsoa_storage<T, 3>
+	{
+	public:
+		typedef tvec3<T> vector_type;
+		typedef typename tsoa_storage<T, 3>::size_type size_type;
+
+		tvec3soa();
+		explicit tvec3soa(size_type count);
+		tvec3soa(tvec3<T> const * data, size_type count);
+
+		T * x();
+		T * y();
+		T * z();
+		T const * x() const;
+		T const * y() const;
+		T const * z() const;
+
+		//! Gather the i-th vector
+		tvec3<T> operator[](size_type i) const;
+
+		//! Scatter v as the i-th vector
+		void set(size_type i, tvec3<T> const & v);
+		void push_back(tvec3<T> const & v);
+
+		//! Replace the content with count vectors in array of structures layout
+		void assign(tvec3<T> const * data, size_type count);
+
+		//! Write the content back in array of structures layout
+		void copy(tvec3<T> * data) const;
+	};
+
+	/// Structure of arrays container of 4 components vectors.
+	/// \ingroup gtx_vec_soa
+	template <typename T>
+	class tvec4soa : public tsoa_storage<T, 4>
+	{
+	public:
+		typedef tvec4<T> vector_type;
+		typedef typename tsoa_storage<T, 4>::size_type size_type;
+
+		tvec4soa();
+		explicit tvec4soa(size_type count);
+		tvec4soa(tvec4<T> const * data, size_type count);
+
+		T * x();
+		T * y();
+		T * z();
+		T * w();
+		T const * x() const;
+		T const * y() const;
+		T const * z() const;
+		T const * w() const;
+
+		//! Gather the i-th vector
+		tvec4<T> operator[](size_type i) const;
+
+		//! Scatter v as the i-th vector
+		void set(size_type i, tvec4<T> const & v);
+		void push_back(tvec4<T> const & v);
+
+		//! Replace the content with count vectors in array of structures layout
+		void assign(tvec4<T> const * data, size_type count);
+
+		//! Write the content back in array of structures layout
+		void copy(tvec4<T> * data) const;
+	};
+}//namespace detail
+
+	typedef detail::tvec3soa<float> vec3soa;
+	typedef detail::tvec4soa<float> vec4soa;
+	typedef detail::tvec3soa<double> dvec3soa;
+	typedef detail::tvec4soa<double> dvec4soa;
+
+	/// @addtogroup gtx_vec_soa
+	/// @{
+
+	//! Per vector dot product of x and y, written to out[0..x.size()).
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void dot(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> const & y,
+		T * out);
+
+	//! Per vector dot product of x and y, written to out[0..x.size()).
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void dot(
+		detail::tvec4soa<T> const & x,
+		detail::tvec4soa<T> const & y,
+		T * out);
+
+	//! Per vector length of x, written to out[0..x.size()).
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void length(
+		detail::tvec3soa<T> const & x,
+		T * out);
+
+	//! Per vector length of x, written to out[0..x.size()).
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void length(
+		detail::tvec4soa<T> const & x,
+		T * out);
+
+	//! Per vector cross product of x and y. out may alias x or y.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void cross(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> const & y,
+		detail::tvec3soa<T> & out);
+
+	//! Normalize every vector of x. out may alias x.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void normalize(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> & out);
+
+	//! Normalize every vector of x. out may alias x.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void normalize(
+		detail::tvec4soa<T> const & x,
+		detail::tvec4soa<T> & out);
+
+	//! Per vector x * (1 - a) + y * a. out may alias x or y.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void mix(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> const & y,
+		T const & a,
+		detail::tvec3soa<T> & out);
+
+	//! Per vector x * (1 - a) + y * a. out may alias x or y.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void mix(
+		detail::tvec4soa<T> const & x,
+		detail::tvec4soa<T> const & y,
+		T const & a,
+		detail::tvec4soa<T> & out);
+
+	//! Per component min(max(x, minVal), maxVal). out may alias x.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void clamp(
+		detail::tvec3soa<T> const & x,
+		T const & minVal,
+		T const & maxVal,
+		detail::tvec3soa<T> & out);
+
+	//! Per component min(max(x, minVal), maxVal). out may alias x.
+	//! From GLM_GTX_vec_soa extension.
+	template <typename T>
+	void clamp(
+		detail::tvec4soa<T> const & x,
+		T const & minVal,
+		T const & maxVal,
+		detail::tvec4soa<T> & out);
+
+	/// @}
+}// namespace glm
+
+#include "vec_soa.inl"
+
+#endif//GLM_GTX_vec_soa
@@ -0,0 +1,819 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2012 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2016-11-05
+// Updated : 2016-11-08
+// Licence : This source is under MIT License
+// File    : glm/gtx/vec_soa.inl
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail
+{
+	//////////////////////////////////////
+	// Batch arithmetic
+
+	// One value per operation, used for any value type and for the tail of
+	// the streams that doesn't fill a whole register
+	template <typename T>
+	struct soa_scalar
+	{
+		typedef T type;
+		enum{size = 1};
+
+		static GLM_FUNC_QUALIFIER type load(T const * p){return *p;}
+		static GLM_FUNC_QUALIFIER type loadu(T const * p){return *p;}
+		static GLM_FUNC_QUALIFIER void store(T * p, type const & v){*p = v;}
+		static GLM_FUNC_QUALIFIER void storeu(T * p, type const & v){*p = v;}
+		static GLM_FUNC_QUALIFIER type set1(T const & s){return s;}
+		static GLM_FUNC_QUALIFIER type add(type const & a, type const & b){return a + b;}
+		static GLM_FUNC_QUALIFIER type sub(type const & a, type const & b){return a - b;}
+		static GLM_FUNC_QUALIFIER type mul(type const & a, type const & b){return a * b;}
+		static GLM_FUNC_QUALIFIER type div(type const & a, type const & b){return a / b;}
+		static GLM_FUNC_QUALIFIER type sqrt(type const & a){return ::glm::sqrt(a);}
+		static GLM_FUNC_QUALIFIER type min(type const & a, type const & b){return ::glm::min(a, b);}
+		static GLM_FUNC_QUALIFIER type max(type const & a, type const & b){return ::glm::max(a, b);}
+		static GLM_FUNC_QUALIFIER type floor(type const & a){return ::glm::floor(a);}
+		static GLM_FUNC_QUALIFIER type abs(type const & a){return ::glm::abs(a);}
+		static GLM_FUNC_QUALIFIER type step(type const & edge, type const & x){return ::glm::step(edge, x);}
+
+		// Per lane comparisons, combined and consumed through movemask (one bit per lane)
+		typedef bool mask;
+		static GLM_FUNC_QUALIFIER mask lessThan(type const & a, type const & b){return a < b;}
+		static GLM_FUNC_QUALIFIER mask lessThanEqual(type const & a, type const & b){return a <= b;}
+		static GLM_FUNC_QUALIFIER mask mask_and(mask const & a, mask const & b){return a && b;}
+		static GLM_FUNC_QUALIFIER mask mask_andnot(mask const & a, mask const & b){return a && !b;}
+		static GLM_FUNC_QUALIFIER mask mask_or(mask const & a, mask const & b){return a || b;}
+		static GLM_FUNC_QUALIFIER type select(mask const & m, type const & a, type const & b){return m ? a : b;}
+		static GLM_FUNC_QUALIFIER int movemask(mask const & m){return m ? 1 : 0;}
+	};
+
+	// Widest registers available for the value type
+	template <typename T>
+	struct soa_packet : public soa_scalar<T>
+	{};
+
+#if(GLM_ARCH & GLM_ARCH_AVX)
+	template <>
+	struct soa_packet<float>
+	{
+		typedef __m256 type;
+		enum{size = 8};
+
+		static GLM_FUNC_QUALIFIER type load(float const * p){return _mm256_load_ps(p);}
+		static GLM_FUNC_QUALIFIER type loadu(float const * p){return _mm256_loadu_ps(p);}
+		static GLM_FUNC_QUALIFIER void store(float * p, type const & v){_mm256_store_ps(p, v);}
+		static GLM_FUNC_QUALIFIER void storeu(float * p, type const & v){_mm256_storeu_ps(p, v);}
+		static GLM_FUNC_QUALIFIER type set1(float const & s){return _mm256_set1_ps(s);}
+		static GLM_FUNC_QUALIFIER type add(type const & a, type const & b){return _mm256_add_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type sub(type const & a, type const & b){return _mm256_sub_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type mul(type const & a, type const & b){return _mm256_mul_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type div(type const & a, type const & b){return _mm256_div_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type sqrt(type const & a){return _mm256_sqrt_ps(a);}
+		static GLM_FUNC_QUALIFIER type min(type const & a, type const & b){return _mm256_min_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type max(type const & a, type const & b){return _mm256_max_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type floor(type const & a){return _mm256_floor_ps(a);}
+		static GLM_FUNC_QUALIFIER type abs(type const & a){return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);}
+		static GLM_FUNC_QUALIFIER type step(type const & edge, type const & x){return _mm256_and_ps(_mm256_cmp_ps(x, edge, _CMP_NLT_UQ), _mm256_set1_ps(1.0f));}
+
+		typedef __m256 mask;
+		static GLM_FUNC_QUALIFIER mask lessThan(type const & a, type const & b){return _mm256_cmp_ps(a, b, _CMP_LT_OQ);}
+		static GLM_FUNC_QUALIFIER mask lessThanEqual(type const & a, type const & b){return _mm256_cmp_ps(a, b, _CMP_LE_OQ);}
+		static GLM_FUNC_QUALIFIER mask mask_and(mask const & a, mask const & b){return _mm256_and_ps(a, b);}
+		static GLM_FUNC_QUALIFIER mask mask_andnot(mask const & a, mask const & b){return _mm256_andnot_ps(b, a);}
+		static GLM_FUNC_QUALIFIER mask mask_or(mask const & a, mask const & b){return _mm256_or_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type select(mask const & m, type const & a, type const & b){return _mm256_blendv_ps(b, a, m);}
+		static GLM_FUNC_QUALIFIER int movemask(mask const & m){return _mm256_movemask_ps(m);}
+	};
+#elif(GLM_ARCH & GLM_ARCH_SSE2)
+	template <>
+	struct soa_packet<float>
+	{
+		typedef __m128 type;
+		enum{size = 4};
+
+		static GLM_FUNC_QUALIFIER type load(float const * p){return _mm_load_ps(p);}
+		static GLM_FUNC_QUALIFIER type loadu(float const * p){return _mm_loadu_ps(p);}
+		static GLM_FUNC_QUALIFIER void store(float * p, type const & v){_mm_store_ps(p, v);}
+		static GLM_FUNC_QUALIFIER void storeu(float * p, type const & v){_mm_storeu_ps(p, v);}
+		static GLM_FUNC_QUALIFIER type set1(float const & s){return _mm_set1_ps(s);}
+		static GLM_FUNC_QUALIFIER type add(type const & a, type const & b){return _mm_add_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type sub(type const & a, type const & b){return _mm_sub_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type mul(type const & a, type const & b){return _mm_mul_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type div(type const & a, type const & b){return _mm_div_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type sqrt(type const & a){return _mm_sqrt_ps(a);}
+		static GLM_FUNC_QUALIFIER type min(type const & a, type const & b){return _mm_min_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type max(type const & a, type const & b){return _mm_max_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type floor(type const & a){return sse_flr_ps(a);}
+		static GLM_FUNC_QUALIFIER type abs(type const & a){return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);}
+		static GLM_FUNC_QUALIFIER type step(type const & edge, type const & x){return _mm_and_ps(_mm_cmpnlt_ps(x, edge), _mm_set1_ps(1.0f));}
+
+		typedef __m128 mask;
+		static GLM_FUNC_QUALIFIER mask lessThan(type const & a, type const & b){return _mm_cmplt_ps(a, b);}
+		static GLM_FUNC_QUALIFIER mask lessThanEqual(type const & a, type const & b){return _mm_cmple_ps(a, b);}
+		static GLM_FUNC_QUALIFIER mask mask_and(mask const & a, mask const & b){return _mm_and_ps(a, b);}
+		static GLM_FUNC_QUALIFIER mask mask_andnot(mask const & a, mask const & b){return _mm_andnot_ps(b, a);}
+		static GLM_FUNC_QUALIFIER mask mask_or(mask const & a, mask const & b){return _mm_or_ps(a, b);}
+		static GLM_FUNC_QUALIFIER type select(mask const & m, type const & a, type const & b){return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));}
+		static GLM_FUNC_QUALIFIER int movemask(mask const & m){return _mm_movemask_ps(m);}
+	};
+#endif//GLM_ARCH
+
+	//////////////////////////////////////
+	// Kernels, working on [First, Last) of N streams
+
+	template <typename P, std::size_t N, typename T>
+	GLM_FUNC_QUALIFIER typename P::type soa_dot_at(T const * const x[N], T const * const y[N], std::size_t i)
+	{
+		typename P::type Result = P::mul(P::load(x[0] + i), P::load(y[0] + i));
+		for(std::size_t c = 1; c < N; ++c)
+			Result = P::add(Result, P::mul(P::load(x[c] + i), P::load(y[c] + i)));
+		return Result;
+	}
+
+	template <typename P, std::size_t N, typename T>
+	GLM_FUNC_QUALIFIER void soa_dot(T const * const x[N], T const * const y[N], T * out, std::size_t First, std::size_t Last)
+	{
+		for(std::size_t i = First; i < Last; i += P::size)
+			P::storeu(out + i, soa_dot_at<P, N>(x, y, i));
+	}
+
+	template <typename P, std::size_t N, typename T>
+	GLM_FUNC_QUALIFIER void soa_length(T const * const x[N], T * out, std::size_t First, std::size_t Last)
+	{
+		for(std::size_t i = First; i < Last; i += P::size)
+			P::storeu(out + i, P::sqrt(soa_dot_at<P, N>(x, x, i)));
+	}
+
+	template <typename P, typename T>
+	GLM_FUNC_QUALIFIER void soa_cross(T const * const x[3], T const * const y[3], T * const out[3], std::size_t First, std::size_t Last)
+	{
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			typename P::type x0 = P::load(x[0] + i);
+			typename P::type x1 = P::load(x[1] + i);
+			typename P::type x2 = P::load(x[2] + i);
+			typename P::type y0 = P::load(y[0] + i);
+			typename P::type y1 = P::load(y[1] + i);
+			typename P::type y2 = P::load(y[2] + i);
+
+			P::store(out[0] + i, P::sub(P::mul(x1, y2), P::mul(y1, x2)));
+			P::store(out[1] + i, P::sub(P::mul(x2, y0), P::mul(y2, x0)));
+			P::store(out[2] + i, P::sub(P::mul(x0, y1), P::mul(y0, x1)));
+		}
+	}
+
+	template <typename P, std::size_t N, typename T>
+	GLM_FUNC_QUALIFIER void soa_normalize(T const * const x[N], T * const out[N], std::size_t First, std::size_t Last)
+	{
+		typename P::type const One = P::set1(T(1));
+		for(std::size_t i = First; i < Last; i += P::size)
+		{
+			typename P::type InvLength = P::div(One, P::sqrt(soa_dot_at<P, N>(x, x, i)));
+			for(std::size_t c = 0; c < N; ++c)
+				P::store(out[c] + i, P::mul(P::load(x[c] + i), InvLength));
+		}
+	}
+
+	template <typename P, std::size_t N, typename T>
+	GLM_FUNC_QUALIFIER void soa_mix(T const * const x[N], T const * const y[N], T const & a, T * const out[N], std::size_t First, std::size_t Last)
+	{
+		typename P::type const A = P::set1(a);
+		for(std::size_t i = First; i < Last; i += P::size)
+		for(std::size_t c = 0; c < N; ++c)
+		{
+			typename P::type X = P::load(x[c] + i);
+			P::store(out[c] + i, P::add(X, P::mul(A, P::sub(P::load(y[c] + i), X))));
+		}
+	}
+
+	template <typename P, std::size_t N, typename T>
+	GLM_FUNC_QUALIFIER void soa_clamp(T const * const x[N], T const & minVal, T const & maxVal, T * const out[N], std::size_t First, std::size_t Last)
+	{
+		typename P::type const Min = P::set1(minVal);
+		typename P::type const Max = P::set1(maxVal);
+		for(std::size_t i = First; i < Last; i += P::size)
+		for(std::size_t c = 0; c < N; ++c)
+			P::store(out[c] + i, P::min(P::max(P::load(x[c] + i), Min), Max));
+	}
+
+	// Number of values handled with whole registers, the rest goes through soa_scalar
+	template <typename T>
+	GLM_FUNC_QUALIFIER std::size_t soa_bulk(std::size_t Size)
+	{
+		return Size - Size % std::size_t(soa_packet<T>::size);
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_streams(tsoa_storage<T, L> const & s, T const * out[L])
+	{
+		for(std::size_t c = 0; c < L; ++c)
+			out[c] = s.stream(c);
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_streams(tsoa_storage<T, L> & s, T * out[L])
+	{
+		for(std::size_t c = 0; c < L; ++c)
+			out[c] = s.stream(c);
+	}
+
+	//////////////////////////////////////
+	// tsoa_storage
+
+	// Capacities are kept multiple of this so every stream stays aligned
+	// and whole registers never read past the allocation
+	GLM_FUNC_QUALIFIER std::size_t soa_round(std::size_t count)
+	{
+		return (count + 7) & ~std::size_t(7);
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER tsoa_storage<T, L>::tsoa_storage() :
+		Memory(0),
+		Data(0),
+		Size(0),
+		Capacity(0)
+	{}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER tsoa_storage<T, L>::tsoa_storage
+	(
+		tsoa_storage<T, L> const & s
+	) :
+		Memory(0),
+		Data(0),
+		Size(0),
+		Capacity(0)
+	{
+		*this = s;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER tsoa_storage<T, L>::~tsoa_storage()
+	{
+		std::free(this->Memory);
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER tsoa_storage<T, L> & tsoa_storage<T, L>::operator=
+	(
+		tsoa_storage<T, L> const & s
+	)
+	{
+		if(this == &s)
+			return *this;
+
+		this->clear();
+		this->reserve(s.Size);
+		for(size_type c = 0; c < L; ++c)
+			std::memcpy(this->stream(c), s.stream(c), s.Size * sizeof(T));
+		this->Size = s.Size;
+		return *this;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER typename tsoa_storage<T, L>::size_type tsoa_storage<T, L>::size() const
+	{
+		return this->Size;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER typename tsoa_storage<T, L>::size_type tsoa_storage<T, L>::capacity() const
+	{
+		return this->Capacity;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER bool tsoa_storage<T, L>::empty() const
+	{
+		return this->Size == 0;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER typename tsoa_storage<T, L>::size_type tsoa_storage<T, L>::padded_size() const
+	{
+		return soa_round(this->Size);
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void tsoa_storage<T, L>::reserve
+	(
+		size_type count
+	)
+	{
+		if(count <= this->Capacity)
+			return;
+
+		size_type NewCapacity = soa_round(glm::max(count, this->Capacity * 2));
+		void * NewMemory = std::malloc(L * NewCapacity * sizeof(T) + alignment);
+		assert(NewMemory);
+
+		T * NewData = reinterpret_cast<T*>((reinterpret_cast<std::size_t>(NewMemory) + alignment) & ~std::size_t(alignment - 1));
+
+		// Everything past Size is kept zero, batch functions rely on it
+		std::memset(NewData, 0, L * NewCapacity * sizeof(T));
+		for(size_type c = 0; c < L; ++c)
+			std::memcpy(NewData + c * NewCapacity, this->stream(c), this->Size * sizeof(T));
+
+		std::free(this->Memory);
+		this->Memory = NewMemory;
+		this->Data = NewData;
+		this->Capacity = NewCapacity;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void tsoa_storage<T, L>::resize
+	(
+		size_type count
+	)
+	{
+		this->reserve(count);
+		for(size_type c = 0; c < L; ++c)
+		for(size_type i = count; i < this->Size; ++i)
+			this->stream(c)[i] = T(0);
+		this->Size = count;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void tsoa_storage<T, L>::clear()
+	{
+		this->resize(0);
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER T * tsoa_storage<T, L>::stream
+	(
+		size_type i
+	)
+	{
+		assert(i < L);
+		return this->Data + i * this->Capacity;
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER T const * tsoa_storage<T, L>::stream
+	(
+		size_type i
+	) const
+	{
+		assert(i < L);
+		return this->Data + i * this->Capacity;
+	}
+
+	//////////////////////////////////////
+	// tvec3soa
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec3soa<T>::tvec3soa()
+	{}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec3soa<T>::tvec3soa
+	(
+		size_type count
+	)
+	{
+		this->resize(count);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec3soa<T>::tvec3soa
+	(
+		tvec3<T> const * data,
+		size_type count
+	)
+	{
+		this->assign(data, count);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec3soa<T>::x(){return this->stream(0);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec3soa<T>::y(){return this->stream(1);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec3soa<T>::z(){return this->stream(2);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec3soa<T>::x() const{return this->stream(0);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec3soa<T>::y() const{return this->stream(1);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec3soa<T>::z() const{return this->stream(2);}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec3<T> tvec3soa<T>::operator[]
+	(
+		size_type i
+	) const
+	{
+		assert(i < this->size());
+		return tvec3<T>(this->x()[i], this->y()[i], this->z()[i]);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec3soa<T>::set
+	(
+		size_type i,
+		tvec3<T> const & v
+	)
+	{
+		assert(i < this->size());
+		this->x()[i] = v.x;
+		this->y()[i] = v.y;
+		this->z()[i] = v.z;
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec3soa<T>::push_back
+	(
+		tvec3<T> const & v
+	)
+	{
+		this->resize(this->size() + 1);
+		this->set(this->size() - 1, v);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec3soa<T>::assign
+	(
+		tvec3<T> const * data,
+		size_type count
+	)
+	{
+		this->clear();
+		this->resize(count);
+
+		T * X = this->x();
+		T * Y = this->y();
+		T * Z = this->z();
+		for(size_type i = 0; i < count; ++i)
+		{
+			X[i] = data[i].x;
+			Y[i] = data[i].y;
+			Z[i] = data[i].z;
+		}
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec3soa<T>::copy
+	(
+		tvec3<T> * data
+	) const
+	{
+		T const * X = this->x();
+		T const * Y = this->y();
+		T const * Z = this->z();
+		for(size_type i = 0; i < this->size(); ++i)
+			data[i] = tvec3<T>(X[i], Y[i], Z[i]);
+	}
+
+	//////////////////////////////////////
+	// tvec4soa
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec4soa<T>::tvec4soa()
+	{}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec4soa<T>::tvec4soa
+	(
+		size_type count
+	)
+	{
+		this->resize(count);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec4soa<T>::tvec4soa
+	(
+		tvec4<T> const * data,
+		size_type count
+	)
+	{
+		this->assign(data, count);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec4soa<T>::x(){return this->stream(0);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec4soa<T>::y(){return this->stream(1);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec4soa<T>::z(){return this->stream(2);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T * tvec4soa<T>::w(){return this->stream(3);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec4soa<T>::x() const{return this->stream(0);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec4soa<T>::y() const{return this->stream(1);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec4soa<T>::z() const{return this->stream(2);}
+	template <typename T>
+	GLM_FUNC_QUALIFIER T const * tvec4soa<T>::w() const{return this->stream(3);}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER tvec4<T> tvec4soa<T>::operator[]
+	(
+		size_type i
+	) const
+	{
+		assert(i < this->size());
+		return tvec4<T>(this->x()[i], this->y()[i], this->z()[i], this->w()[i]);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec4soa<T>::set
+	(
+		size_type i,
+		tvec4<T> const & v
+	)
+	{
+		assert(i < this->size());
+		this->x()[i] = v.x;
+		this->y()[i] = v.y;
+		this->z()[i] = v.z;
+		this->w()[i] = v.w;
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec4soa<T>::push_back
+	(
+		tvec4<T> const & v
+	)
+	{
+		this->resize(this->size() + 1);
+		this->set(this->size() - 1, v);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec4soa<T>::assign
+	(
+		tvec4<T> const * data,
+		size_type count
+	)
+	{
+		this->clear();
+		this->resize(count);
+
+		T * X = this->x();
+		T * Y = this->y();
+		T * Z = this->z();
+		T * W = this->w();
+		for(size_type i = 0; i < count; ++i)
+		{
+			X[i] = data[i].x;
+			Y[i] = data[i].y;
+			Z[i] = data[i].z;
+			W[i] = data[i].w;
+		}
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void tvec4soa<T>::copy
+	(
+		tvec4<T> * data
+	) const
+	{
+		T const * X = this->x();
+		T const * Y = this->y();
+		T const * Z = this->z();
+		T const * W = this->w();
+		for(size_type i = 0; i < this->size(); ++i)
+			data[i] = tvec4<T>(X[i], Y[i], Z[i], W[i]);
+	}
+	//////////////////////////////////////
+	// Batch functions shared by vec3 and vec4
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_dot_all
+	(
+		tsoa_storage<T, L> const & x,
+		tsoa_storage<T, L> const & y,
+		T * out
+	)
+	{
+		assert(x.size() == y.size());
+
+		T const * X[L];
+		T const * Y[L];
+		soa_streams(x, X);
+		soa_streams(y, Y);
+
+		std::size_t const Bulk = soa_bulk<T>(x.size());
+		soa_dot<soa_packet<T>, L>(X, Y, out, 0, Bulk);
+		soa_dot<soa_scalar<T>, L>(X, Y, out, Bulk, x.size());
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_length_all
+	(
+		tsoa_storage<T, L> const & x,
+		T * out
+	)
+	{
+		T const * X[L];
+		soa_streams(x, X);
+
+		std::size_t const Bulk = soa_bulk<T>(x.size());
+		soa_length<soa_packet<T>, L>(X, out, 0, Bulk);
+		soa_length<soa_scalar<T>, L>(X, out, Bulk, x.size());
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_normalize_all
+	(
+		tsoa_storage<T, L> const & x,
+		tsoa_storage<T, L> & out
+	)
+	{
+		out.resize(x.size());
+
+		T const * X[L];
+		T * Out[L];
+		soa_streams(x, X);
+		soa_streams(out, Out);
+
+		std::size_t const Bulk = soa_bulk<T>(x.size());
+		soa_normalize<soa_packet<T>, L>(X, Out, 0, Bulk);
+		soa_normalize<soa_scalar<T>, L>(X, Out, Bulk, x.size());
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_mix_all
+	(
+		tsoa_storage<T, L> const & x,
+		tsoa_storage<T, L> const & y,
+		T const & a,
+		tsoa_storage<T, L> & out
+	)
+	{
+		assert(x.size() == y.size());
+		out.resize(x.size());
+
+		T const * X[L];
+		T const * Y[L];
+		T * Out[L];
+		soa_streams(x, X);
+		soa_streams(y, Y);
+		soa_streams(out, Out);
+
+		std::size_t const Bulk = soa_bulk<T>(x.size());
+		soa_mix<soa_packet<T>, L>(X, Y, a, Out, 0, Bulk);
+		soa_mix<soa_scalar<T>, L>(X, Y, a, Out, Bulk, x.size());
+	}
+
+	template <typename T, std::size_t L>
+	GLM_FUNC_QUALIFIER void soa_clamp_all
+	(
+		tsoa_storage<T, L> const & x,
+		T const & minVal,
+		T const & maxVal,
+		tsoa_storage<T, L> & out
+	)
+	{
+		out.resize(x.size());
+
+		T const * X[L];
+		T * Out[L];
+		soa_streams(x, X);
+		soa_streams(out, Out);
+
+		std::size_t const Bulk = soa_bulk<T>(x.size());
+		soa_clamp<soa_packet<T>, L>(X, minVal, maxVal, Out, 0, Bulk);
+		soa_clamp<soa_scalar<T>, L>(X, minVal, maxVal, Out, Bulk, x.size());
+	}
+
+}//namespace detail
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void dot
+	(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> const & y,
+		T * out
+	)
+	{
+		detail::soa_dot_all(x, y, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void dot
+	(
+		detail::tvec4soa<T> const & x,
+		detail::tvec4soa<T> const & y,
+		T * out
+	)
+	{
+		detail::soa_dot_all(x, y, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void length
+	(
+		detail::tvec3soa<T> const & x,
+		T * out
+	)
+	{
+		detail::soa_length_all(x, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void length
+	(
+		detail::tvec4soa<T> const & x,
+		T * out
+	)
+	{
+		detail::soa_length_all(x, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void cross
+	(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> const & y,
+		detail::tvec3soa<T> & out
+	)
+	{
+		assert(x.size() == y.size());
+		out.resize(x.size());
+
+		T const * X[3];
+		T const * Y[3];
+		T * Out[3];
+		detail::soa_streams(x, X);
+		detail::soa_streams(y, Y);
+		detail::soa_streams(out, Out);
+
+		std::size_t const Bulk = detail::soa_bulk<T>(x.size());
+		detail::soa_cross<detail::soa_packet<T> >(X, Y, Out, 0, Bulk);
+		detail::soa_cross<detail::soa_scalar<T> >(X, Y, Out, Bulk, x.size());
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void normalize
+	(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> & out
+	)
+	{
+		detail::soa_normalize_all(x, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void normalize
+	(
+		detail::tvec4soa<T> const & x,
+		detail::tvec4soa<T> & out
+	)
+	{
+		detail::soa_normalize_all(x, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void mix
+	(
+		detail::tvec3soa<T> const & x,
+		detail::tvec3soa<T> const & y,
+		T const & a,
+		detail::tvec3soa<T> & out
+	)
+	{
+		detail::soa_mix_all(x, y, a, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void mix
+	(
+		detail::tvec4soa<T> const & x,
+		detail::tvec4soa<T> const & y,
+		T const & a,
+		detail::tvec4soa<T> & out
+	)
+	{
+		detail::soa_mix_all(x, y, a, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void clamp
+	(
+		detail::tvec3soa<T> const & x,
+		T const & minVal,
+		T const & maxVal,
+		detail::tvec3soa<T> & out
+	)
+	{
+		detail::soa_clamp_all(x, minVal, maxVal, out);
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER void clamp
+	(
+		detail::tvec4soa<T> const & x,
+		T const & minVal,
+		T const & maxVal,
+		detail::tvec4soa<T> & out
+	)
+	{
+		detail::soa_clamp_all(x, minVal, maxVal, out);
+	}
+}//namespace glm
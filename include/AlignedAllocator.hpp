@@ -0,0 +1,52 @@
+/**
+ * @class   AlignedAllocator
+ * @brief   Allocator honoring the alignment of over-aligned types
+ *
+ * Before C++17 operator new only guarantees the alignment of the
+ * fundamental types, so containers of types declared alignas(64), such
+ * as the per thread buffers kept a cache line apart, lose it. This one
+ * allocates their storage aligned to alignof(T).
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+template <typename T>
+class AlignedAllocator {
+    public:
+        using value_type = T;
+
+        AlignedAllocator() = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U>&) {}
+
+        T* allocate(size_t count) {
+            /* posix_memalign needs a multiple of the pointer size */
+            size_t alignment = std::max(alignof(T), sizeof(void*));
+            void* memory = nullptr;
+            if (posix_memalign(&memory, alignment, count * sizeof(T)) != 0) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(memory);
+        }
+
+        void deallocate(T* memory, size_t) {
+            free(memory);
+        }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+    return false;
+}
@@ -0,0 +1,103 @@
+/**
+ * @class   DebugUtils
+ * @brief   VK_EXT_debug_utils object names and command buffer labels, so
+ *          validation messages and frame captures show what is what
+ *
+ * Use DEBUG_NAME and DEBUG_LABEL rather than the functions: in release
+ * builds they compile down to nothing, arguments included, so names can
+ * be built with strings freely. The functions do nothing until load() was
+ * called with an instance that enabled the extension.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VDeleter.hpp"
+#include "VulkanApi.hpp"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+class DebugUtils {
+    public:
+        /**
+         * Functions shared by the whole process
+         */
+        static DebugUtils& instance();
+
+        DebugUtils(const DebugUtils&) = delete;
+        DebugUtils& operator=(const DebugUtils&) = delete;
+
+        /**
+         * Looks up the functions of the extension. Must happen before any
+         * object is named, they are not synchronized.
+         */
+        void load(VkInstance instance);
+
+        /**
+         * Names handle, of objectType, created from device
+         */
+        void setName(VkDevice device, VkObjectType objectType, uint64_t handle, const char* name) const;
+
+        /**
+         * Opens a region of commandBuffer, closed by endLabel()
+         */
+        void beginLabel(VkCommandBuffer commandBuffer, const char* name) const;
+        void endLabel(VkCommandBuffer commandBuffer) const;
+
+    private:
+        PFN_vkSetDebugUtilsObjectNameEXT _setObjectName{nullptr};
+        PFN_vkCmdBeginDebugUtilsLabelEXT _cmdBeginLabel{nullptr};
+        PFN_vkCmdEndDebugUtilsLabelEXT _cmdEndLabel{nullptr};
+
+        DebugUtils() = default;
+};
+
+/**
+ * Names a handle not owned by a VDeleter, such as queues, command buffers
+ * or swap chain images
+ */
+template <typename T>
+void debugName(VkDevice device, VkObjectType objectType, T handle, const std::string& name) {
+    DebugUtils::instance().setName(device, objectType, reinterpret_cast<uint64_t>(handle), name.c_str());
+}
+
+/**
+ * Names a handle owned by a VDeleter, with the object type of its policy
+ */
+template <typename T>
+void debugName(const VDeleter<T>& handle, const std::string& name) {
+    static_assert(std::is_same<typename VDeleter<T>::Parent, VkDevice>::value, "Only objects created from a device can be named");
+    debugName(handle.parent(), VDeleterPolicy<T>::kType, T(handle), name);
+}
+
+/**
+ * Labels the commands recorded between its construction and destruction
+ */
+class DebugLabel {
+    public:
+        DebugLabel(VkCommandBuffer commandBuffer, const std::string& name) : _commandBuffer(commandBuffer) {
+            DebugUtils::instance().beginLabel(_commandBuffer, name.c_str());
+        }
+
+        ~DebugLabel() {
+            DebugUtils::instance().endLabel(_commandBuffer);
+        }
+
+        DebugLabel(const DebugLabel&) = delete;
+        DebugLabel& operator=(const DebugLabel&) = delete;
+
+    private:
+        VkCommandBuffer _commandBuffer;
+};
+
+#define DEBUG_CONCAT_(a, b) a##b
+#define DEBUG_CONCAT(a, b) DEBUG_CONCAT_(a, b)
+
+#ifdef NDEBUG
+#define DEBUG_NAME(...) ((void) 0)
+#define DEBUG_LABEL(commandBuffer, name) ((void) 0)
+#else
+#define DEBUG_NAME(...) debugName(__VA_ARGS__)
+#define DEBUG_LABEL(commandBuffer, name) DebugLabel DEBUG_CONCAT(_debugLabel, __LINE__)(commandBuffer, name)
+#endif
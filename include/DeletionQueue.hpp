@@ -0,0 +1,111 @@
+/**
+ * @class   DeletionQueue
+ * @brief   Destroys retired Vulkan objects once the GPU no longer uses them
+ *
+ * Objects that may still be in use by frames in flight are retired into
+ * the bucket of the frame being recorded instead of being destroyed.
+ * Frames complete in order, so once the fence of that frame signals no
+ * earlier frame uses them either: the bucket is emptied when the frame
+ * slot comes around again, right after waiting on its fence.
+ *
+ * Objects can be retired from any thread. Callers must not record them in
+ * any new frame after retiring them.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VDeleter.hpp"
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+class DeletionQueue {
+    public:
+        /**
+         * @param frames    Frames in flight, one bucket is kept for each
+         */
+        explicit DeletionQueue(uint32_t frames);
+
+        /**
+         * Destroys everything still queued, the GPU must be idle
+         */
+        ~DeletionQueue();
+
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        /**
+         * Takes the handle out of wrapper, which is left empty, and destroys
+         * it once the current frame completes
+         */
+        template <typename T, typename Policy>
+        void retire(VDeleter<T, Policy>& wrapper) {
+            static_assert(!std::is_void<typename Policy::Parent>::value,
+                          "Instances and devices can't be retired, they outlive every frame");
+
+            typename Policy::Parent parent = wrapper.parent();
+            T object = wrapper.release();
+            if (object == VK_NULL_HANDLE) {
+                return;
+            }
+            _retire({&DeletionQueue::_destroy<T, Policy>, (uint64_t) parent, (uint64_t) object});
+        }
+
+        /**
+         * Retires the handle in wrapper and returns where to create its
+         * replacement, like VDeleter::replace() but without having to wait
+         * for the frames in flight to complete
+         */
+        template <typename T, typename Policy>
+        T* replace(VDeleter<T, Policy>& wrapper) {
+            retire(wrapper);
+            return wrapper.replace();
+        }
+
+        /**
+         * Calls destroy once the current frame completes, for anything that
+         * isn't a single handle, as suballocations
+         */
+        void retire(std::function<void()> destroy);
+
+        /**
+         * Starts recording frame, whose previous use has completed: what was
+         * retired then is destroyed and new retirements go to its bucket
+         */
+        void beginFrame(uint32_t frame);
+
+        /**
+         * Destroys everything queued, the GPU must be idle
+         */
+        void flush();
+
+    private:
+        /**
+         * Retired handle with its parent, as 64 bit values so any type fits
+         */
+        struct Handle {
+            void (*destroy)(uint64_t parent, uint64_t object);
+            uint64_t parent;
+            uint64_t object;
+        };
+
+        struct Bucket {
+            std::vector<Handle> handles;
+            std::vector<std::function<void()>> functions;
+        };
+
+        std::mutex _mutex;                                               /**> Protects everything below */
+        std::vector<Bucket> _buckets;                                    /**> Retired objects of every frame in flight */
+        uint32_t _frame{0};                                              /**> Frame being recorded */
+
+        void _retire(const Handle& handle);
+        static void _destroyBucket(Bucket& bucket);
+
+        template <typename T, typename Policy>
+        static void _destroy(uint64_t parent, uint64_t object) {
+            Policy::destroy((typename Policy::Parent) parent, (T) object);
+        }
+};
@@ -0,0 +1,67 @@
+/**
+ * @class   DeviceDispatch
+ * @brief   Device functions loaded straight from the driver
+ *
+ * The functions exported by the loader are trampolines: they look up the
+ * dispatch table of the device or command buffer, then jump to the
+ * driver. Pointers from vkGetDeviceProcAddr go to the driver, or to the
+ * first enabled layer, directly, which matters for the functions called
+ * for every draw.
+ *
+ * The table is generated from VULKAN_DEVICE_FUNCTIONS, add the functions
+ * called every frame there. Loaded pointers are only valid for the device
+ * they were loaded from.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VulkanApi.hpp"
+
+/**
+ * Functions in the table, all of them core or from enabled extensions
+ */
+#define VULKAN_DEVICE_FUNCTIONS(F) \
+    F(vkGetDeviceQueue) \
+    F(vkDeviceWaitIdle) \
+    F(vkWaitForFences) \
+    F(vkResetFences) \
+    F(vkQueueSubmit) \
+    F(vkAcquireNextImageKHR) \
+    F(vkQueuePresentKHR) \
+    F(vkBeginCommandBuffer) \
+    F(vkEndCommandBuffer) \
+    F(vkCmdBeginRenderPass) \
+    F(vkCmdNextSubpass) \
+    F(vkCmdEndRenderPass) \
+    F(vkCmdBindPipeline) \
+    F(vkCmdBindVertexBuffers) \
+    F(vkCmdBindIndexBuffer) \
+    F(vkCmdSetViewport) \
+    F(vkCmdSetScissor) \
+    F(vkCmdDraw) \
+    F(vkCmdDrawIndexed) \
+    F(vkCmdPipelineBarrier) \
+    F(vkCmdBlitImage) \
+    F(vkCmdResetQueryPool) \
+    F(vkCmdWriteTimestamp) \
+    F(vkCmdBeginQuery) \
+    F(vkCmdEndQuery) \
+    F(vkGetQueryPoolResults)
+
+struct DeviceDispatch {
+#define VULKAN_DISPATCH_MEMBER(name) PFN_##name name{nullptr};
+    VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_MEMBER)
+#undef VULKAN_DISPATCH_MEMBER
+
+    /**
+     * Loads every function of device through vkGetDeviceProcAddr
+     */
+    void load(VkDevice device);
+
+    /**
+     * Fills the table with the loader exports instead, which behaves as
+     * not having a table at all
+     */
+    void loadTrampolines();
+};
@@ -0,0 +1,72 @@
+/**
+ * @class   DynamicResolution
+ * @brief   Render resolution that follows the GPU time of frames, so they
+ *          stay within a budget when the load spikes
+ *
+ * Frames render to a corner of an offscreen target as big as the swap
+ * chain, which is then upscaled to the swap chain image, so changing the
+ * resolution recreates nothing. The GPU time of a frame is known a few
+ * frames after it was recorded, once its fence signals; the scale it was
+ * rendered at is kept per frame in flight to compare both.
+ *
+ * The GPU time is taken as proportional to the pixels rendered, so the
+ * scale of each axis goes with the square root of the time. It moves part
+ * of the way on every frame, a single slow frame doesn't halve the
+ * resolution, and targets a bit less than the budget to leave room for
+ * the spikes.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VulkanApi.hpp"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class DynamicResolution {
+    public:
+        /**
+         * Starts following budget, the GPU time of a frame in ns. Until
+         * called frames render at full resolution.
+         */
+        void init(double budget, uint32_t framesInFlight);
+
+        bool enabled() const {
+            return _budget > 0.0;
+        }
+
+        /**
+         * Resolution to render frame at, out of the full one
+         */
+        VkExtent2D extent(uint32_t frame, VkExtent2D full);
+
+        /**
+         * Adjusts the scale to the GPU time of frame, in ns
+         */
+        void update(uint32_t frame, uint64_t gpuTime);
+
+        /**
+         * Pixels of the average frame rendered
+         */
+        uint64_t averagePixels() const {
+            return _frames ? _pixels / _frames : 0;
+        }
+
+        /**
+         * Frames over budget and the scales they rendered at
+         */
+        void report(std::ostream& out) const;
+
+    private:
+        double _budget{0.0};
+        double _scale{1.0};                                              /**> Of each axis, for the next frame */
+        std::vector<double> _frameScales;                                /**> Scale of every frame in flight */
+
+        uint64_t _pixels{0};                                             /**> Rendered over all frames */
+        uint64_t _frames{0};
+        uint64_t _measured{0};                                           /**> Frames with a GPU time */
+        uint64_t _overBudget{0};
+        double _scaleTotal{0.0};                                         /**> Summed over _measured */
+        double _minScale{1.0};
+};
@@ -0,0 +1,109 @@
+/**
+ * @class   HostAllocator
+ * @brief   VkAllocationCallbacks serving the driver host allocations from
+ *          size class pools, with accounting per object type and scope
+ *
+ * Every object type gets its own callbacks, so allocations are tagged by
+ * the kind of object being created, and Vulkan tags them by scope. Small
+ * allocations come from per size class free lists carved out of 64 KB
+ * slabs, which are kept until the allocator goes away; bigger or over
+ * aligned ones go to malloc.
+ *
+ * Objects must be destroyed with the callbacks they were created with, so
+ * the engine and the VDeleter policies both go through hostAllocator().
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VulkanApi.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+class HostAllocator {
+    public:
+        /**
+         * Accounting of an object type
+         */
+        struct Stats {
+            VkObjectType objectType;
+            int64_t liveBytes;                                           /**> Allocated and not freed yet */
+            int64_t peakBytes;                                           /**> Highest liveBytes so far */
+            int64_t scopeBytes[5];                                       /**> liveBytes by VkSystemAllocationScope */
+            int64_t internalBytes;                                       /**> Reported by the driver, not allocated by us */
+            uint64_t allocations;                                        /**> Allocations and reallocations so far */
+        };
+
+        /**
+         * Allocator shared by the whole process
+         */
+        static HostAllocator& instance();
+
+        ~HostAllocator();
+
+        HostAllocator(const HostAllocator&) = delete;
+        HostAllocator& operator=(const HostAllocator&) = delete;
+
+        /**
+         * Callbacks to create and destroy objects of objectType with. The
+         * pointer stays valid as long as the allocator.
+         */
+        const VkAllocationCallbacks* callbacks(VkObjectType objectType);
+
+        /**
+         * Accounting of every object type that allocated anything
+         */
+        std::vector<Stats> stats();
+
+        /**
+         * Writes a table of stats() with the allocation rate of each object
+         * type since the previous report
+         */
+        void report(std::ostream& out);
+
+    private:
+        struct Tag;
+        struct SizeClass;
+
+        /**
+         * Object types with callbacks, far more than Vulkan has
+         */
+        static const uint16_t kMaxTags = 256;
+
+        std::mutex _tagsMutex;                                           /**> Protects adding tags and _tagsByType */
+        std::unique_ptr<Tag> _tags[kMaxTags];                            /**> Callbacks and accounting of every object type. Never
+                                                                              removed nor moved, so they are read without locking */
+        uint16_t _tagCount{0};
+        std::map<VkObjectType, Tag*> _tagsByType;
+        std::unique_ptr<SizeClass[]> _sizeClasses;                       /**> Pools of the small allocations */
+        std::chrono::steady_clock::time_point _reportTime;               /**> When report() was last called */
+
+        HostAllocator();
+
+        void* _allocate(Tag* tag, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        void _free(void* memory);
+        Tag* _tag(uint16_t index);
+
+        static VKAPI_ATTR void* VKAPI_CALL _allocation(void* userData, size_t size, size_t alignment,
+                                                       VkSystemAllocationScope scope);
+        static VKAPI_ATTR void* VKAPI_CALL _reallocation(void* userData, void* original, size_t size, size_t alignment,
+                                                         VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL _free(void* userData, void* memory);
+        static VKAPI_ATTR void VKAPI_CALL _internalAllocation(void* userData, size_t size, VkInternalAllocationType type,
+                                                              VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL _internalFree(void* userData, size_t size, VkInternalAllocationType type,
+                                                        VkSystemAllocationScope scope);
+};
+
+/**
+ * Callbacks of the process wide allocator for objectType
+ */
+inline const VkAllocationCallbacks* hostAllocator(VkObjectType objectType) {
+    return HostAllocator::instance().callbacks(objectType);
+}
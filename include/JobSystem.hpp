@@ -0,0 +1,123 @@
+/**
+ * @class   JobSystem
+ * @brief   Work stealing job scheduler shared by the engine subsystems
+ *
+ * There is one thread per core, the thread that creates the system
+ * included. Each one owns a deque: jobs are pushed and popped at its
+ * bottom by the owner, while idle threads steal from the top of the
+ * others, so fan outs spread by themselves without a shared queue.
+ *
+ * Completion is tracked with counters: a job can signal a counter when
+ * it finishes and can wait for another counter to reach zero before it
+ * starts. Waiting on a counter runs other jobs instead of blocking.
+ *
+ * Jobs that must run on the main thread, as every GLFW call, go through
+ * runOnMainThread and are only executed by runMainThreadJobs or while the
+ * main thread waits.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+    private:
+        struct Job;
+        struct Worker;
+
+    public:
+        /**
+         * Number of jobs still to finish. A counter must not be
+         * destroyed or reused while jobs signal it or wait for it.
+         */
+        class Counter {
+            public:
+                bool done() const {
+                    return _pending.load(std::memory_order_acquire) == 0;
+                }
+
+            private:
+                friend class JobSystem;
+
+                std::atomic<uint32_t> _pending{0};                       /**> Jobs signalling this counter not finished yet */
+                std::mutex _mutex;                                       /**> Protects _waiting */
+                std::vector<Job*> _waiting;                              /**> Jobs that start when _pending gets to zero */
+        };
+
+        /**
+         * @param threads   Threads running jobs, the calling one included.
+         *                  0 uses one per core.
+         */
+        explicit JobSystem(uint32_t threads = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /**
+         * Queues function on the calling thread deque. signal, if any, is
+         * incremented now and decremented when the job finishes; the job
+         * doesn't start before dependency, if any, reaches zero.
+         * Can only be called from the main thread or from a job.
+         */
+        void run(std::function<void()> function, Counter* signal = nullptr, Counter* dependency = nullptr);
+
+        /**
+         * Queues function to be run by the main thread
+         */
+        void runOnMainThread(std::function<void()> function, Counter* signal = nullptr);
+
+        /**
+         * Runs function(first, last) over [0, count) in batches of batchSize
+         * spread over every thread, and returns once all of them finished
+         */
+        void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& function);
+
+        /**
+         * Runs other jobs until counter reaches zero, main thread jobs
+         * included when called from the main thread. Counters must be
+         * waited on before they are destroyed.
+         */
+        void wait(Counter& counter);
+
+        /**
+         * Runs the main thread jobs queued so far, to be called regularly
+         * by the main loop
+         */
+        void runMainThreadJobs();
+
+        uint32_t threadCount() const;
+
+        /**
+         * Index of the calling thread in [0, threadCount()), 0 being the
+         * main thread. Lets jobs use per thread data without locking.
+         */
+        uint32_t threadIndex() const;
+
+    private:
+        std::vector<std::unique_ptr<Worker>> _workers;                   /**> Deque of every thread, the main one first */
+        std::vector<std::thread> _threads;                               /**> Threads other than the main one */
+
+        std::mutex _mainMutex;                                           /**> Protects _mainJobs */
+        std::vector<Job*> _mainJobs;                                     /**> Jobs waiting for the main thread */
+
+        std::atomic<uint32_t> _queued{0};                                /**> Jobs in the deques, to wake idle threads */
+        std::atomic<bool> _quit{false};                                  /**> Tells the threads to exit */
+        std::mutex _sleepMutex;                                          /**> Used with _wake */
+        std::condition_variable _wake;                                   /**> Signals idle threads that work was queued */
+        std::atomic<uint32_t> _sleepers{0};                              /**> Threads blocked on _wake */
+
+        void _threadLoop(uint32_t index);
+        void _push(Job* job);
+        Job* _findJob(uint32_t index);
+        void _execute(Job* job);
+        void _signal(Counter* counter);
+        uint32_t _currentIndex() const;
+};
@@ -0,0 +1,72 @@
+/**
+ * @class   LightBaker
+ * @brief   Offline path tracer baking lightmaps and per vertex ambient
+ *          occlusion of a mesh on every core
+ *
+ * The scene is the mesh itself, a uniform sky and a directional sun, with
+ * one diffuse albedo for every surface. Lightmap texels store the light
+ * reflected by a white diffuse surface, so the runtime multiplies them by
+ * the surface albedo; they are addressed with the mesh uvs, which must be
+ * a unique unwrap of the mesh into [0, 1]².
+ *
+ * Every row of texels, and every vertex, uses its own random sequence,
+ * so the result doesn't depend on the number of threads.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "Mesh.hpp"
+#include <glm/gtx/bvh.hpp>
+#include <functional>
+#include <vector>
+
+class LightBaker {
+    public:
+        struct Settings {
+            uint32_t width = 512;                                        /**> Lightmap size in texels */
+            uint32_t height = 512;
+            uint32_t samples = 64;                                       /**> Paths per lightmap texel */
+            uint32_t bounces = 2;                                        /**> Indirect bounces after the first hit */
+            uint32_t dilation = 2;                                       /**> Texels grown around every chart to hide
+                                                                              seams under bilinear filtering */
+            uint32_t aoSamples = 128;                                    /**> Rays per vertex for ambient occlusion */
+            float aoDistance = 1.0f;                                     /**> Occluders further than this are ignored */
+            glm::vec3 albedo = glm::vec3(0.7f);                          /**> Diffuse reflectance of every surface */
+            glm::vec3 skyColor = glm::vec3(0.5f, 0.6f, 0.8f);            /**> Radiance of the sky */
+            glm::vec3 sunDirection = glm::vec3(-0.4f, -0.3f, -1.0f);     /**> Direction the sunlight travels */
+            glm::vec3 sunColor = glm::vec3(2.0f);                        /**> Irradiance of the sun at normal incidence */
+            uint32_t threads = 0;                                        /**> 0 uses every core */
+            uint64_t seed = 0;                                           /**> Base of the random sequences */
+        };
+
+        struct Lightmap {
+            uint32_t width;
+            uint32_t height;
+            std::vector<glm::vec4> texels;                               /**> Row major, alpha is 1 where the texel is
+                                                                              covered by the mesh and 0 otherwise */
+        };
+
+        LightBaker(const Mesh& mesh, const Settings& settings);
+
+        Lightmap bakeLightmap() const;
+
+        /**
+         * Unoccluded fraction of the hemisphere around each vertex, in
+         * [0, 1], one per position
+         */
+        std::vector<float> bakeVertexAO() const;
+
+    private:
+        const Mesh& _mesh;                                               /**> Mesh being baked, must outlive the baker */
+        Settings _settings;                                              /**> Scene and quality settings */
+        glm::bvh _bvh;                                                   /**> Hierarchy over the mesh triangles */
+        std::vector<glm::vec3> _normals;                                 /**> Vertex normals, or face normals spread to
+                                                                              the vertices when the mesh has none */
+        float _epsilon;                                                  /**> Offset of ray origins off the surfaces */
+
+        glm::vec3 _radiance(glm::vec3 position, glm::vec3 normal) const;
+        glm::vec3 _surfaceNormal(uint32_t triangle, glm::vec2 bary) const;
+        glm::vec3 _cosineSample(glm::vec3 normal) const;
+        void _parallelFor(size_t count, const std::function<void(size_t)>& function) const;
+};
@@ -0,0 +1,155 @@
+/**
+ * @class   MemoryBudget
+ * @brief   Accounts device memory per heap and evicts streamable resources
+ *          before the process goes over its budget
+ *
+ * Heap sizes are queried once the physical device is picked. Where
+ * VK_EXT_memory_budget is available the budget and the usage of the whole
+ * process are refreshed every frame; otherwise the budget is a fixed share
+ * of each heap and only the memory allocated here is known.
+ *
+ * Resources that can be loaded again, as streamed textures or meshes, are
+ * registered with an evict function. When a heap gets close to its budget
+ * the least recently used ones are evicted until it is back under a lower
+ * mark, so the driver never has to page memory out behind our back.
+ *
+ * Evict functions are called without the lock held and must retire the
+ * resource through the DeletionQueue, frames in flight may still use it.
+ *
+ * The engine has no streamed resources yet, so it never evicts;
+ * budget_bench drives eviction against a capped budget.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VulkanApi.hpp"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+class MemoryBudget {
+    public:
+        /**
+         * Usage of a memory heap, in bytes
+         */
+        struct Heap {
+            VkDeviceSize size;                                           /**> Size of the heap */
+            VkMemoryHeapFlags flags;                                     /**> VK_MEMORY_HEAP_DEVICE_LOCAL_BIT for video memory */
+            VkDeviceSize budget;                                         /**> What the process can use without paging */
+            VkDeviceSize processUsage;                                   /**> Used by the process as the driver sees it, 0 without
+                                                                              VK_EXT_memory_budget */
+            VkDeviceSize usage;                                          /**> Allocated through allocate() */
+            VkDeviceSize peakUsage;                                      /**> Highest usage so far */
+            VkDeviceSize evicting;                                       /**> Evicted and not freed yet */
+        };
+
+        /**
+         * Queries the heaps of physicalDevice. budgetExtension tells if
+         * VK_EXT_memory_budget will be enabled on the device, which needs
+         * VK_KHR_get_physical_device_properties2 enabled on instance.
+         */
+        void init(VkInstance instance, VkPhysicalDevice physicalDevice, bool budgetExtension);
+
+        /**
+         * Caps the budget of every heap, so eviction can be tried without
+         * filling the device. 0 removes the cap.
+         */
+        void limit(VkDeviceSize budget);
+
+        /**
+         * True if the budgets come from VK_EXT_memory_budget
+         */
+        bool hasBudgetExtension() const {
+            return _getMemoryProperties2 != nullptr;
+        }
+
+        /**
+         * Allocates device memory, accounted to the heap of its memory type.
+         * Streamable resources are evicted first if it would take the heap
+         * over its budget.
+         */
+        VkResult allocate(VkDevice device, const VkMemoryAllocateInfo& allocateInfo, VkDeviceMemory* memory);
+
+        /**
+         * Frees memory from allocate(), it must not go through a VDeleter
+         * or it wouldn't be accounted
+         */
+        void free(VkDevice device, VkDeviceMemory memory);
+
+        /**
+         * Registers a resource that can be evicted and loaded again later
+         *
+         * @param memoryTypeIndex   Memory type its memory was allocated from
+         * @param size              Memory it gives back when evicted
+         * @param evict             Retires the resource, see above
+         * @return Identifier for touch() and removeStreamable()
+         */
+        uint64_t addStreamable(uint32_t memoryTypeIndex, VkDeviceSize size, std::function<void()> evict);
+
+        /**
+         * Marks the resource as used by the frame being recorded, which
+         * keeps it from being evicted during the frame
+         */
+        void touch(uint64_t id);
+
+        /**
+         * Unregisters a resource its owner is destroying
+         */
+        void removeStreamable(uint64_t id);
+
+        /**
+         * Starts a frame: refreshes the budgets and evicts from the heaps
+         * that are over them
+         */
+        void beginFrame(uint64_t frame);
+
+        /**
+         * Current usage of every heap
+         */
+        std::vector<Heap> heaps();
+
+        /**
+         * Writes the usage and budget of every heap
+         */
+        void report(std::ostream& out);
+
+    private:
+        /**
+         * Resource that can be evicted, kept in _lru from the least to the
+         * most recently used
+         */
+        struct Streamable {
+            uint32_t heap;
+            VkDeviceSize size;
+            uint64_t lastUsed;                                           /**> Frame that last used it */
+            std::function<void()> evict;
+            std::list<uint64_t>::iterator lru;
+        };
+
+        struct Allocation {
+            uint32_t heap;
+            VkDeviceSize size;
+        };
+
+        VkPhysicalDevice _physicalDevice{VK_NULL_HANDLE};
+        PFN_vkGetPhysicalDeviceMemoryProperties2KHR _getMemoryProperties2{nullptr}; /**> Only set with VK_EXT_memory_budget */
+        VkPhysicalDeviceMemoryProperties _memoryProperties;
+
+        std::mutex _mutex;                                               /**> Protects everything below */
+        std::vector<Heap> _heaps;
+        std::unordered_map<VkDeviceMemory, Allocation> _allocations;     /**> Memory allocated through allocate() */
+        std::unordered_map<uint64_t, Streamable> _streamables;
+        std::list<uint64_t> _lru;                                        /**> Streamables, least recently used first */
+        uint64_t _nextStreamable{1};
+        uint64_t _frame{0};                                              /**> Frame being recorded */
+        VkDeviceSize _limit{0};                                          /**> Cap of every budget, 0 for none */
+
+        void _refreshBudgets();
+        void _evict(uint32_t heap, VkDeviceSize target, std::vector<std::function<void()>>& evicted);
+        VkDeviceSize _pressure(const Heap& heap) const;
+};
@@ -0,0 +1,18 @@
+/**
+ * @file    Mesh.hpp
+ * @brief   CPU side mesh data, as handed over by the importer
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+struct Mesh {
+    std::vector<glm::vec3> positions;                                    /**> Object space vertex positions */
+    std::vector<glm::vec3> normals;                                      /**> Unit vertex normals, empty or one per position */
+    std::vector<glm::vec2> uvs;                                          /**> Texture coordinates, empty or one per position */
+    std::vector<uint32_t> indices;                                       /**> Triangle list indices into the vertex arrays */
+};
@@ -0,0 +1,101 @@
+/**
+ * @class   PipelineStatistics
+ * @brief   Vertex, clipping and fragment counts of every render pass, read
+ *          back from pipeline statistics queries
+ *
+ * Each frame in flight gets a query per pass. The queries of a frame are
+ * reset when its command buffer is recorded, and read once its fence
+ * signals, so reading never waits on the GPU. Passes that didn't run in
+ * a frame are left out of it. A frame of counters is handed to the
+ * Profiler as counter events, next to the frame timings.
+ *
+ * Fragment invocations against the pixels of the pass tell the overdraw,
+ * vertex invocations against clipping primitives how much geometry is
+ * shaded for nothing. Needs the pipelineStatisticsQuery feature, which
+ * lavapipe has too.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "DeviceDispatch.hpp"
+#include "VDeleter.hpp"
+#include "VulkanApi.hpp"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class PipelineStatistics {
+    public:
+        /**
+         * Counts of a pass, in the order the query writes them
+         */
+        struct Counters {
+            uint64_t vertexInvocations;
+            uint64_t clippingPrimitives;                                 /**> Primitives out of the clipper, the ones rasterized */
+            uint64_t fragmentInvocations;
+        };
+
+        explicit PipelineStatistics(const VDeleter<VkDevice>& device) : _queries(device) {}
+
+        PipelineStatistics(const PipelineStatistics&) = delete;
+        PipelineStatistics& operator=(const PipelineStatistics&) = delete;
+
+        /**
+         * Creates the queries. passes are the names of the passes measured,
+         * string literals, in the order of their indices.
+         */
+        void init(const DeviceDispatch& vk, const std::vector<const char*>& passes, uint32_t framesInFlight);
+
+        /**
+         * False until init() was called, every other call does nothing then
+         */
+        bool enabled() const {
+            return _queries != VK_NULL_HANDLE;
+        }
+
+        /**
+         * Resets the queries of frame, outside any render pass and before
+         * the first begin()
+         */
+        void reset(VkCommandBuffer commandBuffer, uint32_t frame);
+
+        /**
+         * Counts the commands recorded between them into pass of frame
+         */
+        void begin(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t pass);
+        void end(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t pass);
+
+        /**
+         * Reads the counters of frame, once its fence signaled. Does
+         * nothing if it had no queries recorded since the last read.
+         */
+        void collect(uint32_t frame);
+
+        /**
+         * Counters of every pass in the last frame read, zero for the
+         * passes that didn't run
+         */
+        const std::vector<Counters>& lastFrame() const {
+            return _lastFrame;
+        }
+
+        /**
+         * Average counters per frame of every pass, and their overdraw for
+         * passes of pixels size
+         */
+        void report(std::ostream& out, uint64_t pixels) const;
+
+    private:
+        const DeviceDispatch* _vk{nullptr};
+        VDeleter<VkQueryPool> _queries;                                  /**> A query per pass per frame in flight */
+        std::vector<const char*> _passes;
+        std::vector<bool> _recorded;                                     /**> Frames with queries not read yet */
+        std::vector<Counters> _lastFrame;                                /**> By pass */
+        std::vector<Counters> _totals;                                   /**> By pass, summed over _passFrames */
+        std::vector<uint64_t> _passFrames;                               /**> By pass, frames it ran in */
+
+        uint32_t _query(uint32_t frame, uint32_t pass) const {
+            return frame * uint32_t(_passes.size()) + pass;
+        }
+};
@@ -0,0 +1,218 @@
+/**
+ * @class   Profiler
+ * @brief   CPU zones for every frame, cheap enough to stay in production
+ *          builds, streamed to a Chrome trace with the GPU time of frames
+ *
+ * A zone is a PROFILE_ZONE("name") at the top of a scope. It reads the
+ * TSC when entered and left, and pushes a single event into a lock-free
+ * ring buffer owned by the calling thread, under 50 ns altogether. A
+ * background thread drains the rings while a capture runs and writes
+ * them out as JSON for chrome://tracing or ui.perfetto.dev.
+ *
+ * Nothing is recorded outside captures. Events are dropped, and counted,
+ * when a ring is full. Names must be string literals: only the pointer
+ * is stored, and they are written to the JSON as they are.
+ *
+ * Counters, as per frame statistics, are drawn as graphs above the
+ * tracks. GPU intervals are placed on their own track. Without calibrated
+ * timestamps the GPU clock is aligned to the CPU one by assuming the GPU
+ * never starts a submission before it was submitted, which puts it at
+ * most a submission latency early.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "AlignedAllocator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class Profiler {
+    public:
+        /**
+         * Profiler shared by the whole process
+         */
+        static Profiler& instance();
+
+        ~Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        /**
+         * Timestamp in ticks of the TSC, or of the steady clock on other
+         * architectures
+         */
+        static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        /**
+         * Starts recording and streaming to path. Returns false if the
+         * file can't be written.
+         */
+        bool start(const std::string& path);
+
+        /**
+         * Writes what is left and closes the file
+         */
+        void stop();
+
+        bool capturing() const {
+            return _capturing.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Names the track of the calling thread
+         */
+        void setThreadName(const std::string& name);
+
+        /**
+         * Records a zone of the calling thread, see ProfileZone
+         */
+        void zone(const char* name, uint64_t begin, uint64_t end) {
+            if (capturing()) {
+                _threadBuffer()->push({name, begin, end});
+            }
+        }
+
+        /**
+         * Records an interval measured by GPU timestamps, in nanoseconds of
+         * the GPU clock, for work submitted at submitTicks
+         */
+        void gpuZone(const char* name, uint64_t submitTicks, uint64_t gpuBegin, uint64_t gpuEnd);
+
+        /**
+         * Records the values of the series of a counter at ticks. Names of
+         * the counter and of its series must be string literals too.
+         */
+        void counter(const char* name, uint64_t ticks, std::initializer_list<std::pair<const char*, uint64_t>> values);
+
+    private:
+        struct Event {
+            const char* name;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        struct GpuEvent {
+            const char* name;
+            uint64_t submitTicks;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        struct CounterEvent {
+            const char* name;
+            uint64_t ticks;
+            std::vector<std::pair<const char*, uint64_t>> values;
+        };
+
+        /**
+         * Single producer, single consumer ring of a thread's events. The
+         * indices written by each side are on cache lines of their own.
+         */
+        struct alignas(64) ThreadBuffer {
+            static const uint32_t kCapacity = 1 << 14;
+
+            std::atomic<uint32_t> head{0};                               /**> Next event written, by the owner */
+            alignas(64) std::atomic<uint32_t> tail{0};                   /**> Next event read, by the writer thread */
+            alignas(64) std::atomic<uint64_t> dropped{0};                /**> Events lost to a full ring */
+            uint32_t index;                                              /**> Track of the thread */
+            std::string name;                                            /**> Protected by _buffersMutex */
+            Event events[kCapacity];
+
+            void push(const Event& event) {
+                uint32_t position = head.load(std::memory_order_relaxed);
+                if (position - tail.load(std::memory_order_acquire) == kCapacity) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                events[position & (kCapacity - 1)] = event;
+                head.store(position + 1, std::memory_order_release);
+            }
+
+            static void* operator new(size_t) {
+                return AlignedAllocator<ThreadBuffer>().allocate(1);
+            }
+
+            static void operator delete(void* memory) {
+                AlignedAllocator<ThreadBuffer>().deallocate(static_cast<ThreadBuffer*>(memory), 1);
+            }
+        };
+
+        static thread_local ThreadBuffer* _currentBuffer;                /**> Ring of the calling thread, once it recorded */
+
+        std::atomic<bool> _capturing{false};
+
+        std::mutex _buffersMutex;                                        /**> Protects _buffers and thread names */
+        std::vector<std::unique_ptr<ThreadBuffer>> _buffers;             /**> Rings of every thread that recorded, kept
+                                                                              after the thread exits */
+
+        std::mutex _gpuMutex;                                            /**> Protects _gpuEvents, _gpuOffset and _counters */
+        std::vector<GpuEvent> _gpuEvents;
+        int64_t _gpuOffset{INT64_MIN};                                   /**> GPU clock to capture time, in nanoseconds */
+        std::vector<CounterEvent> _counters;                             /**> Few per frame, so not worth a ring */
+
+        std::thread _writer;                                             /**> Drains the rings into _file while capturing */
+        std::mutex _writerMutex;                                         /**> Used with _wake, protects _stopping */
+        std::condition_variable _wake;
+        bool _stopping{false};
+
+        std::ofstream _file;                                             /**> Only used by the writer thread */
+        bool _firstEvent{true};
+        uint64_t _startTicks{0};                                         /**> Capture start, ticks and time */
+        std::chrono::steady_clock::time_point _startTime;
+        double _nsPerTick{1.0};                                          /**> Calibrated again on every drain */
+
+        Profiler() = default;
+
+        ThreadBuffer* _threadBuffer();
+        void _writerLoop();
+        void _drain();
+        void _calibrate();
+        double _ticksToMicroseconds(uint64_t ticks) const;
+        void _writeEvent(const char* name, uint32_t track, double begin, double end);
+};
+
+/**
+ * Records the time between its construction and destruction
+ */
+class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name) : _name(name), _begin(Profiler::now()) {}
+
+        ~ProfileZone() {
+            Profiler::instance().zone(_name, _begin, Profiler::now());
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* _name;
+        uint64_t _begin;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(_profileZone, __LINE__)(name)
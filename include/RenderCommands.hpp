@@ -0,0 +1,116 @@
+/**
+ * @file    RenderCommands.hpp
+ * @brief   Compact draw packets written by the game code and replayed into
+ *          Vulkan by the render thread
+ *
+ * Game code, from any job thread, appends DrawPacket to the linear buffer
+ * of its thread in a RenderCommands. The render thread gathers them in a
+ * RenderCommandQueue, sorts them by key and records them, binding
+ * pipelines and meshes only when they change from one draw to the next.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "AlignedAllocator.hpp"
+#include "DeviceDispatch.hpp"
+#include "VulkanApi.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * One draw. Pipelines and meshes are indices into the tables given to
+ * RenderCommandQueue::record.
+ */
+struct DrawPacket {
+    uint64_t key;                                                        /**> Order of the draw in the frame, see RenderCommands::sortKey */
+    uint16_t pipeline;                                                   /**> Index in the pipeline table */
+    uint16_t mesh;                                                       /**> Index in the mesh table */
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+/**
+ * Geometry a packet draws
+ */
+struct RenderMesh {
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;                              /**> Bound to binding 0, none when the vertex
+                                                                              shader generates the vertices */
+    VkBuffer indexBuffer = VK_NULL_HANDLE;                               /**> Indexed draws when set */
+    VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+    uint32_t first = 0;                                                  /**> First vertex, or first index when indexed */
+    uint32_t count = 0;                                                  /**> Vertices, or indices when indexed */
+    int32_t vertexOffset = 0;                                            /**> Added to every index */
+};
+
+/**
+ * Draws of a frame, in one buffer per thread so game code never
+ * synchronizes to emit them
+ */
+class RenderCommands {
+    public:
+        /**
+         * Key drawing by pass first, then by pipeline and mesh so binds are
+         * shared, and then front to back by depth (24 bits, 0 is nearest)
+         */
+        static uint64_t sortKey(uint8_t pass, uint16_t pipeline, uint16_t mesh, uint32_t depth);
+
+        /**
+         * Empties every buffer, keeping their memory, and sets the number
+         * of threads writing to them
+         */
+        void reset(uint32_t threads);
+
+        /**
+         * Appends a draw to the buffer of thread, which only the thread
+         * with that JobSystem index may use
+         */
+        void draw(uint32_t thread, uint64_t key, uint16_t pipeline, uint16_t mesh,
+                  uint32_t firstInstance = 0, uint32_t instanceCount = 1);
+
+        size_t size() const;
+
+    private:
+        friend class RenderCommandQueue;
+
+        /**
+         * A cache line each, so threads appending to neighbour buffers
+         * don't share one
+         */
+        struct alignas(64) ThreadPackets {
+            std::vector<DrawPacket> packets;
+        };
+
+        std::vector<ThreadPackets, AlignedAllocator<ThreadPackets>> _threads; /**> Buffer of every job thread */
+};
+
+/**
+ * Sorted draws of the frame being recorded, owned by the render thread
+ */
+class RenderCommandQueue {
+    public:
+        struct Stats {
+            uint32_t draws = 0;
+            uint32_t pipelineBinds = 0;
+            uint32_t meshBinds = 0;
+        };
+
+        /**
+         * Gathers the packets of every thread and radix sorts them by key
+         */
+        void sort(const RenderCommands& commands);
+
+        /**
+         * Records the sorted draws into commandBuffer, inside a render pass
+         * compatible with every pipeline, through the functions of vk. Binds
+         * already in place are skipped.
+         */
+        Stats record(const DeviceDispatch& vk, VkCommandBuffer commandBuffer, const std::vector<VkPipeline>& pipelines,
+                     const std::vector<RenderMesh>& meshes) const;
+
+        const std::vector<DrawPacket>& packets() const;
+
+    private:
+        std::vector<DrawPacket> _packets;                                /**> Draws in key order after sort() */
+        std::vector<DrawPacket> _scratch;                                /**> Second buffer of the radix sort */
+};
@@ -0,0 +1,95 @@
+/**
+ * @class   StartupTrace
+ * @brief   Timestamps of the startup steps and of the loader and driver
+ *          calls they make, dumped as a Chrome trace and a summary table
+ *
+ * Events are kept in memory under a lock, which is fine for the few
+ * hundred of them a startup makes but not for per frame zones. Open the
+ * JSON in chrome://tracing or ui.perfetto.dev.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class StartupTrace {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        /**
+         * Records the time between its construction and destruction
+         */
+        class Scope {
+            public:
+                Scope(StartupTrace& trace, const char* name, const char* category)
+                    : _trace(trace), _name(name), _category(category), _start(Clock::now()) {}
+
+                ~Scope() {
+                    _trace.record(_name, _category, _start, Clock::now());
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+                StartupTrace& _trace;
+                const char* _name;
+                const char* _category;
+                Clock::time_point _start;
+        };
+
+        /**
+         * Times are relative to the construction of the trace
+         */
+        StartupTrace();
+
+        StartupTrace(const StartupTrace&) = delete;
+        StartupTrace& operator=(const StartupTrace&) = delete;
+
+        /**
+         * Adds an event run by the calling thread
+         */
+        void record(const std::string& name, const char* category, Clock::time_point start, Clock::time_point end);
+
+        /**
+         * Runs a loader or driver call and records it, returning its result
+         */
+        template <typename Function>
+        auto call(const char* name, Function function) -> decltype(function()) {
+            Scope scope(*this, name, "call");
+            return function();
+        }
+
+        /**
+         * Writes the events in Chrome trace event format
+         */
+        void writeChromeTrace(std::ostream& out);
+
+        /**
+         * Writes calls, total and longest time of every event name, the
+         * most expensive first
+         */
+        void report(std::ostream& out);
+
+    private:
+        struct Event {
+            std::string name;
+            const char* category;
+            double start;                                                /**> Microseconds since _origin */
+            double duration;                                             /**> Microseconds */
+            uint32_t thread;                                             /**> Index in _threads */
+        };
+
+        Clock::time_point _origin;
+        std::mutex _mutex;                                               /**> Protects everything below */
+        std::vector<Event> _events;
+        std::vector<std::thread::id> _threads;                           /**> Threads that recorded events, the first one the
+                                                                              one that constructed the trace */
+};
@@ -0,0 +1,97 @@
+/**
+ * @class   TaskGraph
+ * @brief   Named tasks with dependencies, run as soon as what they need is
+ *          done and timed
+ *
+ * Tasks are added after the tasks they depend on, so the graph can't
+ * have cycles. run() queues every task without dependencies on the
+ * JobSystem; each finished task queues the dependents it was the last
+ * dependency of. Tasks calling GLFW go to the main thread.
+ *
+ * The first exception thrown by a task is rethrown by run(), once every
+ * task not depending on the failed one has finished.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "JobSystem.hpp"
+#include "StartupTrace.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class TaskGraph {
+    public:
+        typedef uint32_t Task;
+
+        /**
+         * When a task ran, in milliseconds since run() was called
+         */
+        struct Timing {
+            std::string name;
+            double start;
+            double end;
+            uint32_t thread;                                             /**> JobSystem thread index, 0 for the main thread */
+        };
+
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        /**
+         * Adds a task that runs once every task in dependencies is done
+         *
+         * @param onMainThread  Runs it on the main thread, for GLFW calls
+         */
+        Task add(const std::string& name, std::function<void()> function, const std::vector<Task>& dependencies = {},
+                 bool onMainThread = false);
+
+        /**
+         * Runs every task and returns once they are all done. Must be
+         * called from the main thread. Tasks are also recorded in trace, if
+         * given, as "step" events.
+         */
+        void run(JobSystem& jobs, StartupTrace* trace = nullptr);
+
+        /**
+         * Timings of the tasks that ran, in the order they were added
+         */
+        std::vector<Timing> timings() const;
+
+        /**
+         * Total time, critical path and timings of the last run
+         */
+        void report(std::ostream& out) const;
+
+    private:
+        struct Node {
+            std::string name;
+            std::function<void()> function;
+            bool onMainThread;
+            std::vector<Task> dependencies;
+            std::vector<Task> dependents;
+            std::atomic<uint32_t> pending{0};                            /**> Dependencies not done yet */
+            bool ran{false};
+            Timing timing;
+        };
+
+        std::vector<std::unique_ptr<Node>> _nodes;
+        JobSystem* _jobs{nullptr};
+        StartupTrace* _trace{nullptr};
+        JobSystem::Counter _done;                                        /**> Signaled by every task queued */
+        std::chrono::steady_clock::time_point _start;
+        double _total{0.0};                                              /**> Duration of the last run, in milliseconds */
+        std::mutex _errorMutex;                                          /**> Protects _error */
+        std::exception_ptr _error;                                       /**> First exception thrown by a task */
+
+        void _queue(Task task);
+        void _execute(Task task);
+};
@@ -0,0 +1,72 @@
+/**
+ * @class   TripleBuffer
+ * @brief   Lock free handoff of whole values from one producer thread to
+ *          one consumer thread
+ *
+ * The producer fills back() and publishes it, the consumer picks up the
+ * latest published value with update() and reads it through front(). The
+ * third buffer sits between them, so neither side ever waits for the
+ * other and a value is never written while it is being read. Values the
+ * consumer didn't pick up in time are overwritten by newer ones.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class TripleBuffer {
+    public:
+        /**
+         * Buffer owned by the producer, to be filled before publish()
+         */
+        T& back() {
+            return _buffers[_back];
+        }
+
+        /**
+         * Makes back() the latest value and hands the producer a free buffer,
+         * which holds an older value and must be filled again entirely
+         */
+        void publish() {
+            _back = _middle.exchange(_back | kFresh, std::memory_order_acq_rel) & kIndex;
+        }
+
+        /**
+         * True when a value was published after the last update()
+         */
+        bool pending() const {
+            return (_middle.load(std::memory_order_acquire) & kFresh) != 0;
+        }
+
+        /**
+         * Moves front() to the latest published value, false if there is
+         * none newer than the current one
+         */
+        bool update() {
+            if (!pending()) {
+                return false;
+            }
+            _front = _middle.exchange(_front, std::memory_order_acq_rel) & kIndex;
+            return true;
+        }
+
+        /**
+         * Buffer owned by the consumer, valid until the next update()
+         */
+        const T& front() const {
+            return _buffers[_front];
+        }
+
+    private:
+        static const uint8_t kIndex = 0x3;
+        static const uint8_t kFresh = 0x4;
+
+        T _buffers[3];                                                   /**> Values being written, handed over and read */
+        alignas(64) uint8_t _back{0};                                    /**> Producer side buffer */
+        alignas(64) std::atomic<uint8_t> _middle{1};                     /**> Buffer in between, with kFresh when it holds
+                                                                              a value the consumer hasn't seen */
+        alignas(64) uint8_t _front{2};                                   /**> Consumer side buffer */
+};
@@ -3,40 +3,160 @@
  * @brief   Utility class to automatically delete Vulkan handles when
  *          they go out of scope
  *
+ * How a handle is destroyed is a compile time policy, VDeleterPolicy<T>
+ * by default, so the wrapper only holds the handle and, for handles
+ * created from an instance or a device, a pointer to the VDeleter owning
+ * that parent. Parents must outlive their children and must not be moved
+ * while they have any.
+ *
+ * Wrappers are move only, a handle always has a single owner.
+ *
  * @author	Roberto Cano (http://www.robertocano.es)
  */
 #pragma once
 
+#include "HostAllocator.hpp"
 #include "VulkanApi.hpp"
-#include <functional>
+#include <memory>
+#include <type_traits>
+
+/**
+ * Policies pick the destroy function by handle type, which needs every
+ * handle to have its own type. Non dispatchable handles are all uint64_t
+ * on 32 bit builds.
+ */
+static_assert(sizeof(void*) == 8, "VDeleter needs a 64 bit build");
+
+/**
+ * Policy for handles destroyed on their own. Parent is void. Type is the
+ * object type they were created with host allocations tagged as.
+ */
+template <typename T, VkObjectType Type, void (VKAPI_PTR *Destroy)(T, const VkAllocationCallbacks*)>
+struct VRootPolicy {
+    typedef void Parent;
+    static const VkObjectType kType = Type;
+
+    static void destroy(T object) {
+        Destroy(object, hostAllocator(Type));
+    }
+};
+
+/**
+ * Policy for handles destroyed through the instance or device, P, that
+ * created them
+ */
+template <typename P, typename T, VkObjectType Type, void (VKAPI_PTR *Destroy)(P, T, const VkAllocationCallbacks*)>
+struct VChildPolicy {
+    typedef P Parent;
+    static const VkObjectType kType = Type;
+
+    static void destroy(P parent, T object) {
+        Destroy(parent, object, hostAllocator(Type));
+    }
+};
 
 template <typename T>
-class VDeleter {
+struct VDeleterPolicy;
+
+template <> struct VDeleterPolicy<VkInstance> : VRootPolicy<VkInstance, VK_OBJECT_TYPE_INSTANCE, vkDestroyInstance> {};
+template <> struct VDeleterPolicy<VkDevice> : VRootPolicy<VkDevice, VK_OBJECT_TYPE_DEVICE, vkDestroyDevice> {};
+
+template <> struct VDeleterPolicy<VkSurfaceKHR> : VChildPolicy<VkInstance, VkSurfaceKHR, VK_OBJECT_TYPE_SURFACE_KHR, vkDestroySurfaceKHR> {};
+
+template <> struct VDeleterPolicy<VkSwapchainKHR> : VChildPolicy<VkDevice, VkSwapchainKHR, VK_OBJECT_TYPE_SWAPCHAIN_KHR, vkDestroySwapchainKHR> {};
+template <> struct VDeleterPolicy<VkImage> : VChildPolicy<VkDevice, VkImage, VK_OBJECT_TYPE_IMAGE, vkDestroyImage> {};
+template <> struct VDeleterPolicy<VkImageView> : VChildPolicy<VkDevice, VkImageView, VK_OBJECT_TYPE_IMAGE_VIEW, vkDestroyImageView> {};
+template <> struct VDeleterPolicy<VkBuffer> : VChildPolicy<VkDevice, VkBuffer, VK_OBJECT_TYPE_BUFFER, vkDestroyBuffer> {};
+template <> struct VDeleterPolicy<VkBufferView> : VChildPolicy<VkDevice, VkBufferView, VK_OBJECT_TYPE_BUFFER_VIEW, vkDestroyBufferView> {};
+template <> struct VDeleterPolicy<VkDeviceMemory> : VChildPolicy<VkDevice, VkDeviceMemory, VK_OBJECT_TYPE_DEVICE_MEMORY, vkFreeMemory> {};
+template <> struct VDeleterPolicy<VkSampler> : VChildPolicy<VkDevice, VkSampler, VK_OBJECT_TYPE_SAMPLER, vkDestroySampler> {};
+template <> struct VDeleterPolicy<VkShaderModule> : VChildPolicy<VkDevice, VkShaderModule, VK_OBJECT_TYPE_SHADER_MODULE, vkDestroyShaderModule> {};
+template <> struct VDeleterPolicy<VkPipelineCache> : VChildPolicy<VkDevice, VkPipelineCache, VK_OBJECT_TYPE_PIPELINE_CACHE, vkDestroyPipelineCache> {};
+template <> struct VDeleterPolicy<VkPipelineLayout> : VChildPolicy<VkDevice, VkPipelineLayout, VK_OBJECT_TYPE_PIPELINE_LAYOUT, vkDestroyPipelineLayout> {};
+template <> struct VDeleterPolicy<VkPipeline> : VChildPolicy<VkDevice, VkPipeline, VK_OBJECT_TYPE_PIPELINE, vkDestroyPipeline> {};
+template <> struct VDeleterPolicy<VkDescriptorSetLayout> : VChildPolicy<VkDevice, VkDescriptorSetLayout, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, vkDestroyDescriptorSetLayout> {};
+template <> struct VDeleterPolicy<VkDescriptorPool> : VChildPolicy<VkDevice, VkDescriptorPool, VK_OBJECT_TYPE_DESCRIPTOR_POOL, vkDestroyDescriptorPool> {};
+template <> struct VDeleterPolicy<VkRenderPass> : VChildPolicy<VkDevice, VkRenderPass, VK_OBJECT_TYPE_RENDER_PASS, vkDestroyRenderPass> {};
+template <> struct VDeleterPolicy<VkFramebuffer> : VChildPolicy<VkDevice, VkFramebuffer, VK_OBJECT_TYPE_FRAMEBUFFER, vkDestroyFramebuffer> {};
+template <> struct VDeleterPolicy<VkCommandPool> : VChildPolicy<VkDevice, VkCommandPool, VK_OBJECT_TYPE_COMMAND_POOL, vkDestroyCommandPool> {};
+template <> struct VDeleterPolicy<VkSemaphore> : VChildPolicy<VkDevice, VkSemaphore, VK_OBJECT_TYPE_SEMAPHORE, vkDestroySemaphore> {};
+template <> struct VDeleterPolicy<VkFence> : VChildPolicy<VkDevice, VkFence, VK_OBJECT_TYPE_FENCE, vkDestroyFence> {};
+template <> struct VDeleterPolicy<VkEvent> : VChildPolicy<VkDevice, VkEvent, VK_OBJECT_TYPE_EVENT, vkDestroyEvent> {};
+template <> struct VDeleterPolicy<VkQueryPool> : VChildPolicy<VkDevice, VkQueryPool, VK_OBJECT_TYPE_QUERY_POOL, vkDestroyQueryPool> {};
+
+/**
+ * Extension function, not exported by the loader, so it is looked up
+ */
+template <> struct VDeleterPolicy<VkDebugUtilsMessengerEXT> {
+    typedef VkInstance Parent;
+    static const VkObjectType kType = VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT;
+
+    static void destroy(VkInstance instance, VkDebugUtilsMessengerEXT messenger) {
+        auto func = (PFN_vkDestroyDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
+        if (func != nullptr) {
+            func(instance, messenger, hostAllocator(kType));
+        }
+    }
+};
+
+template <typename T, typename Policy = VDeleterPolicy<T>>
+class VDeleter;
+
+/**
+ * Pointer to the parent wrapper, empty for handles without one
+ */
+template <typename P>
+class VDeleterParent {
+protected:
+    VDeleterParent() = default;
+    explicit VDeleterParent(const VDeleter<P>* parent) : _parent(parent) {}
+
+    const VDeleter<P>* _parent{nullptr}; /**< Wrapper owning the instance or device the handle belongs to */
+};
+
+template <>
+class VDeleterParent<void> {
+};
+
+template <typename T, typename Policy>
+class VDeleter : private VDeleterParent<typename Policy::Parent> {
 public:
+    typedef typename Policy::Parent Parent;
+
     /**
-     * Constructor for generic _deleter with empty deletion function
+     * Constructor for handles without a parent
      */
-    VDeleter() : VDeleter([](T, VkAllocationCallbacks*) {}) {}
+    VDeleter() {
+        static_assert(std::is_void<Parent>::value, "This handle type needs its parent at construction");
+    }
 
     /**
-     * Constructor for deletion functions with 2 parameters
+     * Constructor for handles created from an instance or a device. parent
+     * may still be empty, it is only read when the handle is destroyed.
      */
-    VDeleter(std::function<void(T, VkAllocationCallbacks*)> deletef) {
-        this->_deleter = [=](T obj) { deletef(obj, nullptr); };
-    }
+    explicit VDeleter(const VDeleter<Parent>& parent) : VDeleterParent<Parent>(&parent) {}
+
+    VDeleter(const VDeleter&) = delete;
+    VDeleter& operator=(const VDeleter&) = delete;
 
     /**
-     * Specialized constructor for Vulkan instances
+     * Move constructor, other is left empty
      */
-    VDeleter(const VDeleter<VkInstance>& instance, std::function<void(VkInstance, T, VkAllocationCallbacks*)> deletef) {
-        this->_deleter = [&instance, deletef](T obj) { deletef(instance, obj, nullptr); };
+    VDeleter(VDeleter&& other) noexcept : VDeleterParent<Parent>(other), _object(other._object) {
+        other._object = VK_NULL_HANDLE;
     }
 
     /**
-     * Specialized constructor for Vulkan devices
+     * Move assignment, the current handle is destroyed and other is left empty
      */
-    VDeleter(const VDeleter<VkDevice>& device, std::function<void(VkDevice, T, VkAllocationCallbacks*)> deletef) {
-        this->_deleter = [&device, deletef](T obj) { deletef(device, obj, nullptr); };
+    VDeleter& operator=(VDeleter&& other) noexcept {
+        if (this != std::addressof(other)) {
+            _cleanup();
+            VDeleterParent<Parent>::operator=(other);
+            _object = other._object;
+            other._object = VK_NULL_HANDLE;
+        }
+        return *this;
     }
 
     /**
@@ -56,6 +176,23 @@ public:
         return &_object;
     }
 
+    /**
+     * Gives up ownership of the handle without destroying it, the wrapper
+     * is left empty
+     */
+    T release() {
+        T object = _object;
+        _object = VK_NULL_HANDLE;
+        return object;
+    }
+
+    /**
+     * Instance or device the handle belongs to, for handles with a parent
+     */
+    Parent parent() const {
+        return *this->_parent;
+    }
+
     /**
      * Cast operator
      */
@@ -81,15 +218,22 @@ public:
 
 private:
     T _object{VK_NULL_HANDLE};       /**< Internal object handle managed by the class */
-    std::function<void(T)> _deleter; /**< Lambda function to delete the handle */
 
     /**
      * Cleanup function to delete the internal object
      */
     void _cleanup() {
         if (_object != VK_NULL_HANDLE) {
-            _deleter(_object);
+            _destroy(std::is_void<Parent>());
         }
         _object = VK_NULL_HANDLE;
     }
+
+    void _destroy(std::true_type /* no parent */) {
+        Policy::destroy(_object);
+    }
+
+    void _destroy(std::false_type /* parent */) {
+        Policy::destroy(*this->_parent, _object);
+    }
 };
@@ -0,0 +1,54 @@
+/**
+ * @class   VertexQuantizer
+ * @brief   Compresses mesh vertex attributes before upload and describes
+ *          the resulting layout to the graphics pipeline
+ *
+ * Each attribute goes to its own tightly packed stream and binding:
+ *   - location 0: positions, 16 bits unorm relative to the mesh bounds (8 bytes)
+ *   - location 1: normals, 10_10_10_2 snorm, or 8 bits snorm where the
+ *                 device can't fetch 10_10_10_2 vertices (4 bytes)
+ *   - location 2: uvs, half float or 16 bits unorm (4 bytes)
+ * which is 16 bytes per vertex instead of 32.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#pragma once
+
+#include "VulkanApi.hpp"
+#include "Mesh.hpp"
+#include <vector>
+
+class VertexQuantizer {
+    public:
+        /**
+         * Encoding for texture coordinates: unorm16 has more precision but
+         * clamps to [0, 1], half float keeps tiling coordinates
+         */
+        enum class UVFormat {
+            HALF,
+            UNORM16
+        };
+
+        /**
+         * Quantized streams, ready to be copied into vertex buffers
+         */
+        struct QuantizedMesh {
+            std::vector<uint16_t> positions;                             /**> xyzw per vertex, w is always 1 */
+            std::vector<uint32_t> normals;                               /**> One packed normal per vertex */
+            std::vector<uint32_t> uvs;                                   /**> One packed uv pair per vertex */
+            glm::mat4 dequantize;                                        /**> Maps unorm positions back to object space,
+                                                                              to be folded into the model matrix */
+            std::vector<VkVertexInputBindingDescription> bindings;       /**> One binding per non empty stream */
+            std::vector<VkVertexInputAttributeDescription> attributes;   /**> Attribute for each binding */
+        };
+
+        VertexQuantizer(VkPhysicalDevice physicalDevice, UVFormat uvFormat = UVFormat::HALF);
+
+        QuantizedMesh quantize(const Mesh& mesh) const;
+
+    private:
+        UVFormat _uvFormat;                                              /**> Encoding used for texture coordinates */
+        VkFormat _normalFormat;                                          /**> Encoding used for normals */
+
+        static bool _supportsVertexFormat(VkPhysicalDevice physicalDevice, VkFormat format);
+};
@@ -8,6 +8,22 @@
 
 #include "VulkanApi.hpp"
 #include "VDeleter.hpp"
+#include "DeletionQueue.hpp"
+#include "DeviceDispatch.hpp"
+#include "DynamicResolution.hpp"
+#include "JobSystem.hpp"
+#include "MemoryBudget.hpp"
+#include "PipelineStatistics.hpp"
+#include "RenderCommands.hpp"
+#include "StartupTrace.hpp"
+#include "TripleBuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 class VulkanEngine {
@@ -17,16 +33,48 @@ class VulkanEngine {
     private:
         const uint32_t WIDTH = 800;
         const uint32_t HEIGHT = 600;
+        const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
+        /**
+         * Everything the render thread needs from the simulation to draw a
+         * frame. It is handed over as a whole, so the render thread never
+         * sees a frame the simulation is still working on.
+         */
+        struct FrameState {
+            uint64_t frame = 0;                                              /**> Number of the simulated frame */
+            double time = 0.0;                                               /**> Simulation time in seconds */
+            double deltaTime = 0.0;                                          /**> Time simulated since the previous frame */
+            RenderCommands commands;                                         /**> Draws of the frame, emitted by the game code */
+        };
+
+        JobSystem _jobs;                                                     /**> Scheduler for the work spread over every core */
+
+        TripleBuffer<FrameState> _frameStates;                               /**> Snapshots from the simulation to the render thread */
+        std::thread _renderThread;                                           /**> Records and submits the frames */
+        std::mutex _frameMutex;                                              /**> Used with _frameReady and _frameTaken, only to sleep */
+        std::condition_variable _frameReady;                                 /**> Signals the render thread a snapshot was published */
+        std::condition_variable _frameTaken;                                 /**> Signals the simulation the render thread took it */
+        std::atomic<bool> _quit{false};                                      /**> Stops both threads */
+        std::exception_ptr _renderError;                                     /**> Exception that stopped the render thread, if any */
+
+        std::chrono::steady_clock::time_point _startTime;                    /**> When run() was called */
+        StartupTrace _startupTrace;                                          /**> Startup steps and calls, dumped after the first frame */
+        bool _firstFrame{true};                                              /**> No frame presented yet, only used by the render thread */
 
         GLFWwindow* _window{NULL};                                           /**> GLFW Window handle */
-        VDeleter<VkInstance> _instance {vkDestroyInstance};                  /**> Main Vulkan instance */
-        VDeleter<VkDebugReportCallbackEXT>
-            _callbackHandle{_instance, DestroyDebugReportCallbackEXT};       /**> Callback handle for the validation layers */
-        VDeleter<VkSurfaceKHR> _surface{_instance, vkDestroySurfaceKHR};     /**> Vulkan window surface */
+        VDeleter<VkInstance> _instance;                                      /**> Main Vulkan instance */
+        VDeleter<VkDebugUtilsMessengerEXT> _debugMessenger{_instance};       /**> Callback handle for the validation layers */
+        VDeleter<VkSurfaceKHR> _surface{_instance};                          /**> Vulkan window surface */
+
+        bool _physicalDeviceProperties2{false};                              /**> VK_KHR_get_physical_device_properties2 is enabled */
 
         VkPhysicalDevice _physicalDevice{VK_NULL_HANDLE};                    /**> Vulkan physical device */
-        VDeleter<VkDevice> _device{vkDestroyDevice};                         /**> Vulkan logical device */
-        VDeleter<VkSwapchainKHR> _swapChain{_device, vkDestroySwapchainKHR}; /**> Swap chain for the logical device */
+        MemoryBudget _memoryBudget;                                          /**> Device memory usage and budget of every heap */
+        VDeleter<VkDevice> _device;                                          /**> Vulkan logical device */
+        VkPhysicalDeviceFeatures _enabledFeatures{};                         /**> Optional features enabled on _device */
+        DeviceDispatch _vk;                                                  /**> Functions of _device, called without the loader */
+        DeletionQueue _deletionQueue{MAX_FRAMES_IN_FLIGHT};                  /**> Objects waiting for the frames using them to complete */
+        VDeleter<VkSwapchainKHR> _swapChain{_device};                        /**> Swap chain for the logical device */
 
         VkQueue _graphicsQueue;                                              /**> Graphics commands queue */
         VkQueue _presentQueue;                                               /**> Presentation commands queue */
@@ -39,21 +87,59 @@ class VulkanEngine {
         std::vector<VDeleter<VkImageView>> _swapChainImageViews;             /**> View for the swap chain images, used
                                                                                   to access the actual image */
 
-        VDeleter<VkRenderPass> _renderPass{_device, vkDestroyRenderPass};    /**> Render pass??? */
-        VDeleter<VkPipelineLayout>
-            _pipelineLayout{_device, vkDestroyPipelineLayout};               /**> Layout for the graphics pipeline */
-        VDeleter<VkPipeline> _graphicsPipeline{_device, vkDestroyPipeline};  /**> Graphics pipeline instance */
+        /**
+         * Image rendered to besides the swap chain, as big as its images
+         */
+        struct Attachment {
+            VDeleter<VkImage> image;
+            VkDeviceMemory memory{VK_NULL_HANDLE};                           /**> Allocated and freed through _memoryBudget */
+            VDeleter<VkImageView> view;
+
+            explicit Attachment(const VDeleter<VkDevice>& device) : image(device), view(device) {}
+        };
+
+        bool _depthPrepass{false};                                           /**> Depth is laid down by a depth only subpass first */
+        VkFormat _depthFormat;                                               /**> Format of the depth buffer */
+        Attachment _depthAttachment{_device};                                /**> Depth buffer, shared by the frames in flight */
+        VkSampleCountFlagBits _msaaSamples{VK_SAMPLE_COUNT_1_BIT};           /**> Samples of the color and depth attachments */
+        Attachment _colorAttachment{_device};                                /**> Multisampled color, resolved to the output of
+                                                                                  the pass. Unused without MSAA */
+        DynamicResolution _dynamicResolution;                                /**> Resolution of every frame, full if not enabled */
+        Attachment _sceneAttachment{_device};                                /**> Output of the pass, upscaled to the swap chain
+                                                                                  image. Only with dynamic resolution */
+        VkFilter _upscaleFilter{VK_FILTER_LINEAR};                           /**> Filter of the upscale, linear if the format
+                                                                                  supports it */
+
+        VDeleter<VkRenderPass> _renderPass{_device};                         /**> Render pass??? */
+        VDeleter<VkPipelineLayout> _pipelineLayout{_device};                 /**> Layout for the graphics pipeline */
+        VDeleter<VkPipeline> _graphicsPipeline{_device};                     /**> Graphics pipeline instance */
+        VDeleter<VkPipeline> _depthPipeline{_device};                        /**> Depth only version of it, for the prepass */
+        std::vector<char> _vertShaderCode;                                   /**> SPIR-V of the shaders, loaded while the device */
+        std::vector<char> _fragShaderCode;                                   /**> is created */
 
         std::vector<VDeleter<VkFramebuffer>> _swapChainFramebuffers;         /**> Framebuffers associated with the swap chain */
 
-        VDeleter<VkCommandPool> _commandPool{_device, vkDestroyCommandPool}; /**> Command pool used to allocate command buffers */
-        std::vector<VkCommandBuffer> _commandBuffers;                        /**> Command buffers to hold presentation and graphics commands */
+        VDeleter<VkCommandPool> _commandPool{_device};                       /**> Command pool used to allocate command buffers */
+        std::vector<VkCommandBuffer> _commandBuffers;                        /**> Command buffer of every frame in flight, recorded
+                                                                                  again each frame */
 
-        VDeleter<VkSemaphore>
-            _imageAvailableSemaphore{_device, vkDestroySemaphore};           /**> Semaphore used to signal availability of a swap chain image */
-        VDeleter<VkSemaphore>
-            _renderFinishedSemaphore{_device, vkDestroySemaphore};           /**> Semaphore used to signal that render has been finished, so
+        std::vector<VDeleter<VkSemaphore>> _imageAvailableSemaphores;        /**> Semaphores used to signal availability of a swap chain image */
+        std::vector<VDeleter<VkSemaphore>> _renderFinishedSemaphores;        /**> Semaphores used to signal that render has been finished, so
                                                                                   image can be presented */
+        std::vector<VDeleter<VkFence>> _inFlightFences;                      /**> Signaled when the GPU is done with a frame */
+
+        VDeleter<VkQueryPool> _timestampQueries{_device};                    /**> Begin and end timestamps of every frame in flight */
+        uint64_t _timestampMask{0};                                          /**> Valid bits of the timestamps, 0 if not supported */
+        double _timestampPeriod{1.0};                                        /**> Nanoseconds per timestamp tick */
+        std::vector<uint64_t> _submitTicks;                                  /**> Profiler time each frame in flight was submitted,
+                                                                                  0 if it has no timestamps to read */
+        PipelineStatistics _pipelineStatistics{_device};                     /**> Shader work of every pass, if enabled */
+        uint32_t _currentFrame = 0;                                          /**> Frame in flight being recorded */
+
+        std::vector<VkPipeline> _pipelines;                                  /**> Pipelines the draw packets refer to */
+        std::vector<VkPipeline> _depthPipelines;                             /**> Their depth only versions, by the same index */
+        std::vector<RenderMesh> _meshes;                                     /**> Meshes the draw packets refer to */
+        RenderCommandQueue _renderQueue;                                     /**> Sorted draws of the frame being recorded */
 
         const std::vector<const char*> _validationLayers = {                 /**> List of validation layers to be enabled */
             "VK_LAYER_LUNARG_standard_validation"
@@ -84,9 +170,13 @@ class VulkanEngine {
             std::vector<VkPresentModeKHR> presentModes;
         };
 
+        void _initGlfw();
         void _initWindow();
         void _initVulkan();
         void _mainLoop();
+        void _simulate(FrameState& state);
+        void _renderLoop();
+        void _stopRenderThread();
         void _createInstance();
         void _createLogicalDevice();
         void _createSurface();
@@ -94,8 +184,10 @@ class VulkanEngine {
         std::vector<const char*> _getRequiredExtensions();
         void _setupDebugCallback();
         void _pickPhysicalDevice();
-        bool _isDeviceSuitable(VkPhysicalDevice device);
+        bool _isDeviceSuitable(VkPhysicalDevice device, std::string& reason);
+        uint64_t _rateDevice(VkPhysicalDevice device);
         bool _checkDeviceExtensionsSupport(VkPhysicalDevice device);
+        bool _hasDeviceExtension(VkPhysicalDevice device, const char* name);
         QueueFamilyIndices _findQueueFamilies(VkPhysicalDevice device);
         SwapChainSupportDetails _querySwapChainSupport(VkPhysicalDevice device);
         VkSurfaceFormatKHR _chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -104,27 +196,37 @@ class VulkanEngine {
         void _createSwapChain();
         void _createImageViews();
         void _createGraphicsPipeline();
+        void _loadShaders();
         void _createShaderModule(const std::vector<char>& code, VDeleter<VkShaderModule>& shaderModule);
         void _createRenderPass();
+        VkFormat _findDepthFormat();
+        VkSampleCountFlagBits _chooseSampleCount();
+        uint32_t _findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, VkMemoryPropertyFlags preferred = 0);
+        void _createAttachment(Attachment& attachment, VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage,
+                               VkImageAspectFlags aspect, const std::string& name);
+        void _destroyAttachment(Attachment& attachment);
+        void _createDepthResources();
+        void _createColorResources();
         void _createFramebuffers();
         void _createCommandPool();
         void _createCommandBuffers();
-        void _drawFrame();
-        void _createSemaphores();
+        void _recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+        void _recordUpscale(VkCommandBuffer commandBuffer, VkImage swapChainImage, VkExtent2D renderExtent);
+        void _drawFrame(const FrameState& state);
+        void _createSyncObjects();
+        uint32_t _timestampValidBits();
+        void _createTimestampQueries();
+        void _createStatisticsQueries();
+        void _readTimestamps(uint32_t frame);
 
         static std::vector<char> _readFile(const std::string& filename);
         static VKAPI_ATTR VkBool32 VKAPI_CALL _debugCallback(
-                VkDebugReportFlagsEXT flags,
-                VkDebugReportObjectTypeEXT objType,
-                uint64_t obj,
-                size_t location,
-                int32_t code,
-                const char* layerPrefix,
-                const char* msg,
+                VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+                VkDebugUtilsMessageTypeFlagsEXT types,
+                const VkDebugUtilsMessengerCallbackDataEXT* callbackData,
                 void* userData);
-        static VkResult CreateDebugReportCallbackEXT(VkInstance instance,
-                const VkDebugReportCallbackCreateInfoEXT* pCreateInfo,
+        static VkResult CreateDebugUtilsMessengerEXT(VkInstance instance,
+                const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
                 const VkAllocationCallbacks* pAllocator,
-                VkDebugReportCallbackEXT* pCallback);
-        static void DestroyDebugReportCallbackEXT(VkInstance instance, VkDebugReportCallbackEXT callback, const VkAllocationCallbacks* pAllocator);
+                VkDebugUtilsMessengerEXT* pMessenger);
 };
@@ -0,0 +1,50 @@
+/**
+ * @class   DebugUtils
+ * @brief   VK_EXT_debug_utils object names and command buffer labels, so
+ *          validation messages and frame captures show what is what
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "DebugUtils.hpp"
+
+DebugUtils& DebugUtils::instance() {
+    static DebugUtils debugUtils;
+    return debugUtils;
+}
+
+void DebugUtils::load(VkInstance instance) {
+    /* Instance level, so they work for any device and go through the layers */
+    _setObjectName = (PFN_vkSetDebugUtilsObjectNameEXT) vkGetInstanceProcAddr(instance, "vkSetDebugUtilsObjectNameEXT");
+    _cmdBeginLabel = (PFN_vkCmdBeginDebugUtilsLabelEXT) vkGetInstanceProcAddr(instance, "vkCmdBeginDebugUtilsLabelEXT");
+    _cmdEndLabel = (PFN_vkCmdEndDebugUtilsLabelEXT) vkGetInstanceProcAddr(instance, "vkCmdEndDebugUtilsLabelEXT");
+}
+
+void DebugUtils::setName(VkDevice device, VkObjectType objectType, uint64_t handle, const char* name) const {
+    if (!_setObjectName) {
+        return;
+    }
+
+    VkDebugUtilsObjectNameInfoEXT nameInfo = {};
+    nameInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+    nameInfo.objectType = objectType;
+    nameInfo.objectHandle = handle;
+    nameInfo.pObjectName = name;
+    _setObjectName(device, &nameInfo);
+}
+
+void DebugUtils::beginLabel(VkCommandBuffer commandBuffer, const char* name) const {
+    if (!_cmdBeginLabel) {
+        return;
+    }
+
+    VkDebugUtilsLabelEXT label = {};
+    label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    label.pLabelName = name;
+    _cmdBeginLabel(commandBuffer, &label);
+}
+
+void DebugUtils::endLabel(VkCommandBuffer commandBuffer) const {
+    if (_cmdEndLabel) {
+        _cmdEndLabel(commandBuffer);
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @class   DeletionQueue
+ * @brief   Destroys retired Vulkan objects once the GPU no longer uses them
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "DeletionQueue.hpp"
+
+DeletionQueue::DeletionQueue(uint32_t frames) : _buckets(frames) {
+}
+
+DeletionQueue::~DeletionQueue() {
+    flush();
+}
+
+void DeletionQueue::retire(std::function<void()> destroy) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _buckets[_frame].functions.push_back(std::move(destroy));
+}
+
+void DeletionQueue::beginFrame(uint32_t frame) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frame = frame;
+    _destroyBucket(_buckets[frame]);
+}
+
+void DeletionQueue::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& bucket : _buckets) {
+        _destroyBucket(bucket);
+    }
+}
+
+void DeletionQueue::_retire(const Handle& handle) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _buckets[_frame].handles.push_back(handle);
+}
+
+void DeletionQueue::_destroyBucket(Bucket& bucket) {
+    /* Handles first, functions usually release the memory they were bound to */
+    for (const auto& handle : bucket.handles) {
+        handle.destroy(handle.parent, handle.object);
+    }
+    for (auto& destroy : bucket.functions) {
+        destroy();
+    }
+
+    /* Cleared, not freed, so buckets don't allocate every frame */
+    bucket.handles.clear();
+    bucket.functions.clear();
+}
@@ -0,0 +1,26 @@
+/**
+ * @class   DeviceDispatch
+ * @brief   Device functions loaded straight from the driver
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "DeviceDispatch.hpp"
+
+#include <stdexcept>
+#include <string>
+
+void DeviceDispatch::load(VkDevice device) {
+#define VULKAN_DISPATCH_LOAD(name) \
+    name = (PFN_##name) vkGetDeviceProcAddr(device, #name); \
+    if (name == nullptr) { \
+        throw std::runtime_error(std::string("ERROR failed to load device function ") + #name); \
+    }
+    VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_LOAD)
+#undef VULKAN_DISPATCH_LOAD
+}
+
+void DeviceDispatch::loadTrampolines() {
+#define VULKAN_DISPATCH_EXPORT(name) name = ::name;
+    VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_EXPORT)
+#undef VULKAN_DISPATCH_EXPORT
+}
@@ -0,0 +1,103 @@
+/**
+ * @class   DynamicResolution
+ * @brief   Render resolution that follows the GPU time of frames, so they
+ *          stay within a budget when the load spikes
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "DynamicResolution.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+
+/**
+ * Lowest scale of each axis, a quarter of the pixels. Below it the upscale
+ * blurs more than dropping frames hurts.
+ */
+const double kMinScale = 0.5;
+
+/**
+ * Part of the budget aimed at, the rest absorbs the spikes
+ */
+const double kHeadroom = 0.9;
+
+/**
+ * Part of the way to the scale that would meet the budget moved every
+ * frame. The time measured is a few frames old, moving all the way would
+ * overshoot.
+ */
+const double kDamping = 0.25;
+
+/**
+ * Scaled sizes are multiples of it, so small changes of the scale don't
+ * change the resolution on every frame
+ */
+const uint32_t kExtentAlignment = 8;
+
+uint32_t scaleAxis(uint32_t size, double scale) {
+    /**
+     * Within a step of full size the size is kept as is: aligning it down
+     * would upscale, and blur, every frame of a size that isn't a
+     * multiple of the alignment. The damped scale also only approaches 1.
+     */
+    uint32_t scaled = uint32_t(size * scale);
+    if (scaled + kExtentAlignment > size) {
+        return size;
+    }
+    scaled = scaled / kExtentAlignment * kExtentAlignment;
+    return std::min(size, std::max(scaled, kExtentAlignment));
+}
+
+}
+
+void DynamicResolution::init(double budget, uint32_t framesInFlight) {
+    _budget = budget;
+    _scale = 1.0;
+    _frameScales.assign(framesInFlight, 1.0);
+}
+
+VkExtent2D DynamicResolution::extent(uint32_t frame, VkExtent2D full) {
+    VkExtent2D extent = full;
+    if (enabled()) {
+        extent.width = scaleAxis(full.width, _scale);
+        extent.height = scaleAxis(full.height, _scale);
+        _frameScales[frame] = double(extent.width) / double(full.width);
+    }
+
+    _pixels += uint64_t(extent.width) * extent.height;
+    _frames++;
+    return extent;
+}
+
+void DynamicResolution::update(uint32_t frame, uint64_t gpuTime) {
+    if (!enabled() || gpuTime == 0) {
+        return;
+    }
+
+    double frameScale = _frameScales[frame];
+    double target = frameScale * std::sqrt(_budget * kHeadroom / double(gpuTime));
+    _scale += (std::min(std::max(target, kMinScale), 1.0) - _scale) * kDamping;
+
+    _measured++;
+    _overBudget += gpuTime > _budget ? 1 : 0;
+    _scaleTotal += frameScale;
+    _minScale = std::min(_minScale, frameScale);
+
+    Profiler::instance().counter("render scale", Profiler::now(), {
+        {"percent", uint64_t(frameScale * 100.0 + 0.5)}
+    });
+}
+
+void DynamicResolution::report(std::ostream& out) const {
+    if (!enabled() || _measured == 0) {
+        return;
+    }
+
+    out << std::fixed << std::setprecision(2);
+    out << "Dynamic resolution, " << _budget / 1e6 << " ms budget: " << _overBudget << " of " << _measured
+        << " frames over budget, " << _scaleTotal / double(_measured) << " average scale, " << _minScale << " lowest" << std::endl;
+}
@@ -0,0 +1,365 @@
+/**
+ * @class   HostAllocator
+ * @brief   VkAllocationCallbacks serving the driver host allocations from
+ *          size class pools, with accounting per object type and scope
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "HostAllocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Block sizes of the pools, header included. Allocations that don't fit
+ * the largest one go to malloc.
+ */
+const uint32_t kSizeClasses[] = {
+    32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512,
+    640, 768, 1024, 1280, 1536, 2048, 2560, 3072, 4096
+};
+const uint8_t kSizeClassCount = sizeof(kSizeClasses) / sizeof(kSizeClasses[0]);
+const uint8_t kNoSizeClass = 0xFF;
+
+/**
+ * Pools carve their blocks out of slabs this big
+ */
+const size_t kSlabSize = 64 * 1024;
+
+/**
+ * Stored right before every allocation. Pool blocks are 16 byte aligned,
+ * so are the allocations right after the header.
+ */
+struct Header {
+    uint64_t size;                                                       /**> Size requested */
+    uint32_t offset;                                                     /**> From the malloc'ed pointer to the allocation */
+    uint8_t sizeClass;                                                   /**> Pool of the block, kNoSizeClass for malloc */
+    uint8_t scope;                                                       /**> VkSystemAllocationScope */
+    uint16_t tag;                                                        /**> Object type accounted for */
+};
+static_assert(sizeof(Header) == 16, "Header must keep allocations 16 byte aligned");
+
+const size_t kPoolAlignment = sizeof(Header);
+const size_t kScopes = 5;
+
+const char* objectTypeName(VkObjectType type) {
+    switch (type) {
+        case VK_OBJECT_TYPE_INSTANCE: return "instance";
+        case VK_OBJECT_TYPE_DEVICE: return "device";
+        case VK_OBJECT_TYPE_SEMAPHORE: return "semaphore";
+        case VK_OBJECT_TYPE_FENCE: return "fence";
+        case VK_OBJECT_TYPE_DEVICE_MEMORY: return "device memory";
+        case VK_OBJECT_TYPE_BUFFER: return "buffer";
+        case VK_OBJECT_TYPE_IMAGE: return "image";
+        case VK_OBJECT_TYPE_EVENT: return "event";
+        case VK_OBJECT_TYPE_QUERY_POOL: return "query pool";
+        case VK_OBJECT_TYPE_BUFFER_VIEW: return "buffer view";
+        case VK_OBJECT_TYPE_IMAGE_VIEW: return "image view";
+        case VK_OBJECT_TYPE_SHADER_MODULE: return "shader module";
+        case VK_OBJECT_TYPE_PIPELINE_CACHE: return "pipeline cache";
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT: return "pipeline layout";
+        case VK_OBJECT_TYPE_RENDER_PASS: return "render pass";
+        case VK_OBJECT_TYPE_PIPELINE: return "pipeline";
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT: return "descriptor set layout";
+        case VK_OBJECT_TYPE_SAMPLER: return "sampler";
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL: return "descriptor pool";
+        case VK_OBJECT_TYPE_FRAMEBUFFER: return "framebuffer";
+        case VK_OBJECT_TYPE_COMMAND_POOL: return "command pool";
+        case VK_OBJECT_TYPE_SURFACE_KHR: return "surface";
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR: return "swap chain";
+        case VK_OBJECT_TYPE_DEBUG_REPORT_CALLBACK_EXT: return "debug report callback";
+        case VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT: return "debug utils messenger";
+        default: return "other";
+    }
+}
+
+}
+
+/**
+ * Callbacks of an object type, pUserData points back to the tag
+ */
+struct HostAllocator::Tag {
+    VkAllocationCallbacks callbacks;
+    HostAllocator* allocator;
+    uint16_t index;
+    VkObjectType objectType;
+
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<int64_t> scopeBytes[kScopes];
+    std::atomic<int64_t> internalBytes{0};
+    std::atomic<uint64_t> allocations{0};
+    uint64_t reportedAllocations{0};                                     /**> allocations at the previous report */
+
+    void account(int64_t size, uint8_t scope) {
+        int64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        scopeBytes[scope].fetch_add(size, std::memory_order_relaxed);
+
+        int64_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+/**
+ * Free list of a block size, refilled a slab at a time
+ */
+struct HostAllocator::SizeClass {
+    std::mutex mutex;
+    void* freeList{nullptr};                                             /**> Freed blocks, linked through their first bytes */
+    char* slabCursor{nullptr};                                           /**> Next block never handed out in the last slab */
+    char* slabEnd{nullptr};
+    std::vector<void*> slabs;
+};
+
+HostAllocator& HostAllocator::instance() {
+    static HostAllocator allocator;
+    return allocator;
+}
+
+HostAllocator::HostAllocator()
+    : _sizeClasses(new SizeClass[kSizeClassCount]), _reportTime(std::chrono::steady_clock::now()) {
+}
+
+HostAllocator::~HostAllocator() {
+    for (uint8_t i = 0; i < kSizeClassCount; ++i) {
+        for (void* slab : _sizeClasses[i].slabs) {
+            std::free(slab);
+        }
+    }
+}
+
+const VkAllocationCallbacks* HostAllocator::callbacks(VkObjectType objectType) {
+    std::lock_guard<std::mutex> lock(_tagsMutex);
+
+    auto found = _tagsByType.find(objectType);
+    if (found != _tagsByType.end()) {
+        return &found->second->callbacks;
+    }
+
+    if (_tagCount == kMaxTags) {
+        throw std::runtime_error("ERROR too many object types for the host allocator!");
+    }
+
+    std::unique_ptr<Tag> tag(new Tag());
+    tag->allocator = this;
+    tag->index = _tagCount;
+    tag->objectType = objectType;
+    for (auto& bytes : tag->scopeBytes) {
+        bytes = 0;
+    }
+
+    tag->callbacks.pUserData = tag.get();
+    tag->callbacks.pfnAllocation = _allocation;
+    tag->callbacks.pfnReallocation = _reallocation;
+    tag->callbacks.pfnFree = _free;
+    tag->callbacks.pfnInternalAllocation = _internalAllocation;
+    tag->callbacks.pfnInternalFree = _internalFree;
+
+    /* Filled before its index is handed out in any header, so _tag() never sees it half built */
+    _tagsByType[objectType] = tag.get();
+    _tags[_tagCount] = std::move(tag);
+    return &_tags[_tagCount++]->callbacks;
+}
+
+std::vector<HostAllocator::Stats> HostAllocator::stats() {
+    std::lock_guard<std::mutex> lock(_tagsMutex);
+
+    std::vector<Stats> stats;
+    for (uint16_t i = 0; i < _tagCount; ++i) {
+        const Tag* tag = _tags[i].get();
+        Stats tagStats;
+        tagStats.objectType = tag->objectType;
+        tagStats.liveBytes = tag->liveBytes.load(std::memory_order_relaxed);
+        tagStats.peakBytes = tag->peakBytes.load(std::memory_order_relaxed);
+        for (size_t scope = 0; scope < kScopes; ++scope) {
+            tagStats.scopeBytes[scope] = tag->scopeBytes[scope].load(std::memory_order_relaxed);
+        }
+        tagStats.internalBytes = tag->internalBytes.load(std::memory_order_relaxed);
+        tagStats.allocations = tag->allocations.load(std::memory_order_relaxed);
+        if (tagStats.allocations > 0 || tagStats.internalBytes > 0) {
+            stats.push_back(tagStats);
+        }
+    }
+    return stats;
+}
+
+void HostAllocator::report(std::ostream& out) {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::max(1e-9, std::chrono::duration<double>(now - _reportTime).count());
+    _reportTime = now;
+
+    std::vector<Stats> allStats = stats();
+    std::sort(allStats.begin(), allStats.end(), [](const Stats& a, const Stats& b) { return a.peakBytes > b.peakBytes; });
+
+    out << "Vulkan host allocations:" << std::endl;
+    out << "\t" << std::left << std::setw(24) << "object type" << std::right
+        << std::setw(12) << "live" << std::setw(12) << "peak" << std::setw(12) << "command"
+        << std::setw(12) << "object" << std::setw(12) << "cache" << std::setw(12) << "device"
+        << std::setw(12) << "instance" << std::setw(12) << "internal" << std::setw(12) << "allocs/s" << std::endl;
+
+    for (const auto& stats : allStats) {
+        uint64_t allocations = stats.allocations;
+        {
+            std::lock_guard<std::mutex> lock(_tagsMutex);
+            Tag* tag = _tagsByType[stats.objectType];
+            allocations -= tag->reportedAllocations;
+            tag->reportedAllocations = stats.allocations;
+        }
+
+        out << "\t" << std::left << std::setw(24) << objectTypeName(stats.objectType) << std::right
+            << std::setw(12) << stats.liveBytes << std::setw(12) << stats.peakBytes;
+        for (size_t scope = 0; scope < kScopes; ++scope) {
+            out << std::setw(12) << stats.scopeBytes[scope];
+        }
+        out << std::setw(12) << stats.internalBytes
+            << std::setw(12) << std::fixed << std::setprecision(1) << allocations / seconds << std::endl;
+    }
+}
+
+void* HostAllocator::_allocate(Tag* tag, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    char* raw = nullptr;
+    char* memory = nullptr;
+    uint8_t sizeClass = kNoSizeClass;
+
+    if (alignment <= kPoolAlignment) {
+        const uint32_t* found = std::lower_bound(kSizeClasses, kSizeClasses + kSizeClassCount, size + sizeof(Header));
+        if (found != kSizeClasses + kSizeClassCount) {
+            sizeClass = uint8_t(found - kSizeClasses);
+        }
+    }
+
+    if (sizeClass != kNoSizeClass) {
+        SizeClass& pool = _sizeClasses[sizeClass];
+        uint32_t blockSize = kSizeClasses[sizeClass];
+
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.freeList) {
+            raw = static_cast<char*>(pool.freeList);
+            std::memcpy(&pool.freeList, raw, sizeof(void*));
+        } else {
+            if (pool.slabCursor + blockSize > pool.slabEnd) {
+                /* malloc is 16 byte aligned, so are the blocks, all multiples of 16 */
+                pool.slabCursor = static_cast<char*>(std::malloc(kSlabSize));
+                if (!pool.slabCursor) {
+                    return nullptr;
+                }
+                pool.slabEnd = pool.slabCursor + kSlabSize;
+                pool.slabs.push_back(pool.slabCursor);
+            }
+            raw = pool.slabCursor;
+            pool.slabCursor += blockSize;
+        }
+        memory = raw + sizeof(Header);
+    } else {
+        alignment = std::max(alignment, kPoolAlignment);
+        raw = static_cast<char*>(std::malloc(size + alignment + sizeof(Header)));
+        if (!raw) {
+            return nullptr;
+        }
+        uintptr_t address = reinterpret_cast<uintptr_t>(raw) + sizeof(Header);
+        memory = reinterpret_cast<char*>((address + alignment - 1) & ~uintptr_t(alignment - 1));
+    }
+
+    Header header;
+    header.size = size;
+    header.offset = uint32_t(memory - raw);
+    header.sizeClass = sizeClass;
+    header.scope = uint8_t(scope);
+    header.tag = tag->index;
+    std::memcpy(memory - sizeof(Header), &header, sizeof(Header));
+
+    tag->allocations.fetch_add(1, std::memory_order_relaxed);
+    tag->account(int64_t(size), header.scope);
+    return memory;
+}
+
+void HostAllocator::_free(void* memory) {
+    if (!memory) {
+        return;
+    }
+
+    Header header;
+    std::memcpy(&header, static_cast<char*>(memory) - sizeof(Header), sizeof(Header));
+    char* raw = static_cast<char*>(memory) - header.offset;
+
+    /* Accounted to the type that allocated it, whichever callbacks free it */
+    _tag(header.tag)->account(-int64_t(header.size), header.scope);
+
+    if (header.sizeClass == kNoSizeClass) {
+        std::free(raw);
+        return;
+    }
+
+    SizeClass& pool = _sizeClasses[header.sizeClass];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    std::memcpy(raw, &pool.freeList, sizeof(void*));
+    pool.freeList = raw;
+}
+
+HostAllocator::Tag* HostAllocator::_tag(uint16_t index) {
+    /* The slot was filled before the allocation carrying its index was made, and is never written again */
+    return _tags[index].get();
+}
+
+VKAPI_ATTR void* VKAPI_CALL HostAllocator::_allocation(void* userData, size_t size, size_t alignment,
+                                                        VkSystemAllocationScope scope) {
+    Tag* tag = static_cast<Tag*>(userData);
+    return tag->allocator->_allocate(tag, size, alignment, scope);
+}
+
+VKAPI_ATTR void* VKAPI_CALL HostAllocator::_reallocation(void* userData, void* original, size_t size, size_t alignment,
+                                                          VkSystemAllocationScope scope) {
+    Tag* tag = static_cast<Tag*>(userData);
+    if (!original) {
+        return tag->allocator->_allocate(tag, size, alignment, scope);
+    }
+    if (size == 0) {
+        tag->allocator->_free(original);
+        return nullptr;
+    }
+
+    Header header;
+    std::memcpy(&header, static_cast<char*>(original) - sizeof(Header), sizeof(Header));
+
+    /* Still fits its block, nothing to move */
+    if (header.sizeClass != kNoSizeClass && size + sizeof(Header) <= kSizeClasses[header.sizeClass] &&
+            alignment <= kPoolAlignment) {
+        Tag* owner = tag->allocator->_tag(header.tag);
+        owner->account(int64_t(size) - int64_t(header.size), header.scope);
+        owner->allocations.fetch_add(1, std::memory_order_relaxed);
+        header.size = size;
+        std::memcpy(static_cast<char*>(original) - sizeof(Header), &header, sizeof(Header));
+        return original;
+    }
+
+    void* memory = tag->allocator->_allocate(tag, size, alignment, scope);
+    if (memory) {
+        std::memcpy(memory, original, std::min<size_t>(size, header.size));
+        tag->allocator->_free(original);
+    }
+    return memory;
+}
+
+VKAPI_ATTR void VKAPI_CALL HostAllocator::_free(void* userData, void* memory) {
+    static_cast<Tag*>(userData)->allocator->_free(memory);
+}
+
+VKAPI_ATTR void VKAPI_CALL HostAllocator::_internalAllocation(void* userData, size_t size, VkInternalAllocationType type,
+                                                               VkSystemAllocationScope scope) {
+    static_cast<Tag*>(userData)->internalBytes.fetch_add(int64_t(size), std::memory_order_relaxed);
+}
+
+VKAPI_ATTR void VKAPI_CALL HostAllocator::_internalFree(void* userData, size_t size, VkInternalAllocationType type,
+                                                         VkSystemAllocationScope scope) {
+    static_cast<Tag*>(userData)->internalBytes.fetch_sub(int64_t(size), std::memory_order_relaxed);
+}
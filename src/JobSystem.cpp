@@ -0,0 +1,311 @@
+/**
+ * @class   JobSystem
+ * @brief   Work stealing job scheduler shared by the engine subsystems
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Jobs a thread can have queued at once. Past that, run() executes the
+ * job right away on the calling thread.
+ */
+const int64_t kDequeCapacity = 4096;
+
+/**
+ * Failed rounds of stealing before an idle thread goes to sleep
+ */
+const int kSpinRounds = 64;
+
+/**
+ * System and index of the calling thread, so run() finds its deque
+ */
+thread_local const void* tJobSystem = nullptr;
+thread_local uint32_t tWorkerIndex = 0;
+
+}
+
+struct JobSystem::Job {
+    std::function<void()> function;                                      /**> Work to do */
+    Counter* signal;                                                     /**> Decremented once function returns */
+};
+
+/**
+ * Chase-Lev deque: the owner pushes and pops at the bottom without
+ * locking, thieves take from the top and only race on the last job
+ */
+struct JobSystem::Worker {
+    std::atomic<int64_t> top{0};
+    std::atomic<int64_t> bottom{0};
+    std::unique_ptr<std::atomic<Job*>[]> jobs{new std::atomic<Job*>[kDequeCapacity]};
+
+    bool push(Job* job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= kDequeCapacity) {
+            return false;
+        }
+
+        jobs[b & (kDequeCapacity - 1)].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Job* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = jobs[b & (kDequeCapacity - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            /* Last job, a thief may be taking it too */
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Job* job = jobs[t & (kDequeCapacity - 1)].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return job;
+    }
+};
+
+JobSystem::JobSystem(uint32_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (uint32_t i = 0; i < threads; ++i) {
+        _workers.emplace_back(new Worker());
+    }
+
+    tJobSystem = this;
+    tWorkerIndex = 0;
+    for (uint32_t i = 1; i < threads; ++i) {
+        _threads.emplace_back(&JobSystem::_threadLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+
+    if (tJobSystem == this) {
+        tJobSystem = nullptr;
+    }
+}
+
+void JobSystem::run(std::function<void()> function, Counter* signal, Counter* dependency) {
+    Job* job = new Job{std::move(function), signal};
+    if (signal) {
+        signal->_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->_mutex);
+        if (!dependency->done()) {
+            dependency->_waiting.push_back(job);
+            return;
+        }
+    }
+
+    _push(job);
+}
+
+void JobSystem::runOnMainThread(std::function<void()> function, Counter* signal) {
+    Job* job = new Job{std::move(function), signal};
+    if (signal) {
+        signal->_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(_mainMutex);
+    _mainJobs.push_back(job);
+}
+
+void JobSystem::parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& function) {
+    Counter counter;
+    batchSize = std::max<size_t>(1, batchSize);
+
+    for (size_t first = 0; first < count; first += batchSize) {
+        size_t last = std::min(first + batchSize, count);
+        run([&function, first, last]() { function(first, last); }, &counter);
+    }
+
+    wait(counter);
+}
+
+void JobSystem::wait(Counter& counter) {
+    uint32_t index = _currentIndex();
+
+    while (!counter.done()) {
+        if (index == 0) {
+            runMainThreadJobs();
+        }
+
+        Job* job = _findJob(index);
+        if (job) {
+            _execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    /* The last job may still hold the lock, see _signal */
+    std::lock_guard<std::mutex> lock(counter._mutex);
+}
+
+void JobSystem::runMainThreadJobs() {
+    std::vector<Job*> jobs;
+    {
+        std::lock_guard<std::mutex> lock(_mainMutex);
+        jobs.swap(_mainJobs);
+    }
+
+    for (Job* job : jobs) {
+        _execute(job);
+    }
+}
+
+uint32_t JobSystem::threadCount() const {
+    return static_cast<uint32_t>(_workers.size());
+}
+
+uint32_t JobSystem::threadIndex() const {
+    return _currentIndex();
+}
+
+void JobSystem::_threadLoop(uint32_t index) {
+    tJobSystem = this;
+    tWorkerIndex = index;
+
+    int idleRounds = 0;
+    while (!_quit.load(std::memory_order_relaxed)) {
+        Job* job = _findJob(index);
+        if (job) {
+            _execute(job);
+            idleRounds = 0;
+            continue;
+        }
+
+        if (++idleRounds < kSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepers.fetch_add(1);
+        _wake.wait(lock, [this]() { return _queued.load() > 0 || _quit.load(); });
+        _sleepers.fetch_sub(1);
+        idleRounds = 0;
+    }
+}
+
+void JobSystem::_push(Job* job) {
+    /* Counted first, a thief may take the job as soon as it is pushed */
+    _queued.fetch_add(1);
+    if (!_workers[_currentIndex()]->push(job)) {
+        _queued.fetch_sub(1);
+        _execute(job);
+        return;
+    }
+
+    /**
+     * Sleeping threads raise _sleepers before checking _queued, so either
+     * they see this job or we see them. Taking the lock makes sure they
+     * are really waiting, and not about to, when notified.
+     */
+    if (_sleepers.load() == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wake.notify_one();
+}
+
+JobSystem::Job* JobSystem::_findJob(uint32_t index) {
+    Job* job = _workers[index]->pop();
+
+    /* Start with the next thread so thieves don't all hit the same deque */
+    for (size_t i = 1; !job && i < _workers.size(); ++i) {
+        job = _workers[(index + i) % _workers.size()]->steal();
+    }
+
+    if (job) {
+        _queued.fetch_sub(1);
+    }
+    return job;
+}
+
+void JobSystem::_execute(Job* job) {
+    job->function();
+    if (job->signal) {
+        _signal(job->signal);
+    }
+    delete job;
+}
+
+void JobSystem::_signal(Counter* counter) {
+    /* Not the last job: the counter is left alone right away */
+    uint32_t pending = counter->_pending.load(std::memory_order_relaxed);
+    while (pending > 1) {
+        if (counter->_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+
+    /**
+     * The last one decrements under the lock, so run() can't park a job
+     * after the waiting jobs were released, and wait() doesn't return
+     * while the counter is still in use
+     */
+    std::vector<Job*> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->_mutex);
+        if (counter->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            released.swap(counter->_waiting);
+        }
+    }
+    for (Job* job : released) {
+        _push(job);
+    }
+}
+
+uint32_t JobSystem::_currentIndex() const {
+    if (tJobSystem != this) {
+        throw std::runtime_error("ERROR jobs can only be queued from the main thread or from other jobs");
+    }
+    return tWorkerIndex;
+}
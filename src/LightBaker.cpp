@@ -0,0 +1,326 @@
+/**
+ * @class   LightBaker
+ * @brief   Offline path tracer baking lightmaps and per vertex ambient
+ *          occlusion of a mesh on every core
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "LightBaker.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/random.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const uint32_t kNoTriangle = ~0u;
+const size_t kAOVerticesPerTask = 64;
+
+/**
+ * Triangle and barycentric position seen by a lightmap texel center
+ */
+struct TexelSample {
+    uint32_t triangle = kNoTriangle;
+    glm::vec2 bary;
+};
+
+}
+
+LightBaker::LightBaker(const Mesh& mesh, const Settings& settings) : _mesh(mesh), _settings(settings) {
+    if (mesh.indices.size() % 3 != 0) {
+        throw std::runtime_error("ERROR mesh indices are not a triangle list");
+    }
+    if (!mesh.normals.empty() && mesh.normals.size() != mesh.positions.size()) {
+        throw std::runtime_error("ERROR number of normals does not match the number of positions");
+    }
+
+    _bvh.build(mesh.positions.data(), mesh.indices.data(), mesh.indices.size(), settings.threads);
+
+    /**
+     * Without normals the mesh is baked smooth, with area weighted face
+     * normals averaged at every vertex
+     */
+    if (mesh.normals.empty()) {
+        _normals.assign(mesh.positions.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const uint32_t *triangle = &mesh.indices[i];
+            glm::vec3 faceNormal = glm::cross(mesh.positions[triangle[1]] - mesh.positions[triangle[0]],
+                                              mesh.positions[triangle[2]] - mesh.positions[triangle[0]]);
+            for (int v = 0; v < 3; ++v) {
+                _normals[triangle[v]] += faceNormal;
+            }
+        }
+        for (auto& normal : _normals) {
+            float length = glm::length(normal);
+            normal = length > 0.0f ? normal / length : normal;
+        }
+    } else {
+        _normals = mesh.normals;
+    }
+
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(-std::numeric_limits<float>::max());
+    for (const auto& position : mesh.positions) {
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+    _epsilon = mesh.positions.empty() ? 0.0f : glm::length(boundsMax - boundsMin) * 1e-4f;
+
+    _settings.sunDirection = glm::normalize(_settings.sunDirection);
+}
+
+LightBaker::Lightmap LightBaker::bakeLightmap() const {
+    if (_mesh.uvs.size() != _mesh.positions.size()) {
+        throw std::runtime_error("ERROR lightmap baking needs one uv per position");
+    }
+
+    uint32_t width = _settings.width;
+    uint32_t height = _settings.height;
+    glm::vec2 size(width, height);
+
+    /**
+     * Rasterize the triangles in uv space to find which surface point
+     * every texel center maps to
+     */
+    std::vector<TexelSample> texelSamples(width * height);
+    for (size_t i = 0; i < _mesh.indices.size(); i += 3) {
+        glm::vec2 uv0 = _mesh.uvs[_mesh.indices[i + 0]] * size;
+        glm::vec2 uv1 = _mesh.uvs[_mesh.indices[i + 1]] * size;
+        glm::vec2 uv2 = _mesh.uvs[_mesh.indices[i + 2]] * size;
+
+        glm::vec2 e1 = uv1 - uv0;
+        glm::vec2 e2 = uv2 - uv0;
+        float area = e1.x * e2.y - e1.y * e2.x;
+        if (area == 0.0f) {
+            continue;
+        }
+
+        glm::vec2 boundsMin = glm::max(glm::floor(glm::min(uv0, glm::min(uv1, uv2))), glm::vec2(0.0f));
+        glm::vec2 boundsMax = glm::min(glm::ceil(glm::max(uv0, glm::max(uv1, uv2))), size);
+        for (uint32_t y = uint32_t(boundsMin.y); y < uint32_t(boundsMax.y); ++y) {
+            for (uint32_t x = uint32_t(boundsMin.x); x < uint32_t(boundsMax.x); ++x) {
+                glm::vec2 p = glm::vec2(x, y) + 0.5f - uv0;
+                glm::vec2 bary = glm::vec2(p.x * e2.y - p.y * e2.x, e1.x * p.y - e1.y * p.x) / area;
+                if (bary.x < 0.0f || bary.y < 0.0f || bary.x + bary.y > 1.0f) {
+                    continue;
+                }
+                texelSamples[y * width + x].triangle = uint32_t(i / 3);
+                texelSamples[y * width + x].bary = bary;
+            }
+        }
+    }
+
+    Lightmap lightmap;
+    lightmap.width = width;
+    lightmap.height = height;
+    lightmap.texels.assign(width * height, glm::vec4(0.0f));
+
+    _parallelFor(height, [&](size_t y) {
+        glm::seedRand(_settings.seed + y);
+        for (uint32_t x = 0; x < width; ++x) {
+            const TexelSample& sample = texelSamples[y * width + x];
+            if (sample.triangle == kNoTriangle) {
+                continue;
+            }
+
+            const uint32_t *triangle = &_mesh.indices[sample.triangle * 3];
+            glm::vec3 position = _mesh.positions[triangle[0]] * (1.0f - sample.bary.x - sample.bary.y) +
+                                 _mesh.positions[triangle[1]] * sample.bary.x +
+                                 _mesh.positions[triangle[2]] * sample.bary.y;
+            glm::vec3 normal = _surfaceNormal(sample.triangle, sample.bary);
+
+            glm::vec3 sum(0.0f);
+            for (uint32_t s = 0; s < _settings.samples; ++s) {
+                sum += _radiance(position, normal);
+            }
+            lightmap.texels[y * width + x] = glm::vec4(sum / float(_settings.samples), 1.0f);
+        }
+    });
+
+    /**
+     * Grow every chart by averaging the filled neighbours of the empty
+     * texels, so bilinear filtering at chart borders doesn't pull in black
+     */
+    std::vector<bool> filled(width * height);
+    for (size_t i = 0; i < filled.size(); ++i) {
+        filled[i] = lightmap.texels[i].w > 0.0f;
+    }
+    for (uint32_t pass = 0; pass < _settings.dilation; ++pass) {
+        std::vector<bool> grown = filled;
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                if (filled[y * width + x]) {
+                    continue;
+                }
+
+                glm::vec3 sum(0.0f);
+                int count = 0;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        int nx = int(x) + dx;
+                        int ny = int(y) + dy;
+                        if (nx < 0 || ny < 0 || nx >= int(width) || ny >= int(height) || !filled[ny * width + nx]) {
+                            continue;
+                        }
+                        sum += glm::vec3(lightmap.texels[ny * width + nx]);
+                        ++count;
+                    }
+                }
+                if (count) {
+                    lightmap.texels[y * width + x] = glm::vec4(sum / float(count), 0.0f);
+                    grown[y * width + x] = true;
+                }
+            }
+        }
+        filled.swap(grown);
+    }
+
+    return lightmap;
+}
+
+std::vector<float> LightBaker::bakeVertexAO() const {
+    size_t vertexCount = _mesh.positions.size();
+    uint32_t samples = _settings.aoSamples;
+    std::vector<float> ao(vertexCount, 1.0f);
+    if (samples == 0) {
+        return ao;
+    }
+
+    /**
+     * The rays of a few vertices go together through the packet tracer,
+     * the rays of a vertex share their origin so packets stay coherent
+     */
+    size_t tasks = (vertexCount + kAOVerticesPerTask - 1) / kAOVerticesPerTask;
+    _parallelFor(tasks, [&](size_t task) {
+        size_t first = task * kAOVerticesPerTask;
+        size_t last = std::min(first + kAOVerticesPerTask, vertexCount);
+        size_t rayCount = (last - first) * samples;
+
+        glm::vec3soa origins(rayCount);
+        glm::vec3soa directions(rayCount);
+        std::vector<float> distances(rayCount, _settings.aoDistance);
+        std::unique_ptr<bool[]> occluded(new bool[rayCount]);
+
+        glm::seedRand(_settings.seed + task);
+        for (size_t v = first; v < last; ++v) {
+            glm::vec3 normal = _normals[v];
+            glm::vec3 origin = _mesh.positions[v] + normal * _epsilon;
+            for (uint32_t s = 0; s < samples; ++s) {
+                size_t ray = (v - first) * samples + s;
+                origins.set(ray, origin);
+                directions.set(ray, _cosineSample(normal));
+            }
+            /* Without a normal there is no hemisphere to sample */
+            if (normal == glm::vec3(0.0f)) {
+                std::fill(distances.begin() + (v - first) * samples, distances.begin() + (v - first + 1) * samples, 0.0f);
+            }
+        }
+
+        _bvh.occluded(origins, directions, distances.data(), occluded.get());
+
+        for (size_t v = first; v < last; ++v) {
+            uint32_t hits = 0;
+            for (uint32_t s = 0; s < samples; ++s) {
+                hits += occluded[(v - first) * samples + s] ? 1 : 0;
+            }
+            ao[v] = 1.0f - float(hits) / float(samples);
+        }
+    });
+
+    return ao;
+}
+
+/**
+ * Light reflected by a white diffuse surface at position, estimated with
+ * one path. Directions are drawn with a cosine distribution so the cosine
+ * and pdf cancel out, leaving the albedo of each bounce as the weight.
+ */
+glm::vec3 LightBaker::_radiance(glm::vec3 position, glm::vec3 normal) const {
+    glm::vec3 result(0.0f);
+    glm::vec3 throughput(1.0f);
+    glm::vec3 toSun = -_settings.sunDirection;
+
+    for (uint32_t bounce = 0; bounce <= _settings.bounces; ++bounce) {
+        glm::vec3 origin = position + normal * _epsilon;
+
+        float cosSun = glm::dot(normal, toSun);
+        if (cosSun > 0.0f && !_bvh.occluded(origin, toSun, std::numeric_limits<float>::max())) {
+            result += throughput * _settings.sunColor * (cosSun / glm::pi<float>());
+        }
+
+        glm::vec3 direction = _cosineSample(normal);
+        glm::vec3 hit(0.0f, 0.0f, std::numeric_limits<float>::max());
+        uint32_t triangle;
+        if (!_bvh.intersect(origin, direction, hit, triangle)) {
+            result += throughput * _settings.skyColor;
+            break;
+        }
+
+        throughput *= _settings.albedo;
+        position = origin + direction * hit.z;
+        normal = _surfaceNormal(triangle, glm::vec2(hit));
+        if (glm::dot(normal, direction) > 0.0f) {
+            normal = -normal;
+        }
+    }
+
+    return result;
+}
+
+glm::vec3 LightBaker::_surfaceNormal(uint32_t triangle, glm::vec2 bary) const {
+    const uint32_t *indices = &_mesh.indices[triangle * 3];
+    glm::vec3 normal = _normals[indices[0]] * (1.0f - bary.x - bary.y) +
+                       _normals[indices[1]] * bary.x +
+                       _normals[indices[2]] * bary.y;
+    float length = glm::length(normal);
+
+    /* Opposite normals can cancel out, fall back to the face normal */
+    if (length < 1e-6f) {
+        const glm::vec3 *p[] = {&_mesh.positions[indices[0]], &_mesh.positions[indices[1]], &_mesh.positions[indices[2]]};
+        return glm::normalize(glm::cross(*p[1] - *p[0], *p[2] - *p[0]));
+    }
+    return normal / length;
+}
+
+/**
+ * Malley's method: a uniform point on the unit disk lifted to the
+ * hemisphere around normal
+ */
+glm::vec3 LightBaker::_cosineSample(glm::vec3 normal) const {
+    glm::vec2 disk = glm::diskRand(1.0f);
+    float z = glm::sqrt(glm::max(0.0f, 1.0f - glm::dot(disk, disk)));
+
+    glm::vec3 tangent = glm::normalize(glm::cross(glm::abs(normal.x) > 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f), normal));
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+    return tangent * disk.x + bitangent * disk.y + normal * z;
+}
+
+/**
+ * Calls function for every index in [0, count), spread over the threads
+ * as they become free
+ */
+void LightBaker::_parallelFor(size_t count, const std::function<void(size_t)>& function) const {
+    size_t threads = _settings.threads ? _settings.threads : std::thread::hardware_concurrency();
+    threads = std::max<size_t>(1, std::min(threads, count));
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            function(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
@@ -0,0 +1,235 @@
+/**
+ * @class   MemoryBudget
+ * @brief   Accounts device memory per heap and evicts streamable resources
+ *          before the process goes over its budget
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "MemoryBudget.hpp"
+#include "HostAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+/**
+ * Share of a heap taken as the budget when the driver can't tell it
+ */
+const double kDefaultBudget = 0.8;
+
+/**
+ * Eviction starts above the high mark and goes on until the heap is
+ * under the low one, so it doesn't run again every frame
+ */
+const double kHighWater = 0.95;
+const double kLowWater = 0.85;
+
+VkDeviceSize share(VkDeviceSize size, double fraction) {
+    return VkDeviceSize(double(size) * fraction);
+}
+
+}
+
+void MemoryBudget::init(VkInstance instance, VkPhysicalDevice physicalDevice, bool budgetExtension) {
+    _physicalDevice = physicalDevice;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_memoryProperties);
+
+    _getMemoryProperties2 = nullptr;
+    if (budgetExtension) {
+        _getMemoryProperties2 = (PFN_vkGetPhysicalDeviceMemoryProperties2KHR)
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties2KHR");
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _heaps.assign(_memoryProperties.memoryHeapCount, Heap());
+    for (uint32_t i = 0; i < _memoryProperties.memoryHeapCount; ++i) {
+        _heaps[i].size = _memoryProperties.memoryHeaps[i].size;
+        _heaps[i].flags = _memoryProperties.memoryHeaps[i].flags;
+    }
+    _refreshBudgets();
+}
+
+void MemoryBudget::limit(VkDeviceSize budget) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _limit = budget;
+    _refreshBudgets();
+}
+
+VkResult MemoryBudget::allocate(VkDevice device, const VkMemoryAllocateInfo& allocateInfo, VkDeviceMemory* memory) {
+    if (allocateInfo.memoryTypeIndex >= _memoryProperties.memoryTypeCount) {
+        throw std::runtime_error("ERROR allocating from unknown memory type " + std::to_string(allocateInfo.memoryTypeIndex));
+    }
+    uint32_t heap = _memoryProperties.memoryTypes[allocateInfo.memoryTypeIndex].heapIndex;
+
+    /* Make room before the driver has to */
+    std::vector<std::function<void()>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Heap& usage = _heaps[heap];
+        if (_pressure(usage) + allocateInfo.allocationSize > share(usage.budget, kHighWater)) {
+            _evict(heap, share(usage.budget, kLowWater) - std::min(share(usage.budget, kLowWater), allocateInfo.allocationSize),
+                   evicted);
+        }
+    }
+    for (auto& evict : evicted) {
+        evict();
+    }
+
+    VkResult result = vkAllocateMemory(device, &allocateInfo, hostAllocator(VK_OBJECT_TYPE_DEVICE_MEMORY), memory);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Heap& usage = _heaps[heap];
+    usage.usage += allocateInfo.allocationSize;
+    usage.peakUsage = std::max(usage.peakUsage, usage.usage);
+    _allocations[*memory] = {heap, allocateInfo.allocationSize};
+    return VK_SUCCESS;
+}
+
+void MemoryBudget::free(VkDevice device, VkDeviceMemory memory) {
+    if (memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _allocations.find(memory);
+        if (found == _allocations.end()) {
+            throw std::runtime_error("ERROR freeing device memory not allocated through the memory budget");
+        }
+
+        Heap& usage = _heaps[found->second.heap];
+        usage.usage -= found->second.size;
+        usage.evicting -= std::min(usage.evicting, found->second.size);
+        _allocations.erase(found);
+    }
+
+    vkFreeMemory(device, memory, hostAllocator(VK_OBJECT_TYPE_DEVICE_MEMORY));
+}
+
+uint64_t MemoryBudget::addStreamable(uint32_t memoryTypeIndex, VkDeviceSize size, std::function<void()> evict) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    uint64_t id = _nextStreamable++;
+    Streamable& streamable = _streamables[id];
+    streamable.heap = _memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    streamable.size = size;
+    streamable.lastUsed = _frame;
+    streamable.evict = std::move(evict);
+    streamable.lru = _lru.insert(_lru.end(), id);
+    return id;
+}
+
+void MemoryBudget::touch(uint64_t id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto found = _streamables.find(id);
+    if (found == _streamables.end() || found->second.lastUsed == _frame) {
+        return;
+    }
+    found->second.lastUsed = _frame;
+    _lru.splice(_lru.end(), _lru, found->second.lru);
+}
+
+void MemoryBudget::removeStreamable(uint64_t id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto found = _streamables.find(id);
+    if (found != _streamables.end()) {
+        _lru.erase(found->second.lru);
+        _streamables.erase(found);
+    }
+}
+
+void MemoryBudget::beginFrame(uint64_t frame) {
+    std::vector<std::function<void()>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _frame = frame;
+        _refreshBudgets();
+
+        for (uint32_t heap = 0; heap < _heaps.size(); ++heap) {
+            if (_pressure(_heaps[heap]) > share(_heaps[heap].budget, kHighWater)) {
+                _evict(heap, share(_heaps[heap].budget, kLowWater), evicted);
+            }
+        }
+    }
+
+    for (auto& evict : evicted) {
+        evict();
+    }
+}
+
+std::vector<MemoryBudget::Heap> MemoryBudget::heaps() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _heaps;
+}
+
+void MemoryBudget::report(std::ostream& out) {
+    std::vector<Heap> allHeaps = heaps();
+
+    out << "Device memory heaps" << (hasBudgetExtension() ? " (VK_EXT_memory_budget):" : ":") << std::endl;
+    for (size_t i = 0; i < allHeaps.size(); ++i) {
+        const Heap& heap = allHeaps[i];
+        out << "\t" << i << ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " device local" : " host")
+            << ": usage " << (heap.usage >> 20) << " MB, peak " << (heap.peakUsage >> 20)
+            << " MB, budget " << (heap.budget >> 20) << " MB of " << (heap.size >> 20) << " MB" << std::endl;
+    }
+}
+
+void MemoryBudget::_refreshBudgets() {
+    if (!_getMemoryProperties2) {
+        for (auto& heap : _heaps) {
+            heap.budget = share(heap.size, kDefaultBudget);
+            heap.budget = _limit ? std::min(heap.budget, _limit) : heap.budget;
+        }
+        return;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {};
+    budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2KHR properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    properties.pNext = &budget;
+
+    _getMemoryProperties2(_physicalDevice, &properties);
+
+    for (uint32_t i = 0; i < _heaps.size(); ++i) {
+        _heaps[i].budget = _limit ? std::min(budget.heapBudget[i], _limit) : budget.heapBudget[i];
+        _heaps[i].processUsage = budget.heapUsage[i];
+    }
+}
+
+void MemoryBudget::_evict(uint32_t heap, VkDeviceSize target, std::vector<std::function<void()>>& evicted) {
+    Heap& usage = _heaps[heap];
+
+    for (auto it = _lru.begin(); it != _lru.end() && _pressure(usage) > target;) {
+        auto found = _streamables.find(*it);
+        Streamable& streamable = found->second;
+
+        /* Everything after it was used more recently, this frame included */
+        if (streamable.lastUsed >= _frame) {
+            break;
+        }
+        if (streamable.heap != heap) {
+            ++it;
+            continue;
+        }
+
+        usage.evicting += streamable.size;
+        evicted.push_back(std::move(streamable.evict));
+        it = _lru.erase(it);
+        _streamables.erase(found);
+    }
+}
+
+VkDeviceSize MemoryBudget::_pressure(const Heap& heap) const {
+    /* The driver also counts what other parts of the process allocated */
+    VkDeviceSize usage = std::max(heap.processUsage, heap.usage);
+    return usage - std::min(usage, heap.evicting);
+}
@@ -0,0 +1,131 @@
+/**
+ * @class   PipelineStatistics
+ * @brief   Vertex, clipping and fragment counts of every render pass, read
+ *          back from pipeline statistics queries
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "PipelineStatistics.hpp"
+#include "DebugUtils.hpp"
+#include "Profiler.hpp"
+
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Counted by every query, results come in the order of the bits
+ */
+const VkQueryPipelineStatisticFlags kStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                                                  VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+                                                  VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+}
+
+void PipelineStatistics::init(const DeviceDispatch& vk, const std::vector<const char*>& passes, uint32_t framesInFlight) {
+    _vk = &vk;
+    _passes = passes;
+    _recorded.assign(framesInFlight, false);
+    _lastFrame.assign(passes.size(), Counters{0, 0, 0});
+    _totals.assign(passes.size(), Counters{0, 0, 0});
+    _passFrames.assign(passes.size(), 0);
+
+    VkQueryPoolCreateInfo queryPoolInfo = {};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    queryPoolInfo.queryCount = framesInFlight * uint32_t(passes.size());
+    queryPoolInfo.pipelineStatistics = kStatistics;
+
+    if (vkCreateQueryPool(_queries.parent(), &queryPoolInfo, hostAllocator(VK_OBJECT_TYPE_QUERY_POOL), _queries.replace()) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to create pipeline statistics query pool!");
+    }
+    DEBUG_NAME(_queries, "pipeline statistics");
+}
+
+void PipelineStatistics::reset(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (!enabled()) {
+        return;
+    }
+    _vk->vkCmdResetQueryPool(commandBuffer, _queries, _query(frame, 0), uint32_t(_passes.size()));
+    _recorded[frame] = true;
+}
+
+void PipelineStatistics::begin(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t pass) {
+    if (enabled()) {
+        _vk->vkCmdBeginQuery(commandBuffer, _queries, _query(frame, pass), 0);
+    }
+}
+
+void PipelineStatistics::end(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t pass) {
+    if (enabled()) {
+        _vk->vkCmdEndQuery(commandBuffer, _queries, _query(frame, pass));
+    }
+}
+
+void PipelineStatistics::collect(uint32_t frame) {
+    if (!enabled() || !_recorded[frame]) {
+        return;
+    }
+    _recorded[frame] = false;
+
+    /**
+     * Laid out as the results of a query. The fence signaled, so only the
+     * queries of passes that didn't run are unavailable, and they make the
+     * call return VK_NOT_READY.
+     */
+    struct Result {
+        Counters counters;
+        uint64_t available;
+    };
+    std::vector<Result> results(_passes.size());
+    VkResult result = _vk->vkGetQueryPoolResults(_queries.parent(), _queries, _query(frame, 0), uint32_t(_passes.size()),
+            results.size() * sizeof(Result), results.data(), sizeof(Result), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        return;
+    }
+
+    /* Stamped when read, a frame or two after the GPU ran them */
+    uint64_t now = Profiler::now();
+    for (size_t pass = 0; pass < _passes.size(); ++pass) {
+        if (!results[pass].available) {
+            _lastFrame[pass] = Counters{0, 0, 0};
+            continue;
+        }
+
+        const Counters& passCounters = results[pass].counters;
+        _lastFrame[pass] = passCounters;
+        _totals[pass].vertexInvocations += passCounters.vertexInvocations;
+        _totals[pass].clippingPrimitives += passCounters.clippingPrimitives;
+        _totals[pass].fragmentInvocations += passCounters.fragmentInvocations;
+        _passFrames[pass]++;
+
+        Profiler::instance().counter(_passes[pass], now, {
+            {"vertex invocations", passCounters.vertexInvocations},
+            {"clipping primitives", passCounters.clippingPrimitives},
+            {"fragment invocations", passCounters.fragmentInvocations}
+        });
+    }
+}
+
+void PipelineStatistics::report(std::ostream& out, uint64_t pixels) const {
+    if (!enabled()) {
+        return;
+    }
+
+    out << std::fixed << std::setprecision(2);
+    out << "Pipeline statistics, average per frame:" << std::endl;
+    for (size_t pass = 0; pass < _passes.size(); ++pass) {
+        uint64_t frames = _passFrames[pass];
+        if (frames == 0) {
+            continue;
+        }
+
+        const Counters& totals = _totals[pass];
+        out << "\t" << _passes[pass] << ": " << totals.vertexInvocations / frames << " vertex invocations, "
+            << totals.clippingPrimitives / frames << " clipping primitives, "
+            << totals.fragmentInvocations / frames << " fragment invocations, "
+            << double(totals.fragmentInvocations) / double(frames * pixels) << " fragments per pixel, "
+            << frames << " frames" << std::endl;
+    }
+}
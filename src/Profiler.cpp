@@ -0,0 +1,221 @@
+/**
+ * @class   Profiler
+ * @brief   CPU zones for every frame, cheap enough to stay in production
+ *          builds, streamed to a Chrome trace with the GPU time of frames
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+/**
+ * How often the writer thread drains the rings. A ring holds 16K events,
+ * far more than a thread records in that time.
+ */
+const std::chrono::milliseconds kDrainPeriod(50);
+
+/**
+ * Track of the GPU intervals, after every thread
+ */
+const uint32_t kGpuTrack = 1000;
+
+}
+
+thread_local Profiler::ThreadBuffer* Profiler::_currentBuffer = nullptr;
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::~Profiler() {
+    stop();
+}
+
+bool Profiler::start(const std::string& path) {
+    stop();
+
+    _file.open(path);
+    if (!_file) {
+        return false;
+    }
+    _file << std::fixed << std::setprecision(3);
+    _file << "{\"traceEvents\":[" << std::endl;
+    _firstEvent = true;
+
+    {
+        std::lock_guard<std::mutex> lock(_gpuMutex);
+        _gpuEvents.clear();
+        _gpuOffset = INT64_MIN;
+        _counters.clear();
+    }
+
+    /* Whatever the rings held from an earlier capture is skipped */
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        for (auto& buffer : _buffers) {
+            buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+            buffer->dropped = 0;
+        }
+    }
+
+    _startTicks = now();
+    _startTime = std::chrono::steady_clock::now();
+    _nsPerTick = 1.0;
+
+    _stopping = false;
+    _capturing = true;
+    _writer = std::thread(&Profiler::_writerLoop, this);
+    return true;
+}
+
+void Profiler::stop() {
+    if (!_writer.joinable()) {
+        return;
+    }
+
+    _capturing = false;
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _writer.join();
+
+    /* Zones that started before the capture stopped may still be pushed, they are left in the rings */
+    _drain();
+
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        for (const auto& buffer : _buffers) {
+            _file << (_firstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->index
+                  << ",\"args\":{\"name\":\"" << (buffer->name.empty() ? "thread " + std::to_string(buffer->index) : buffer->name)
+                  << "\",\"dropped\":" << buffer->dropped.load() << "}}";
+            _firstEvent = false;
+        }
+    }
+    _file << (_firstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << kGpuTrack
+          << ",\"args\":{\"name\":\"GPU\"}}" << std::endl;
+    _file << "]}" << std::endl;
+    _file.close();
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer* buffer = _threadBuffer();
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    buffer->name = name;
+}
+
+void Profiler::gpuZone(const char* name, uint64_t submitTicks, uint64_t gpuBegin, uint64_t gpuEnd) {
+    if (!capturing()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_gpuMutex);
+    _gpuEvents.push_back({name, submitTicks, gpuBegin, gpuEnd});
+}
+
+void Profiler::counter(const char* name, uint64_t ticks, std::initializer_list<std::pair<const char*, uint64_t>> values) {
+    if (!capturing()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_gpuMutex);
+    _counters.push_back({name, ticks, values});
+}
+
+Profiler::ThreadBuffer* Profiler::_threadBuffer() {
+    if (!_currentBuffer) {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        _buffers.emplace_back(new ThreadBuffer());
+        _currentBuffer = _buffers.back().get();
+        _currentBuffer->index = uint32_t(_buffers.size() - 1);
+    }
+    return _currentBuffer;
+}
+
+void Profiler::_writerLoop() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_stopping) {
+        _wake.wait_for(lock, kDrainPeriod, [this]() { return _stopping; });
+
+        lock.unlock();
+        _drain();
+        lock.lock();
+    }
+}
+
+void Profiler::_drain() {
+    _calibrate();
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        for (auto& buffer : _buffers) {
+            buffers.push_back(buffer.get());
+        }
+    }
+
+    for (ThreadBuffer* buffer : buffers) {
+        uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint32_t head = buffer->head.load(std::memory_order_acquire);
+
+        for (; tail != head; ++tail) {
+            const Event& event = buffer->events[tail & (ThreadBuffer::kCapacity - 1)];
+            _writeEvent(event.name, buffer->index, _ticksToMicroseconds(event.begin), _ticksToMicroseconds(event.end));
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+
+    std::vector<GpuEvent> gpuEvents;
+    std::vector<CounterEvent> counters;
+    int64_t gpuOffset;
+    {
+        std::lock_guard<std::mutex> lock(_gpuMutex);
+        gpuEvents.swap(_gpuEvents);
+        counters.swap(_counters);
+
+        /* The GPU starts a submission after it was submitted, the tightest bound so far is the best guess */
+        for (const auto& event : gpuEvents) {
+            int64_t submit = int64_t(_ticksToMicroseconds(event.submitTicks) * 1000.0);
+            _gpuOffset = std::max(_gpuOffset, submit - int64_t(event.begin));
+        }
+        gpuOffset = _gpuOffset;
+    }
+
+    for (const auto& event : gpuEvents) {
+        _writeEvent(event.name, kGpuTrack, (int64_t(event.begin) + gpuOffset) / 1000.0, (int64_t(event.end) + gpuOffset) / 1000.0);
+    }
+
+    for (const auto& counter : counters) {
+        _file << (_firstEvent ? "" : ",\n") << "{\"name\":\"" << counter.name << "\",\"ph\":\"C\",\"pid\":0,\"ts\":"
+              << _ticksToMicroseconds(counter.ticks) << ",\"args\":{";
+        for (size_t i = 0; i < counter.values.size(); ++i) {
+            _file << (i ? "," : "") << "\"" << counter.values[i].first << "\":" << counter.values[i].second;
+        }
+        _file << "}}";
+        _firstEvent = false;
+    }
+    _file.flush();
+}
+
+void Profiler::_calibrate() {
+    /* Over the whole capture, so the error of reading both clocks fades away */
+    uint64_t ticks = now() - _startTicks;
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _startTime).count();
+    if (ticks > 0 && elapsed > 1e6) {
+        _nsPerTick = elapsed / double(ticks);
+    }
+}
+
+double Profiler::_ticksToMicroseconds(uint64_t ticks) const {
+    return double(int64_t(ticks - _startTicks)) * _nsPerTick / 1000.0;
+}
+
+void Profiler::_writeEvent(const char* name, uint32_t track, double begin, double end) {
+    _file << (_firstEvent ? "" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << track
+          << ",\"ts\":" << begin << ",\"dur\":" << end - begin << "}";
+    _firstEvent = false;
+}
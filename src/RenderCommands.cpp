@@ -0,0 +1,152 @@
+/**
+ * @file    RenderCommands.cpp
+ * @brief   Compact draw packets written by the game code and replayed into
+ *          Vulkan by the render thread
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "RenderCommands.hpp"
+#include "DebugUtils.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+/**
+ * The keys are sorted a byte at a time
+ */
+const int kRadixPasses = sizeof(uint64_t);
+const int kRadixBuckets = 256;
+
+/**
+ * Index of a mesh or pipeline no packet uses, so the first draw binds
+ */
+const uint32_t kNoBinding = ~0u;
+
+}
+
+uint64_t RenderCommands::sortKey(uint8_t pass, uint16_t pipeline, uint16_t mesh, uint32_t depth) {
+    return (uint64_t(pass) << 56) | (uint64_t(pipeline) << 40) | (uint64_t(mesh) << 24) | (depth & 0xFFFFFF);
+}
+
+void RenderCommands::reset(uint32_t threads) {
+    _threads.resize(threads);
+    for (auto& thread : _threads) {
+        thread.packets.clear();
+    }
+}
+
+void RenderCommands::draw(uint32_t thread, uint64_t key, uint16_t pipeline, uint16_t mesh,
+                          uint32_t firstInstance, uint32_t instanceCount) {
+    _threads[thread].packets.push_back({key, pipeline, mesh, firstInstance, instanceCount});
+}
+
+size_t RenderCommands::size() const {
+    size_t size = 0;
+    for (const auto& thread : _threads) {
+        size += thread.packets.size();
+    }
+    return size;
+}
+
+void RenderCommandQueue::sort(const RenderCommands& commands) {
+    _packets.clear();
+    for (const auto& thread : commands._threads) {
+        _packets.insert(_packets.end(), thread.packets.begin(), thread.packets.end());
+    }
+
+    size_t count = _packets.size();
+    if (count < 2) {
+        return;
+    }
+
+    /* Histograms of every byte in a single read of the keys */
+    uint32_t histograms[kRadixPasses][kRadixBuckets] = {};
+    for (const auto& packet : _packets) {
+        for (int pass = 0; pass < kRadixPasses; ++pass) {
+            histograms[pass][(packet.key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    _scratch.resize(count);
+    DrawPacket* source = _packets.data();
+    DrawPacket* destination = _scratch.data();
+
+    for (int pass = 0; pass < kRadixPasses; ++pass) {
+        uint32_t* histogram = histograms[pass];
+        int shift = pass * 8;
+
+        /* Every key has the same byte here, which is common in the high bytes */
+        if (histogram[(source[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < kRadixBuckets; ++bucket) {
+            uint32_t bucketSize = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != _packets.data()) {
+        _packets.swap(_scratch);
+    }
+}
+
+RenderCommandQueue::Stats RenderCommandQueue::record(const DeviceDispatch& vk, VkCommandBuffer commandBuffer,
+                                                     const std::vector<VkPipeline>& pipelines,
+                                                     const std::vector<RenderMesh>& meshes) const {
+    Stats stats;
+    uint32_t boundPipeline = kNoBinding;
+    uint32_t boundMesh = kNoBinding;
+    const RenderMesh* mesh = nullptr;
+
+    for (const auto& packet : _packets) {
+        if (packet.pipeline >= pipelines.size() || packet.mesh >= meshes.size()) {
+            throw std::runtime_error("ERROR draw packet with unknown pipeline " + std::to_string(packet.pipeline) +
+                                     " or mesh " + std::to_string(packet.mesh));
+        }
+
+        DEBUG_LABEL(commandBuffer, "draw pipeline " + std::to_string(packet.pipeline) + " mesh " + std::to_string(packet.mesh));
+
+        if (packet.pipeline != boundPipeline) {
+            vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[packet.pipeline]);
+            boundPipeline = packet.pipeline;
+            stats.pipelineBinds++;
+        }
+
+        if (packet.mesh != boundMesh) {
+            mesh = &meshes[packet.mesh];
+            if (mesh->vertexBuffer != VK_NULL_HANDLE) {
+                VkDeviceSize offset = 0;
+                vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh->vertexBuffer, &offset);
+            }
+            if (mesh->indexBuffer != VK_NULL_HANDLE) {
+                vk.vkCmdBindIndexBuffer(commandBuffer, mesh->indexBuffer, 0, mesh->indexType);
+            }
+            boundMesh = packet.mesh;
+            stats.meshBinds++;
+        }
+
+        if (mesh->indexBuffer != VK_NULL_HANDLE) {
+            vk.vkCmdDrawIndexed(commandBuffer, mesh->count, packet.instanceCount, mesh->first, mesh->vertexOffset, packet.firstInstance);
+        } else {
+            vk.vkCmdDraw(commandBuffer, mesh->count, packet.instanceCount, mesh->first, packet.firstInstance);
+        }
+        stats.draws++;
+    }
+
+    return stats;
+}
+
+const std::vector<DrawPacket>& RenderCommandQueue::packets() const {
+    return _packets;
+}
@@ -0,0 +1,113 @@
+/**
+ * @class   StartupTrace
+ * @brief   Timestamps of the startup steps and of the loader and driver
+ *          calls they make, dumped as a Chrome trace and a summary table
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "StartupTrace.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+namespace {
+
+/**
+ * Writes text as a JSON string
+ */
+void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (uint8_t(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}
+
+StartupTrace::StartupTrace() : _origin(Clock::now()), _threads{std::this_thread::get_id()} {
+}
+
+void StartupTrace::record(const std::string& name, const char* category, Clock::time_point start, Clock::time_point end) {
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.start = std::chrono::duration<double, std::micro>(start - _origin).count();
+    event.duration = std::chrono::duration<double, std::micro>(end - start).count();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto thread = std::find(_threads.begin(), _threads.end(), std::this_thread::get_id());
+    event.thread = uint32_t(thread - _threads.begin());
+    if (thread == _threads.end()) {
+        _threads.push_back(std::this_thread::get_id());
+    }
+
+    _events.push_back(std::move(event));
+}
+
+void StartupTrace::writeChromeTrace(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[" << std::endl;
+
+    for (uint32_t thread = 0; thread < _threads.size(); ++thread) {
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread
+            << ",\"args\":{\"name\":\"" << (thread == 0 ? "main" : "thread " + std::to_string(thread)) << "\"}}," << std::endl;
+    }
+
+    for (size_t i = 0; i < _events.size(); ++i) {
+        const Event& event = _events[i];
+        out << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+            << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}"
+            << (i + 1 < _events.size() ? "," : "") << std::endl;
+    }
+
+    out << "]}" << std::endl;
+}
+
+void StartupTrace::report(std::ostream& out) {
+    struct Summary {
+        const char* category;
+        uint32_t calls;
+        double total;
+        double longest;
+    };
+
+    std::map<std::string, Summary> summaries;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& event : _events) {
+            auto inserted = summaries.insert({event.name, {event.category, 0, 0.0, 0.0}});
+            Summary& summary = inserted.first->second;
+            summary.calls++;
+            summary.total += event.duration;
+            summary.longest = std::max(summary.longest, event.duration);
+        }
+    }
+
+    std::vector<std::pair<std::string, Summary>> sorted(summaries.begin(), summaries.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, Summary>& a, const std::pair<std::string, Summary>& b) {
+        return a.second.total > b.second.total;
+    });
+
+    out << std::fixed << std::setprecision(2);
+    out << "Startup trace:" << std::endl;
+    out << "\t" << std::left << std::setw(40) << "event" << std::setw(10) << "category" << std::right
+        << std::setw(8) << "calls" << std::setw(12) << "total ms" << std::setw(12) << "longest ms" << std::endl;
+    for (const auto& entry : sorted) {
+        out << "\t" << std::left << std::setw(40) << entry.first << std::setw(10) << entry.second.category << std::right
+            << std::setw(8) << entry.second.calls << std::setw(12) << entry.second.total / 1000.0
+            << std::setw(12) << entry.second.longest / 1000.0 << std::endl;
+    }
+}
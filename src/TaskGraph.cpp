@@ -0,0 +1,155 @@
+/**
+ * @class   TaskGraph
+ * @brief   Named tasks with dependencies, run as soon as what they need is
+ *          done and timed
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+TaskGraph::Task TaskGraph::add(const std::string& name, std::function<void()> function,
+                               const std::vector<Task>& dependencies, bool onMainThread) {
+    Task task = Task(_nodes.size());
+
+    std::unique_ptr<Node> node(new Node());
+    node->name = name;
+    node->function = std::move(function);
+    node->onMainThread = onMainThread;
+    node->dependencies = dependencies;
+
+    for (Task dependency : dependencies) {
+        if (dependency >= task) {
+            throw std::runtime_error("ERROR task " + name + " depends on a task added after it");
+        }
+        _nodes[dependency]->dependents.push_back(task);
+    }
+
+    _nodes.push_back(std::move(node));
+    return task;
+}
+
+void TaskGraph::run(JobSystem& jobs, StartupTrace* trace) {
+    _jobs = &jobs;
+    _trace = trace;
+    _error = nullptr;
+    _start = std::chrono::steady_clock::now();
+
+    for (auto& node : _nodes) {
+        node->pending = uint32_t(node->dependencies.size());
+        node->ran = false;
+    }
+
+    /* Roots only, every other task is queued by the last of its dependencies to finish */
+    for (Task task = 0; task < _nodes.size(); ++task) {
+        if (_nodes[task]->dependencies.empty()) {
+            _queue(task);
+        }
+    }
+
+    jobs.wait(_done);
+    _total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+
+    if (_error) {
+        std::rethrow_exception(_error);
+    }
+}
+
+std::vector<TaskGraph::Timing> TaskGraph::timings() const {
+    std::vector<Timing> timings;
+    for (const auto& node : _nodes) {
+        if (node->ran) {
+            timings.push_back(node->timing);
+        }
+    }
+    return timings;
+}
+
+void TaskGraph::report(std::ostream& out) const {
+    /* Longest chain of dependencies, nodes are in topological order already */
+    std::vector<double> pathTime(_nodes.size(), 0.0);
+    std::vector<int64_t> pathPrevious(_nodes.size(), -1);
+    int64_t last = -1;
+
+    for (Task task = 0; task < _nodes.size(); ++task) {
+        const Node& node = *_nodes[task];
+        if (!node.ran) {
+            continue;
+        }
+        for (Task dependency : node.dependencies) {
+            if (pathTime[dependency] > pathTime[task]) {
+                pathTime[task] = pathTime[dependency];
+                pathPrevious[task] = dependency;
+            }
+        }
+        pathTime[task] += node.timing.end - node.timing.start;
+        if (last < 0 || pathTime[task] > pathTime[last]) {
+            last = task;
+        }
+    }
+
+    std::vector<Timing> sorted = timings();
+    std::sort(sorted.begin(), sorted.end(), [](const Timing& a, const Timing& b) { return a.start < b.start; });
+
+    out << std::fixed << std::setprecision(2);
+    out << "Startup: " << _total << " ms" << std::endl;
+    for (const auto& timing : sorted) {
+        out << "\t" << std::left << std::setw(24) << timing.name << std::right
+            << " thread " << std::setw(2) << timing.thread
+            << std::setw(10) << timing.start << " ms" << std::setw(10) << timing.end - timing.start << " ms" << std::endl;
+    }
+
+    if (last >= 0) {
+        std::string path;
+        for (int64_t task = last; task >= 0; task = pathPrevious[task]) {
+            path = _nodes[task]->name + (path.empty() ? "" : " > " + path);
+        }
+        out << "Critical path: " << pathTime[last] << " ms, " << path << std::endl;
+    }
+}
+
+void TaskGraph::_queue(Task task) {
+    if (_nodes[task]->onMainThread) {
+        _jobs->runOnMainThread([this, task]() { _execute(task); }, &_done);
+    } else {
+        _jobs->run([this, task]() { _execute(task); }, &_done);
+    }
+}
+
+void TaskGraph::_execute(Task task) {
+    Node& node = *_nodes[task];
+
+    auto start = std::chrono::steady_clock::now();
+    node.timing.name = node.name;
+    node.timing.thread = _jobs->threadIndex();
+    node.timing.start = std::chrono::duration<double, std::milli>(start - _start).count();
+
+    try {
+        node.function();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (!_error) {
+            _error = std::current_exception();
+        }
+
+        /* Dependents are never queued, _done only waits for the rest */
+        return;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    node.timing.end = std::chrono::duration<double, std::milli>(end - _start).count();
+    node.ran = true;
+    if (_trace) {
+        _trace->record(node.name, "step", start, end);
+    }
+
+    /* Queued before this job signals _done, so it can't reach zero in between */
+    for (Task dependent : node.dependents) {
+        if (_nodes[dependent]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _queue(dependent);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @class   VertexQuantizer
+ * @brief   Compresses mesh vertex attributes before upload and describes
+ *          the resulting layout to the graphics pipeline
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "VertexQuantizer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/batch_packing.hpp>
+#include <stdexcept>
+
+VertexQuantizer::VertexQuantizer(VkPhysicalDevice physicalDevice, UVFormat uvFormat) : _uvFormat(uvFormat) {
+    /**
+     * 10_10_10_2 snorm is not mandatory for vertex fetch, while 8 bits
+     * snorm is, so use it as fallback
+     */
+    if (_supportsVertexFormat(physicalDevice, VK_FORMAT_A2B10G10R10_SNORM_PACK32)) {
+        _normalFormat = VK_FORMAT_A2B10G10R10_SNORM_PACK32;
+    } else {
+        _normalFormat = VK_FORMAT_R8G8B8A8_SNORM;
+    }
+}
+
+VertexQuantizer::QuantizedMesh VertexQuantizer::quantize(const Mesh& mesh) const {
+    size_t vertexCount = mesh.positions.size();
+
+    if (!mesh.normals.empty() && mesh.normals.size() != vertexCount) {
+        throw std::runtime_error("ERROR number of normals does not match the number of positions");
+    }
+    if (!mesh.uvs.empty() && mesh.uvs.size() != vertexCount) {
+        throw std::runtime_error("ERROR number of uvs does not match the number of positions");
+    }
+
+    QuantizedMesh result;
+
+    auto addStream = [&result](uint32_t location, VkFormat format, uint32_t stride) {
+        VkVertexInputBindingDescription binding = {};
+        binding.binding = static_cast<uint32_t>(result.bindings.size());
+        binding.stride = stride;
+        binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        VkVertexInputAttributeDescription attribute = {};
+        attribute.location = location;
+        attribute.binding = binding.binding;
+        attribute.format = format;
+        attribute.offset = 0;
+
+        result.bindings.push_back(binding);
+        result.attributes.push_back(attribute);
+    };
+
+    /**
+     * Positions are stored relative to the mesh bounds, so the full 16 bits
+     * range covers the mesh whatever its size
+     */
+    glm::vec3 boundsMin(0.0f);
+    glm::vec3 boundsMax(0.0f);
+    if (vertexCount > 0) {
+        boundsMin = boundsMax = mesh.positions[0];
+        for (const auto& position : mesh.positions) {
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+        }
+    }
+
+    result.positions.resize(vertexCount * 4);
+    glm::packBoundedUnorm4x16(mesh.positions.data(), boundsMin, boundsMax, result.positions.data(), vertexCount);
+    result.dequantize = glm::scale(glm::translate(glm::mat4(1.0f), boundsMin), boundsMax - boundsMin);
+    addStream(0, VK_FORMAT_R16G16B16A16_UNORM, 4 * sizeof(uint16_t));
+
+    if (!mesh.normals.empty()) {
+        result.normals.resize(vertexCount);
+        if (_normalFormat == VK_FORMAT_A2B10G10R10_SNORM_PACK32) {
+            glm::packSnorm3x10_1x2(mesh.normals.data(), result.normals.data(), vertexCount);
+        } else {
+            for (size_t i = 0; i < vertexCount; i++) {
+                result.normals[i] = glm::packSnorm4x8(glm::vec4(mesh.normals[i], 0.0f));
+            }
+        }
+        addStream(1, _normalFormat, sizeof(uint32_t));
+    }
+
+    if (!mesh.uvs.empty()) {
+        result.uvs.resize(vertexCount);
+        if (_uvFormat == UVFormat::HALF) {
+            glm::packHalf2x16(mesh.uvs.data(), result.uvs.data(), vertexCount);
+            addStream(2, VK_FORMAT_R16G16_SFLOAT, sizeof(uint32_t));
+        } else {
+            glm::packUnorm2x16(mesh.uvs.data(), result.uvs.data(), vertexCount);
+            addStream(2, VK_FORMAT_R16G16_UNORM, sizeof(uint32_t));
+        }
+    }
+
+    return result;
+}
+
+bool VertexQuantizer::_supportsVertexFormat(VkPhysicalDevice physicalDevice, VkFormat format) {
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+
+    return (properties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT) != 0;
+}
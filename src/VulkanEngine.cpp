@@ -5,9 +5,13 @@
  * @author	Roberto Cano (http://www.robertocano.es)
  */
 #include "VulkanEngine.hpp"
+#include "DebugUtils.hpp"
+#include "Profiler.hpp"
+#include "TaskGraph.hpp"
 
 #include <iostream>
 #include <stdexcept>
+#include <cstdlib>
 #include <algorithm>
 #include <cstring>
 #include <set>
@@ -19,34 +23,110 @@
          const bool enableValidationLayers = true;
 #endif
 
-VkResult VulkanEngine::CreateDebugReportCallbackEXT(VkInstance instance,
-                                             const VkDebugReportCallbackCreateInfoEXT* pCreateInfo,
+/**
+ * Runs a loader or driver call through _startupTrace, named after the
+ * function called
+ */
+#define STARTUP_CALL(function, ...) _startupTrace.call(#function, [&]() { return function(__VA_ARGS__); })
+
+namespace {
+
+/**
+ * Indices of the pipeline and mesh tables the draw packets refer to
+ */
+const uint16_t kTrianglePipeline = 0;
+const uint16_t kTriangleMesh = 0;
+
+/**
+ * Chrome trace of the startup, written after the first frame
+ */
+const char* const kStartupTraceFile = "startup_trace.json";
+
+/**
+ * Environment variable with the path of the frame profile to capture, not
+ * captured if unset
+ */
+const char* const kProfileTraceVariable = "PROFILE_TRACE";
+
+/**
+ * Timestamps written by every frame in flight, at its beginning and end
+ */
+const uint32_t kTimestampsPerFrame = 2;
+
+/**
+ * Environment variable enabling pipeline statistics, when set to anything
+ * and the device supports them
+ */
+const char* const kPipelineStatisticsVariable = "PIPELINE_STATISTICS";
+
+/**
+ * Environment variable enabling the depth prepass, when set to anything
+ */
+const char* const kDepthPrepassVariable = "DEPTH_PREPASS";
+
+/**
+ * Environment variable with the MSAA samples wanted, 1 disables it. The
+ * highest count the device supports up to it is used.
+ */
+const char* const kMsaaSamplesVariable = "MSAA_SAMPLES";
+const uint32_t kDefaultMsaaSamples = 4;
+
+/**
+ * Environment variable with the GPU time budget of a frame in ms. When set
+ * the render resolution adapts to stay within it, otherwise frames render
+ * at full resolution straight to the swap chain.
+ */
+const char* const kGpuFrameBudgetVariable = "GPU_FRAME_BUDGET";
+
+/**
+ * Passes measured by the pipeline statistics, by index
+ */
+const uint32_t kDepthPrepass = 0;
+const uint32_t kShadingPass = 1;
+const std::vector<const char*> kStatisticsPasses = {"depth prepass", "shading"};
+
+/**
+ * Sets handles to count empty wrappers parented to parent. VDeleter can't
+ * be copied, so resize() can't be given one to copy.
+ */
+template <typename T, typename P>
+void resizeHandles(std::vector<VDeleter<T>>& handles, size_t count, const VDeleter<P>& parent) {
+    handles.clear();
+    handles.reserve(count);
+    while (handles.size() < count) {
+        handles.emplace_back(parent);
+    }
+}
+
+}
+
+VkResult VulkanEngine::CreateDebugUtilsMessengerEXT(VkInstance instance,
+                                             const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
                                              const VkAllocationCallbacks* pAllocator,
-                                             VkDebugReportCallbackEXT* pCallback)
+                                             VkDebugUtilsMessengerEXT* pMessenger)
 {
-    auto func = (PFN_vkCreateDebugReportCallbackEXT) vkGetInstanceProcAddr(instance, "vkCreateDebugReportCallbackEXT");
+    auto func = (PFN_vkCreateDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
     if (func != nullptr) {
-        return func(instance, pCreateInfo, pAllocator, pCallback);
+        return func(instance, pCreateInfo, pAllocator, pMessenger);
     } else {
         return VK_ERROR_EXTENSION_NOT_PRESENT;
     }
 }
 
-void VulkanEngine::DestroyDebugReportCallbackEXT(VkInstance instance, VkDebugReportCallbackEXT callback, const VkAllocationCallbacks* pAllocator) {
-    auto func = (PFN_vkDestroyDebugReportCallbackEXT) vkGetInstanceProcAddr(instance, "vkDestroyDebugReportCallbackEXT");
-    if (func != nullptr) {
-        func(instance, callback, pAllocator);
-    }
-}
-
 void VulkanEngine::run() {
-    _initWindow();
+    _startTime = std::chrono::steady_clock::now();
     _initVulkan();
+
+    const char* profilePath = std::getenv(kProfileTraceVariable);
+    if (profilePath && !Profiler::instance().start(profilePath)) {
+        std::cerr << "Can't write the frame profile to " << profilePath << std::endl;
+    }
+
     _mainLoop();
 }
 
-void VulkanEngine::_initWindow() {
-    glfwInit();
+void VulkanEngine::_initGlfw() {
+    STARTUP_CALL(glfwInit);
 
     /**
      * GLFW_NO_API is how we indicate that we want the window
@@ -58,33 +138,176 @@ void VulkanEngine::_initWindow() {
      * TODO: for now resizing in Vulkan is cumbersome, so don't do it
      */
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+}
 
-    _window = glfwCreateWindow(WIDTH, HEIGHT, "Vulkan", nullptr, nullptr);
+void VulkanEngine::_initWindow() {
+    _window = STARTUP_CALL(glfwCreateWindow, WIDTH, HEIGHT, "Vulkan", nullptr, nullptr);
 }
 
 void VulkanEngine::_initVulkan() {
-    _createInstance();
-    _setupDebugCallback();
-    _createSurface();
-    _pickPhysicalDevice();
-    _createLogicalDevice();
-    _createSwapChain();
-    _createImageViews();
-    _createRenderPass();
-    _createGraphicsPipeline();
-    _createFramebuffers();
-    _createCommandPool();
-    _createCommandBuffers();
-    _createSemaphores();
+    /**
+     * Every step runs as soon as the ones it needs are done: shaders load
+     * while the device is created, the window opens while the instance is,
+     * and everything hanging from the device overlaps. GLFW init and window
+     * creation must be on the main thread; the required extensions and
+     * surface creation can be called from any thread.
+     */
+    _depthPrepass = std::getenv(kDepthPrepassVariable) != nullptr;
+
+    TaskGraph startup;
+
+    auto glfw = startup.add("glfw", [this]() { _initGlfw(); }, {}, true);
+    auto window = startup.add("window", [this]() { _initWindow(); }, {glfw}, true);
+    auto shaders = startup.add("shaders", [this]() { _loadShaders(); });
+    auto instance = startup.add("instance", [this]() { _createInstance(); }, {glfw});
+    auto debugCallback = startup.add("debug callback", [this]() { _setupDebugCallback(); }, {instance});
+    auto surface = startup.add("surface", [this]() { _createSurface(); }, {instance, window});
+    auto physicalDevice = startup.add("physical device", [this]() { _pickPhysicalDevice(); }, {surface, debugCallback});
+    auto device = startup.add("logical device", [this]() { _createLogicalDevice(); }, {physicalDevice});
+    auto swapChain = startup.add("swap chain", [this]() { _createSwapChain(); }, {device});
+    auto imageViews = startup.add("image views", [this]() { _createImageViews(); }, {swapChain});
+    auto renderPass = startup.add("render pass", [this]() { _createRenderPass(); }, {swapChain});
+    auto depthBuffer = startup.add("depth buffer", [this]() { _createDepthResources(); }, {renderPass});
+    auto colorBuffer = startup.add("color buffer", [this]() { _createColorResources(); }, {renderPass});
+    startup.add("graphics pipeline", [this]() { _createGraphicsPipeline(); }, {renderPass, shaders});
+    startup.add("framebuffers", [this]() { _createFramebuffers(); }, {imageViews, renderPass, depthBuffer, colorBuffer});
+    auto commandPool = startup.add("command pool", [this]() { _createCommandPool(); }, {device});
+    startup.add("command buffers", [this]() { _createCommandBuffers(); }, {commandPool});
+    startup.add("sync objects", [this]() { _createSyncObjects(); }, {device});
+    startup.add("timestamp queries", [this]() { _createTimestampQueries(); }, {device});
+    startup.add("statistics queries", [this]() { _createStatisticsQueries(); }, {device});
+
+    startup.run(_jobs, &_startupTrace);
+    startup.report(std::cout);
 }
 
 void VulkanEngine::_mainLoop() {
-    while (!glfwWindowShouldClose(_window)) {
-        glfwPollEvents();
-        _drawFrame();
+    /**
+     * Frames go through two stages: this thread simulates frame N + 1
+     * while the render thread records and submits frame N from its
+     * snapshot
+     */
+    _renderThread = std::thread(&VulkanEngine::_renderLoop, this);
+
+    /* Destroying a thread that wasn't joined terminates, throwing from here would */
+    struct RenderThreadGuard {
+        VulkanEngine* engine;
+        ~RenderThreadGuard() {
+            engine->_stopRenderThread();
+        }
+    } renderThreadGuard{this};
+
+    Profiler::instance().setThreadName("main");
+
+    uint64_t frame = 0;
+    double time = glfwGetTime();
+
+    while (!glfwWindowShouldClose(_window) && !_quit) {
+        PROFILE_ZONE("frame");
+
+        {
+            PROFILE_ZONE("poll events");
+            glfwPollEvents();
+        }
+
+        /**
+         * GLFW can only be called from the main thread, jobs needing it
+         * are queued with runOnMainThread and run here
+         */
+        {
+            PROFILE_ZONE("main thread jobs");
+            _jobs.runMainThreadJobs();
+        }
+
+        /* The buffer handed back by publish() holds an older frame, overwrite it all */
+        FrameState& state = _frameStates.back();
+        double now = glfwGetTime();
+
+        state.frame = ++frame;
+        state.deltaTime = now - time;
+        state.time = time = now;
+
+        _simulate(state);
+        _frameStates.publish();
+
+        /* Wake the render thread and don't get more than a frame ahead of it */
+        PROFILE_ZONE("wait render thread");
+        std::unique_lock<std::mutex> lock(_frameMutex);
+        _frameReady.notify_one();
+        _frameTaken.wait(lock, [this]() { return !_frameStates.pending() || _quit; });
     }
 
-    vkDeviceWaitIdle(_device);
+    _stopRenderThread();
+
+    _vk.vkDeviceWaitIdle(_device);
+    _destroyAttachment(_depthAttachment);
+    _destroyAttachment(_colorAttachment);
+    _destroyAttachment(_sceneAttachment);
+    _deletionQueue.flush();
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        _readTimestamps(i);
+        _pipelineStatistics.collect(i);
+    }
+    Profiler::instance().stop();
+    HostAllocator::instance().report(std::cout);
+    _memoryBudget.report(std::cout);
+    _dynamicResolution.report(std::cout);
+    _pipelineStatistics.report(std::cout, _dynamicResolution.averagePixels());
+
+    if (_renderError) {
+        std::rethrow_exception(_renderError);
+    }
+}
+
+void VulkanEngine::_stopRenderThread() {
+    if (!_renderThread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_frameMutex);
+        _quit = true;
+    }
+    _frameReady.notify_one();
+    _renderThread.join();
+}
+
+void VulkanEngine::_simulate(FrameState& state) {
+    PROFILE_ZONE("simulate");
+
+    state.commands.reset(_jobs.threadCount());
+
+    /* The scene is a single triangle for now */
+    state.commands.draw(_jobs.threadIndex(), RenderCommands::sortKey(0, kTrianglePipeline, kTriangleMesh, 0),
+                        kTrianglePipeline, kTriangleMesh);
+}
+
+void VulkanEngine::_renderLoop() {
+    Profiler::instance().setThreadName("render");
+
+    try {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(_frameMutex);
+                _frameReady.wait(lock, [this]() { return _frameStates.pending() || _quit; });
+                if (_quit) {
+                    break;
+                }
+                _frameStates.update();
+            }
+            _frameTaken.notify_one();
+
+            _drawFrame(_frameStates.front());
+        }
+    } catch (...) {
+        /* Handed to the main thread, which rethrows it once stopped */
+        _renderError = std::current_exception();
+        {
+            std::lock_guard<std::mutex> lock(_frameMutex);
+            _quit = true;
+        }
+        _frameTaken.notify_one();
+    }
 }
 
 void VulkanEngine::_createInstance() {
@@ -95,11 +318,11 @@ void VulkanEngine::_createInstance() {
 
     /* Query extensions */
     uint32_t extensionCount = 0;
-    vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+    STARTUP_CALL(vkEnumerateInstanceExtensionProperties, nullptr, &extensionCount, nullptr);
 
     std::vector<VkExtensionProperties> vkExtensions(extensionCount);
 
-    vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, vkExtensions.data());
+    STARTUP_CALL(vkEnumerateInstanceExtensionProperties, nullptr, &extensionCount, vkExtensions.data());
 
     std::cout << "Available Vulkan extensions:" << std::endl;
     for (const auto& extension : vkExtensions) {
@@ -123,6 +346,14 @@ void VulkanEngine::_createInstance() {
     /* Get required extensions info */
     auto requiredExtensions = _getRequiredExtensions();
 
+    /* Optional, VK_EXT_memory_budget is queried through it */
+    for (const auto& extension : vkExtensions) {
+        if (strcmp(extension.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0) {
+            requiredExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            _physicalDeviceProperties2 = true;
+        }
+    }
+
     createInfo.enabledExtensionCount = requiredExtensions.size();
     createInfo.ppEnabledExtensionNames = requiredExtensions.data();
 
@@ -135,7 +366,7 @@ void VulkanEngine::_createInstance() {
     }
 
     /* Create Vulkan instance */
-    VkResult result = vkCreateInstance(&createInfo, nullptr, &_instance);
+    VkResult result = STARTUP_CALL(vkCreateInstance, &createInfo, hostAllocator(VK_OBJECT_TYPE_INSTANCE), &_instance);
     if (result != VK_SUCCESS) {
         throw std::runtime_error("ERROR creating Vulkan instance: " + std::to_string(result));
     }
@@ -168,11 +399,21 @@ void VulkanEngine::_createLogicalDevice()
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.queueCreateInfoCount = (uint32_t)queueCreateInfos.size();
 
-    VkPhysicalDeviceFeatures deviceFeatures = {};
-    createInfo.pEnabledFeatures = &deviceFeatures;
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(_physicalDevice, &supportedFeatures);
+
+    /* Statistics queries are only enabled when asked for, they slow some GPUs down */
+    _enabledFeatures = {};
+    _enabledFeatures.pipelineStatisticsQuery = std::getenv(kPipelineStatisticsVariable) ? supportedFeatures.pipelineStatisticsQuery : VK_FALSE;
+    createInfo.pEnabledFeatures = &_enabledFeatures;
 
-    createInfo.enabledExtensionCount = _deviceExtensions.size();
-    createInfo.ppEnabledExtensionNames = _deviceExtensions.data();
+    std::vector<const char*> extensions = _deviceExtensions;
+    if (_memoryBudget.hasBudgetExtension()) {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    createInfo.enabledExtensionCount = extensions.size();
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     /* Validation layers */
     if (enableValidationLayers) {
@@ -182,27 +423,37 @@ void VulkanEngine::_createLogicalDevice()
         createInfo.enabledLayerCount = 0;
     }
 
-    if (vkCreateDevice(_physicalDevice, &createInfo, nullptr, _device.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkCreateDevice, _physicalDevice, &createInfo, hostAllocator(VK_OBJECT_TYPE_DEVICE),
+                     _device.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create logical device!");
     }
 
-    vkGetDeviceQueue(_device, indices.graphicsFamily, 0, &_graphicsQueue);
-    vkGetDeviceQueue(_device, indices.presentFamily, 0, &_presentQueue);
+    _vk.load(_device);
+
+    _vk.vkGetDeviceQueue(_device, indices.graphicsFamily, 0, &_graphicsQueue);
+    _vk.vkGetDeviceQueue(_device, indices.presentFamily, 0, &_presentQueue);
+
+    DEBUG_NAME(_device, VK_OBJECT_TYPE_DEVICE, VkDevice(_device), "device");
+    DEBUG_NAME(_device, VK_OBJECT_TYPE_QUEUE, _graphicsQueue, _graphicsQueue == _presentQueue ? "graphics and present queue" : "graphics queue");
+    if (_graphicsQueue != _presentQueue) {
+        DEBUG_NAME(_device, VK_OBJECT_TYPE_QUEUE, _presentQueue, "present queue");
+    }
 }
 
 void VulkanEngine::_createSurface()
 {
-    if (glfwCreateWindowSurface(_instance, _window, nullptr, _surface.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(glfwCreateWindowSurface, _instance, _window, hostAllocator(VK_OBJECT_TYPE_SURFACE_KHR),
+                     _surface.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create window surface!");
     }
 }
 
 bool VulkanEngine::_checkValidationLayerSupport() {
     uint32_t layerCount;
-    vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+    STARTUP_CALL(vkEnumerateInstanceLayerProperties, &layerCount, nullptr);
 
     std::vector<VkLayerProperties> availableLayers(layerCount);
-    vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+    STARTUP_CALL(vkEnumerateInstanceLayerProperties, &layerCount, availableLayers.data());
 
     /* Print layers information */
     if (layerCount > 0) {
@@ -247,7 +498,7 @@ std::vector<const char*> VulkanEngine::_getRequiredExtensions() {
     }
 
     if (enableValidationLayers) {
-        extensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
 
     return extensions;
@@ -259,36 +510,48 @@ void VulkanEngine::_setupDebugCallback()
         return;
     }
 
-    VkDebugReportCallbackCreateInfoEXT createInfo = {};
+    /* Object names and labels come from the same extension */
+    DebugUtils::instance().load(_instance);
 
-    createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_REPORT_CALLBACK_CREATE_INFO_EXT;
-    createInfo.flags = VK_DEBUG_REPORT_ERROR_BIT_EXT | VK_DEBUG_REPORT_WARNING_BIT_EXT;
-    createInfo.pfnCallback = _debugCallback;
+    VkDebugUtilsMessengerCreateInfoEXT createInfo = {};
 
-    if (CreateDebugReportCallbackEXT(_instance, &createInfo, nullptr, &_callbackHandle) != VK_SUCCESS) {
+    createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+    createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+    createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                             VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+    createInfo.pfnUserCallback = _debugCallback;
+
+    if (STARTUP_CALL(CreateDebugUtilsMessengerEXT, _instance, &createInfo,
+                     hostAllocator(VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT), &_debugMessenger) != VK_SUCCESS) {
         throw std::runtime_error("failed to set up debug callback!");
     }
 }
 
 void VulkanEngine::_pickPhysicalDevice()
 {
-    VkPhysicalDevice device = VK_NULL_HANDLE;
-
     uint32_t deviceCount = 0;
-    vkEnumeratePhysicalDevices(_instance, &deviceCount, nullptr);
+    STARTUP_CALL(vkEnumeratePhysicalDevices, _instance, &deviceCount, nullptr);
     if (deviceCount == 0) {
         throw std::runtime_error("ERROR failed to find GPUs with Vulkan support!");
     }
 
     std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(_instance, &deviceCount, devices.data());
+    STARTUP_CALL(vkEnumeratePhysicalDevices, _instance, &deviceCount, devices.data());
+
+    /**
+     * VULKAN_DEVICE picks the device by index or by a part of its name,
+     * otherwise the best rated suitable device is used
+     */
+    const char* selected = getenv("VULKAN_DEVICE");
+    uint64_t bestScore = 0;
 
     /* Show physical devices on screen */
-    for (const auto& device : devices) {
+    for (uint32_t i = 0; i < devices.size(); ++i) {
+        VkPhysicalDevice device = devices[i];
         VkPhysicalDeviceProperties props;
         vkGetPhysicalDeviceProperties(device, &props);
 
-        fprintf(stderr, "[%s] physical device\n", props.deviceName);
+        fprintf(stderr, "[%s] physical device %u\n", props.deviceName, i);
         fprintf(stderr, "\tAPI version:    %08x\n", props.apiVersion);
         fprintf(stderr, "\tDriver version: %08x\n", props.driverVersion);
         fprintf(stderr, "\tVendor ID:      %08x\n", props.vendorID);
@@ -311,22 +574,72 @@ void VulkanEngine::_pickPhysicalDevice()
             default:
                 fprintf(stderr,  "\tType:           Unknown\n");
         }
-    }
 
-    /* Pick the device */
-    for (const auto& device : devices) {
-        if (_isDeviceSuitable(device)) {
+        std::string reason;
+        if (!_isDeviceSuitable(device, reason)) {
+            fprintf(stderr, "\tRejected:       %s\n", reason.c_str());
+            continue;
+        }
+
+        uint64_t score = _rateDevice(device);
+        fprintf(stderr, "\tScore:          %llu\n", (unsigned long long) score);
+
+        if (selected) {
+            bool byIndex = selected[0] != '\0' && strspn(selected, "0123456789") == strlen(selected);
+            if (byIndex ? strtoul(selected, nullptr, 10) == i : strstr(props.deviceName, selected) != nullptr) {
+                _physicalDevice = device;
+                break;
+            }
+        } else if (score > bestScore) {
             _physicalDevice = device;
-            break;
+            bestScore = score;
         }
     }
 
     if (_physicalDevice == VK_NULL_HANDLE) {
+        if (selected) {
+            throw std::runtime_error(std::string("ERROR no suitable GPU matches VULKAN_DEVICE=") + selected);
+        }
         throw std::runtime_error("ERROR failed to find a suitable GPU!");
     }
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(_physicalDevice, &props);
+    fprintf(stderr, "Using physical device [%s]\n", props.deviceName);
+
+    /* Heap sizes, and budgets when the driver can tell them */
+    _memoryBudget.init(_instance, _physicalDevice,
+            _physicalDeviceProperties2 && _hasDeviceExtension(_physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME));
+    _memoryBudget.report(std::cout);
+}
+
+bool VulkanEngine::_isDeviceSuitable(VkPhysicalDevice device, std::string& reason)
+{
+    QueueFamilyIndices indices = _findQueueFamilies(device);
+    if (indices.graphicsFamily < 0) {
+        reason = "no graphics queue";
+        return false;
+    }
+    if (indices.presentFamily < 0) {
+        reason = "can't present to the window surface";
+        return false;
+    }
+
+    if (!_checkDeviceExtensionsSupport(device)) {
+        reason = "missing required device extensions";
+        return false;
+    }
+
+    SwapChainSupportDetails swapChainSupport = _querySwapChainSupport(device);
+    if (swapChainSupport.formats.empty() || swapChainSupport.presentModes.empty()) {
+        reason = "no surface formats or present modes for the swap chain";
+        return false;
+    }
+
+    return true;
 }
 
-bool VulkanEngine::_isDeviceSuitable(VkPhysicalDevice device)
+uint64_t VulkanEngine::_rateDevice(VkPhysicalDevice device)
 {
     VkPhysicalDeviceProperties deviceProperties;
     vkGetPhysicalDeviceProperties(device, &deviceProperties);
@@ -334,53 +647,89 @@ bool VulkanEngine::_isDeviceSuitable(VkPhysicalDevice device)
     VkPhysicalDeviceFeatures deviceFeatures;
     vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
 
-    QueueFamilyIndices indices = _findQueueFamilies(device);
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
 
-    bool extensionsSupported = _checkDeviceExtensionsSupport(device);
+    /* The type outweighs everything else, a CPU device is only used when it is all there is */
+    uint64_t score = 0;
+    switch (deviceProperties.deviceType) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            score = 4000000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            score = 3000000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            score = 2000000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            score = 1000000;
+            break;
+        default:
+            score = 1;
+    }
 
-    bool swapChainAdequate = false;
-    if (extensionsSupported) {
-        SwapChainSupportDetails swapChainSupport = _querySwapChainSupport(device);
-        swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+    /* Then the biggest device local heap, in MB */
+    VkDeviceSize localMemory = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i) {
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            localMemory = std::max(localMemory, memoryProperties.memoryHeaps[i].size);
+        }
     }
+    score += std::min<VkDeviceSize>(localMemory >> 20, 999999) / 2;
 
-    return deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU &&
-        extensionsSupported &&
-        deviceFeatures.geometryShader &&
-        indices.isComplete() &&
-        swapChainAdequate;
+    /* Limits and features break the ties between similar devices */
+    score += deviceProperties.limits.maxImageDimension2D / 1024;
+    score += deviceFeatures.samplerAnisotropy ? 8 : 0;
+    score += deviceFeatures.geometryShader ? 4 : 0;
+    score += deviceFeatures.textureCompressionBC ? 4 : 0;
+
+    return score;
 }
 
 bool VulkanEngine::_checkDeviceExtensionsSupport(VkPhysicalDevice device)
 {
     uint32_t extensionCount;
-    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    STARTUP_CALL(vkEnumerateDeviceExtensionProperties, device, nullptr, &extensionCount, nullptr);
 
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+    STARTUP_CALL(vkEnumerateDeviceExtensionProperties, device, nullptr, &extensionCount, availableExtensions.data());
 
     std::set<std::string> requiredExtensions(_deviceExtensions.begin(), _deviceExtensions.end());
 
-    std::cout << "Available Device extensions:" << std::endl;
     for (const auto& extension : availableExtensions) {
-        std::cout << "\t" << extension.extensionName << std::endl;
         requiredExtensions.erase(extension.extensionName);
     }
 
     return requiredExtensions.empty();
 }
 
+bool VulkanEngine::_hasDeviceExtension(VkPhysicalDevice device, const char* name)
+{
+    uint32_t extensionCount;
+    STARTUP_CALL(vkEnumerateDeviceExtensionProperties, device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    STARTUP_CALL(vkEnumerateDeviceExtensionProperties, device, nullptr, &extensionCount, availableExtensions.data());
+
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanEngine::_debugCallback(
-        VkDebugReportFlagsEXT flags,
-        VkDebugReportObjectTypeEXT objType,
-        uint64_t obj,
-        size_t location,
-        int32_t code,
-        const char* layerPrefix,
-        const char* msg,
+        VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+        VkDebugUtilsMessageTypeFlagsEXT types,
+        const VkDebugUtilsMessengerCallbackDataEXT* callbackData,
         void* userData)
 {
-    std::cerr << "[VK] ERROR validation layer: " << msg << std::endl;
+    /* Messages name the objects involved, and the labels open when recorded */
+    std::cerr << "[VK] " << (severity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT ? "ERROR" : "WARNING")
+              << (types & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT ? " performance" : " validation")
+              << " layer: " << callbackData->pMessage << std::endl;
     return VK_FALSE;
 }
 
@@ -401,7 +750,7 @@ VulkanEngine::QueueFamilyIndices VulkanEngine::_findQueueFamilies(VkPhysicalDevi
         }
 
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, _surface, &presentSupport);
+        STARTUP_CALL(vkGetPhysicalDeviceSurfaceSupportKHR, device, i, _surface, &presentSupport);
 
         if (queueFamily.queueCount > 0 && presentSupport) {
             indices.presentFamily = i;
@@ -420,22 +769,23 @@ VulkanEngine::QueueFamilyIndices VulkanEngine::_findQueueFamilies(VkPhysicalDevi
 VulkanEngine::SwapChainSupportDetails VulkanEngine::_querySwapChainSupport(VkPhysicalDevice device) {
     SwapChainSupportDetails details;
 
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, _surface, &details.capabilities);
+    STARTUP_CALL(vkGetPhysicalDeviceSurfaceCapabilitiesKHR, device, _surface, &details.capabilities);
 
     uint32_t formatCount;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(device, _surface, &formatCount, nullptr);
+    STARTUP_CALL(vkGetPhysicalDeviceSurfaceFormatsKHR, device, _surface, &formatCount, nullptr);
 
     if (formatCount != 0) {
         details.formats.resize(formatCount);
-        vkGetPhysicalDeviceSurfaceFormatsKHR(device, _surface, &formatCount, details.formats.data());
+        STARTUP_CALL(vkGetPhysicalDeviceSurfaceFormatsKHR, device, _surface, &formatCount, details.formats.data());
     }
 
     uint32_t presentModeCount;
-    vkGetPhysicalDeviceSurfacePresentModesKHR(device, _surface, &presentModeCount, nullptr);
+    STARTUP_CALL(vkGetPhysicalDeviceSurfacePresentModesKHR, device, _surface, &presentModeCount, nullptr);
 
     if (presentModeCount != 0) {
         details.presentModes.resize(presentModeCount);
-        vkGetPhysicalDeviceSurfacePresentModesKHR(device, _surface, &presentModeCount, details.presentModes.data());
+        STARTUP_CALL(vkGetPhysicalDeviceSurfacePresentModesKHR, device, _surface, &presentModeCount,
+                     details.presentModes.data());
     }
 
     return details;
@@ -509,6 +859,29 @@ void VulkanEngine::_createSwapChain() {
     createInfo.imageArrayLayers = 1;
     createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+    /**
+     * Dynamic resolution blits the frame to the swap chain image, and
+     * follows the GPU time of frames. Without timestamps it would pay for
+     * the blit without ever adapting.
+     */
+    if (const char* budget = std::getenv(kGpuFrameBudgetVariable)) {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(_physicalDevice, surfaceFormat.format, &formatProperties);
+        VkFormatFeatureFlags blit = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+        if (_timestampValidBits() == 0) {
+            std::cout << "Timestamps not supported by the graphics queue, frames render at full resolution" << std::endl;
+        } else if (!(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
+                (formatProperties.optimalTilingFeatures & blit) != blit) {
+            std::cout << "Swap chain images can't be blitted to, frames render at full resolution" << std::endl;
+        } else {
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            _upscaleFilter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ?
+                             VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+            _dynamicResolution.init(std::strtod(budget, nullptr) * 1e6, MAX_FRAMES_IN_FLIGHT);
+        }
+    }
+
     /* Setup the ownership of the swap chain images by the queue families */
     QueueFamilyIndices indices = _findQueueFamilies(_physicalDevice);
     uint32_t queueFamilyIndices[] = {(uint32_t) indices.graphicsFamily, (uint32_t) indices.presentFamily};
@@ -534,21 +907,26 @@ void VulkanEngine::_createSwapChain() {
     createInfo.clipped = VK_TRUE;
 
     /* Create the swap chain */
-    if (vkCreateSwapchainKHR(_device, &createInfo, nullptr, _swapChain.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkCreateSwapchainKHR, _device, &createInfo, hostAllocator(VK_OBJECT_TYPE_SWAPCHAIN_KHR),
+                     _swapChain.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create swap chain!");
     }
+    DEBUG_NAME(_swapChain, "swap chain");
 
     /* Create chain images */
-    vkGetSwapchainImagesKHR(_device, _swapChain, &imageCount, nullptr);
+    STARTUP_CALL(vkGetSwapchainImagesKHR, _device, _swapChain, &imageCount, nullptr);
     _swapChainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(_device, _swapChain, &imageCount, _swapChainImages.data());
+    STARTUP_CALL(vkGetSwapchainImagesKHR, _device, _swapChain, &imageCount, _swapChainImages.data());
+    for (uint32_t i = 0; i < imageCount; i++) {
+        DEBUG_NAME(_device, VK_OBJECT_TYPE_IMAGE, _swapChainImages[i], "swap chain image " + std::to_string(i));
+    }
 
     _swapChainImageFormat = surfaceFormat.format;
     _swapChainExtent = extent;
 }
 
 void VulkanEngine::_createImageViews() {
-    _swapChainImageViews.resize(_swapChainImages.size(), VDeleter<VkImageView>{_device, vkDestroyImageView});
+    resizeHandles(_swapChainImageViews, _swapChainImages.size(), _device);
 
     for (uint32_t i = 0; i < _swapChainImages.size(); i++) {
 
@@ -570,21 +948,22 @@ void VulkanEngine::_createImageViews() {
         createInfo.subresourceRange.baseArrayLayer = 0;
         createInfo.subresourceRange.layerCount = 1;
 
-        if (vkCreateImageView(_device, &createInfo, nullptr, _swapChainImageViews[i].replace()) != VK_SUCCESS) {
+        if (STARTUP_CALL(vkCreateImageView, _device, &createInfo, hostAllocator(VK_OBJECT_TYPE_IMAGE_VIEW),
+                         _swapChainImageViews[i].replace()) != VK_SUCCESS) {
             throw std::runtime_error("ERROR failed to create image views!");
         }
+        DEBUG_NAME(_swapChainImageViews[i], "swap chain image view " + std::to_string(i));
     }
 }
 
 void VulkanEngine::_createGraphicsPipeline() {
-    auto vertShaderCode = _readFile("glsl/triangle.vert.spv");
-    auto fragShaderCode = _readFile("glsl/triangle.frag.spv");
-
-    VDeleter<VkShaderModule> vertShaderModule{_device, vkDestroyShaderModule};
-    VDeleter<VkShaderModule> fragShaderModule{_device, vkDestroyShaderModule};
+    VDeleter<VkShaderModule> vertShaderModule{_device};
+    VDeleter<VkShaderModule> fragShaderModule{_device};
 
-    _createShaderModule(vertShaderCode, vertShaderModule);
-    _createShaderModule(fragShaderCode, fragShaderModule);
+    _createShaderModule(_vertShaderCode, vertShaderModule);
+    _createShaderModule(_fragShaderCode, fragShaderModule);
+    DEBUG_NAME(vertShaderModule, "triangle vertex shader");
+    DEBUG_NAME(fragShaderModule, "triangle fragment shader");
 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -612,24 +991,19 @@ void VulkanEngine::_createGraphicsPipeline() {
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float) _swapChainExtent.width;
-    viewport.height = (float) _swapChainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor = {};
-    scissor.offset = {0, 0};
-    scissor.extent = _swapChainExtent;
-
+    /* Set when recording, dynamic resolution changes them every frame */
     VkPipelineViewportStateCreateInfo viewportState = {};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
+    viewportState.pViewports = nullptr;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+    viewportState.pScissors = nullptr;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
 
     VkPipelineRasterizationStateCreateInfo rasterizer = {};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -647,12 +1021,25 @@ void VulkanEngine::_createGraphicsPipeline() {
     VkPipelineMultisampleStateCreateInfo multisampling = {};
     multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisampling.rasterizationSamples = _msaaSamples;
     multisampling.minSampleShading = 1.0f; // Optional
     multisampling.pSampleMask = nullptr; /// Optional
     multisampling.alphaToCoverageEnable = VK_FALSE; // Optional
     multisampling.alphaToOneEnable = VK_FALSE; // Optional
 
+    /**
+     * After the prepass only the fragments that laid down the depth pass,
+     * each pixel is shaded once. The vertex shader declares its position
+     * invariant, so both passes compute the very same depth.
+     */
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = _depthPrepass ? VK_FALSE : VK_TRUE;
+    depthStencil.depthCompareOp = _depthPrepass ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
     VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
     colorBlendAttachment.blendEnable = VK_FALSE;
@@ -681,9 +1068,11 @@ void VulkanEngine::_createGraphicsPipeline() {
     pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
     pipelineLayoutInfo.pPushConstantRanges = 0; // Optional
 
-    if (vkCreatePipelineLayout(_device, &pipelineLayoutInfo, nullptr, _pipelineLayout.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkCreatePipelineLayout, _device, &pipelineLayoutInfo,
+                     hostAllocator(VK_OBJECT_TYPE_PIPELINE_LAYOUT), _pipelineLayout.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create pipeline layout!");
     }
+    DEBUG_NAME(_pipelineLayout, "triangle pipeline layout");
 
     VkGraphicsPipelineCreateInfo pipelineInfo = {};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -694,18 +1083,51 @@ void VulkanEngine::_createGraphicsPipeline() {
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = nullptr; // Optional
+    pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr; // Optional
+    pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = _pipelineLayout;
     pipelineInfo.renderPass = _renderPass;
-    pipelineInfo.subpass = 0;
+    pipelineInfo.subpass = _depthPrepass ? 1 : 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1; // Optional
 
-    if (vkCreateGraphicsPipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, _graphicsPipeline.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkCreateGraphicsPipelines, _device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                     hostAllocator(VK_OBJECT_TYPE_PIPELINE), _graphicsPipeline.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create graphics pipeline!");
     }
+    DEBUG_NAME(_graphicsPipeline, "triangle pipeline");
+
+    if (_depthPrepass) {
+        /* Same vertex stage and state, without fragment shader nor color */
+        VkPipelineDepthStencilStateCreateInfo depthOnly = depthStencil;
+        depthOnly.depthWriteEnable = VK_TRUE;
+        depthOnly.depthCompareOp = VK_COMPARE_OP_LESS;
+
+        pipelineInfo.stageCount = 1;
+        pipelineInfo.pDepthStencilState = &depthOnly;
+        pipelineInfo.pColorBlendState = nullptr;
+        pipelineInfo.subpass = 0;
+
+        if (STARTUP_CALL(vkCreateGraphicsPipelines, _device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                         hostAllocator(VK_OBJECT_TYPE_PIPELINE), _depthPipeline.replace()) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to create depth pipeline!");
+        }
+        DEBUG_NAME(_depthPipeline, "triangle depth pipeline");
+    }
+
+    /* The triangle vertices are generated by the vertex shader */
+    RenderMesh triangle;
+    triangle.count = 3;
+
+    _pipelines = {_graphicsPipeline};
+    _depthPipelines = {_depthPipeline};
+    _meshes = {triangle};
+}
+
+void VulkanEngine::_loadShaders() {
+    _vertShaderCode = _readFile("glsl/triangle.vert.spv");
+    _fragShaderCode = _readFile("glsl/triangle.frag.spv");
 }
 
 void VulkanEngine::_createShaderModule(const std::vector<char>& code, VDeleter<VkShaderModule>& shaderModule) {
@@ -714,74 +1136,340 @@ void VulkanEngine::_createShaderModule(const std::vector<char>& code, VDeleter<V
     createInfo.codeSize = code.size();
     createInfo.pCode = (uint32_t*) code.data();
 
-    if (vkCreateShaderModule(_device, &createInfo, nullptr, shaderModule.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkCreateShaderModule, _device, &createInfo, hostAllocator(VK_OBJECT_TYPE_SHADER_MODULE),
+                     shaderModule.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create shader module!");
     }
 }
 
 void VulkanEngine::_createRenderPass() {
-    VkAttachmentDescription colorAttachment = {};
+    _depthFormat = _findDepthFormat();
+    _msaaSamples = _chooseSampleCount();
+    bool msaa = _msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+
+    /* The output of the pass is the swap chain image, or the scene upscaled to it afterwards */
+    bool upscale = _dynamicResolution.enabled();
+    VkImageLayout outputLayout = upscale ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    /**
+     * With the prepass, subpass 0 only writes depth and subpass 1 shades
+     * the fragments whose depth is equal to it, the visible ones. Without
+     * it a single subpass does both and relies on early depth tests, which
+     * only cull what is behind what was drawn before.
+     */
+    uint32_t depthSubpass = 0;
+    uint32_t shadingSubpass = _depthPrepass ? 1 : 0;
+
+    VkAttachmentDescription attachments[3] = {};
+
+    /**
+     * With MSAA the samples never leave the pass: they are resolved to the
+     * output at the end of the shading subpass and dropped, so a
+     * tiler keeps them on chip and never writes them to memory.
+     */
+    VkAttachmentDescription& colorAttachment = attachments[0];
     colorAttachment.format = _swapChainImageFormat;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.samples = _msaaSamples;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.storeOp = msaa ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = msaa ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : outputLayout;
+
+    /* Depth is only needed during the pass, so it is never stored */
+    VkAttachmentDescription& depthAttachment = attachments[1];
+    depthAttachment.format = _depthFormat;
+    depthAttachment.samples = _msaaSamples;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = _depthPrepass ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    /* Every pixel is written by the resolve, the output is never loaded */
+    VkAttachmentDescription& resolveAttachment = attachments[2];
+    resolveAttachment.format = _swapChainImageFormat;
+    resolveAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    resolveAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolveAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    resolveAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolveAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    resolveAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    resolveAttachment.finalLayout = outputLayout;
 
     VkAttachmentReference colorAttachmentRef = {};
     colorAttachmentRef.attachment = 0;
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-    VkSubpassDescription subPass = {};
-    subPass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subPass.colorAttachmentCount = 1;
-    subPass.pColorAttachments = &colorAttachmentRef;
+    VkAttachmentReference depthAttachmentRef = {};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference resolveAttachmentRef = {};
+    resolveAttachmentRef.attachment = 2;
+    resolveAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    /* The shading subpass only tests against the prepass depth, read only lets the driver skip decompressing it */
+    VkAttachmentReference depthReadOnlyRef = {};
+    depthReadOnlyRef.attachment = 1;
+    depthReadOnlyRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    VkSubpassDescription subPasses[2] = {};
+
+    VkSubpassDescription& depthPass = subPasses[depthSubpass];
+    depthPass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    depthPass.pDepthStencilAttachment = &depthAttachmentRef;
+
+    VkSubpassDescription& shadingPass = subPasses[shadingSubpass];
+    shadingPass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    shadingPass.colorAttachmentCount = 1;
+    shadingPass.pColorAttachments = &colorAttachmentRef;
+    shadingPass.pResolveAttachments = msaa ? &resolveAttachmentRef : nullptr;
+    shadingPass.pDepthStencilAttachment = _depthPrepass ? &depthReadOnlyRef : &depthAttachmentRef;
+
+    VkSubpassDependency dependencies[4] = {};
+    uint32_t dependencyCount = 2;
+
+    /**
+     * The multisampled color and the scene are shared by the frames in
+     * flight too, the previous frame must be done writing them and
+     * upscaling the scene
+     */
+    VkSubpassDependency& colorDependency = dependencies[0];
+    colorDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    colorDependency.dstSubpass = shadingSubpass;
+    colorDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    colorDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    colorDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    colorDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    /* The depth buffer is shared by the frames in flight, the previous frame must be done with it */
+    VkSubpassDependency& depthDependency = dependencies[1];
+    depthDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    depthDependency.dstSubpass = depthSubpass;
+    depthDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    if (_depthPrepass) {
+        VkSubpassDependency& prepassDependency = dependencies[dependencyCount++];
+        prepassDependency.srcSubpass = depthSubpass;
+        prepassDependency.dstSubpass = shadingSubpass;
+        prepassDependency.srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        prepassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        prepassDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        prepassDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        prepassDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+    }
+
+    /* The scene is upscaled once the shading subpass wrote it */
+    if (upscale) {
+        VkSubpassDependency& upscaleDependency = dependencies[dependencyCount++];
+        upscaleDependency.srcSubpass = shadingSubpass;
+        upscaleDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+        upscaleDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        upscaleDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        upscaleDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        upscaleDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    }
 
     VkRenderPassCreateInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subPass;
-
-    VkSubpassDependency dependency = {};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-    dependency.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    if (vkCreateRenderPass(_device, &renderPassInfo, nullptr, _renderPass.replace()) != VK_SUCCESS) {
+    renderPassInfo.attachmentCount = msaa ? 3 : 2;
+    renderPassInfo.pAttachments = attachments;
+    renderPassInfo.subpassCount = shadingSubpass + 1;
+    renderPassInfo.pSubpasses = subPasses;
+    renderPassInfo.dependencyCount = dependencyCount;
+    renderPassInfo.pDependencies = dependencies;
+
+    if (STARTUP_CALL(vkCreateRenderPass, _device, &renderPassInfo, hostAllocator(VK_OBJECT_TYPE_RENDER_PASS),
+                     _renderPass.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create render pass!");
     }
+    DEBUG_NAME(_renderPass, "main pass");
+}
+
+VkFormat VulkanEngine::_findDepthFormat() {
+    /* Without stencil first, nothing uses it. One of D32 or D24 is always supported. */
+    const VkFormat candidates[] = {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM};
+
+    for (VkFormat format : candidates) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(_physicalDevice, format, &properties);
+        if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error("ERROR failed to find a depth buffer format!");
+}
+
+VkSampleCountFlagBits VulkanEngine::_chooseSampleCount() {
+    uint32_t requested = kDefaultMsaaSamples;
+    if (const char* samples = std::getenv(kMsaaSamplesVariable)) {
+        requested = uint32_t(std::strtoul(samples, nullptr, 10));
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(_physicalDevice, &properties);
+    VkSampleCountFlags supported = properties.limits.framebufferColorSampleCounts & properties.limits.framebufferDepthSampleCounts;
+
+    for (uint32_t samples = VK_SAMPLE_COUNT_64_BIT; samples > VK_SAMPLE_COUNT_1_BIT; samples >>= 1) {
+        if (samples <= requested && (supported & samples)) {
+            std::cout << "MSAA with " << samples << " samples" << std::endl;
+            return VkSampleCountFlagBits(samples);
+        }
+    }
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+uint32_t VulkanEngine::_findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, VkMemoryPropertyFlags preferred) {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &memoryProperties);
+
+    if (preferred) {
+        VkMemoryPropertyFlags all = properties | preferred;
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & all) == all) {
+                return i;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("ERROR failed to find a suitable memory type!");
+}
+
+void VulkanEngine::_createAttachment(Attachment& attachment, VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage,
+                                     VkImageAspectFlags aspect, const std::string& name) {
+    _destroyAttachment(attachment);
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = _swapChainExtent.width;
+    imageInfo.extent.height = _swapChainExtent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage;
+    imageInfo.samples = samples;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (STARTUP_CALL(vkCreateImage, _device, &imageInfo, hostAllocator(VK_OBJECT_TYPE_IMAGE),
+                     attachment.image.replace()) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to create " + name + " image!");
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(_device, attachment.image, &memoryRequirements);
+
+    VkMemoryAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memoryRequirements.size;
+    /**
+     * Transient attachments never leave the pass. Tilers back them with
+     * lazily allocated memory, which is only committed if the tile memory
+     * falls short, other devices have none and take regular memory.
+     */
+    VkMemoryPropertyFlags preferred = (usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0;
+    allocInfo.memoryTypeIndex = _findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, preferred);
+
+    if (STARTUP_CALL(_memoryBudget.allocate, _device, allocInfo, &attachment.memory) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to allocate " + name + " memory!");
+    }
+    vkBindImageMemory(_device, attachment.image, attachment.memory, 0);
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = attachment.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = aspect;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (STARTUP_CALL(vkCreateImageView, _device, &viewInfo, hostAllocator(VK_OBJECT_TYPE_IMAGE_VIEW),
+                     attachment.view.replace()) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to create " + name + " image view!");
+    }
+
+    DEBUG_NAME(attachment.image, name);
+    DEBUG_NAME(_device, VK_OBJECT_TYPE_DEVICE_MEMORY, attachment.memory, name + " memory");
+    DEBUG_NAME(attachment.view, name + " view");
+}
+
+void VulkanEngine::_destroyAttachment(Attachment& attachment) {
+    /* Frames in flight may still render to it */
+    _deletionQueue.retire(attachment.view);
+    _deletionQueue.retire(attachment.image);
+    if (attachment.memory != VK_NULL_HANDLE) {
+        VkDeviceMemory memory = attachment.memory;
+        _deletionQueue.retire([this, memory]() { _memoryBudget.free(_device, memory); });
+        attachment.memory = VK_NULL_HANDLE;
+    }
+}
+
+void VulkanEngine::_createDepthResources() {
+    bool stencil = _depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || _depthFormat == VK_FORMAT_D24_UNORM_S8_UINT;
+    _createAttachment(_depthAttachment, _depthFormat, _msaaSamples, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                      VK_IMAGE_ASPECT_DEPTH_BIT | (stencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0), "depth buffer");
+}
+
+void VulkanEngine::_createColorResources() {
+    /* As big as the swap chain, frames render to a corner of it */
+    if (_dynamicResolution.enabled()) {
+        _createAttachment(_sceneAttachment, _swapChainImageFormat, VK_SAMPLE_COUNT_1_BIT,
+                          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT, "scene color");
+    }
+
+    /* Without MSAA the pass renders straight to its output */
+    if (_msaaSamples == VK_SAMPLE_COUNT_1_BIT) {
+        return;
+    }
+    _createAttachment(_colorAttachment, _swapChainImageFormat, _msaaSamples,
+                      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT, "msaa color");
 }
 
 void VulkanEngine::_createFramebuffers() {
-    _swapChainFramebuffers.resize(_swapChainImageViews.size(), VDeleter<VkFramebuffer>{_device, vkDestroyFramebuffer});
+    resizeHandles(_swapChainFramebuffers, _swapChainImageViews.size(), _device);
 
     for (size_t i = 0; i < _swapChainImageViews.size(); i++) {
+        bool msaa = _msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+        VkImageView output = _dynamicResolution.enabled() ? VkImageView(_sceneAttachment.view) : VkImageView(_swapChainImageViews[i]);
         VkImageView attachments[] = {
-            _swapChainImageViews[i]
+            msaa ? VkImageView(_colorAttachment.view) : output,
+            _depthAttachment.view,
+            output
         };
 
         VkFramebufferCreateInfo framebufferInfo = {};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = _renderPass;
-        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.attachmentCount = msaa ? 3 : 2;
         framebufferInfo.pAttachments = attachments;
         framebufferInfo.width = _swapChainExtent.width;
         framebufferInfo.height = _swapChainExtent.height;
         framebufferInfo.layers = 1;
 
-        if (vkCreateFramebuffer(_device, &framebufferInfo, nullptr, _swapChainFramebuffers[i].replace()) != VK_SUCCESS) {
+        if (STARTUP_CALL(vkCreateFramebuffer, _device, &framebufferInfo, hostAllocator(VK_OBJECT_TYPE_FRAMEBUFFER),
+                         _swapChainFramebuffers[i].replace()) != VK_SUCCESS) {
             throw std::runtime_error("ERROR failed to create framebuffer!");
         }
+        DEBUG_NAME(_swapChainFramebuffers[i], "swap chain framebuffer " + std::to_string(i));
     }
 }
 
@@ -791,15 +1479,17 @@ void VulkanEngine::_createCommandPool() {
     VkCommandPoolCreateInfo poolInfo = {};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
-    poolInfo.flags = 0; // Optional
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-    if (vkCreateCommandPool(_device, &poolInfo, nullptr, _commandPool.replace()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkCreateCommandPool, _device, &poolInfo, hostAllocator(VK_OBJECT_TYPE_COMMAND_POOL),
+                     _commandPool.replace()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to create command pool!");
     }
+    DEBUG_NAME(_commandPool, "frame command pool");
 }
 
 void VulkanEngine::_createCommandBuffers() {
-    _commandBuffers.resize(_swapChainFramebuffers.size());
+    _commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 
     VkCommandBufferAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -807,65 +1497,195 @@ void VulkanEngine::_createCommandBuffers() {
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     allocInfo.commandBufferCount = (uint32_t) _commandBuffers.size();
 
-    if (vkAllocateCommandBuffers(_device, &allocInfo, _commandBuffers.data()) != VK_SUCCESS) {
+    if (STARTUP_CALL(vkAllocateCommandBuffers, _device, &allocInfo, _commandBuffers.data()) != VK_SUCCESS) {
         throw std::runtime_error("ERROR failed to allocate command buffers!");
     }
+    for (uint32_t i = 0; i < _commandBuffers.size(); i++) {
+        DEBUG_NAME(_device, VK_OBJECT_TYPE_COMMAND_BUFFER, _commandBuffers[i], "frame " + std::to_string(i) + " command buffer");
+    }
+}
 
-    for (size_t i = 0; i < _commandBuffers.size(); i++) {
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-        beginInfo.pInheritanceInfo = nullptr; // Optional
+void VulkanEngine::_recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr; // Optional
+
+    if (_vk.vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to begin recording command buffer!");
+    }
 
-        vkBeginCommandBuffer(_commandBuffers[i], &beginInfo);
+    VkExtent2D renderExtent = _dynamicResolution.extent(_currentFrame, _swapChainExtent);
 
-        VkRenderPassBeginInfo renderPassInfo = {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = _renderPass;
-        renderPassInfo.framebuffer = _swapChainFramebuffers[i];
-        renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = _swapChainExtent;
+    VkRenderPassBeginInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = _renderPass;
+    renderPassInfo.framebuffer = _swapChainFramebuffers[imageIndex];
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = renderExtent;
 
-        VkClearValue clearColor = {0.0f, 0.0f, 0.0f, 1.0f};
-        renderPassInfo.clearValueCount = 1;
-        renderPassInfo.pClearValues = &clearColor;
+    VkClearValue clearValues[2] = {};
+    clearValues[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
+    clearValues[1].depthStencil = {1.0f, 0};
+    renderPassInfo.clearValueCount = 2;
+    renderPassInfo.pClearValues = clearValues;
 
-        vkCmdBeginRenderPass(_commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    if (_timestampMask) {
+        _vk.vkCmdResetQueryPool(commandBuffer, _timestampQueries, _currentFrame * kTimestampsPerFrame, kTimestampsPerFrame);
+        _vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _timestampQueries, _currentFrame * kTimestampsPerFrame);
+    }
+    _pipelineStatistics.reset(commandBuffer, _currentFrame);
+
+    {
+        DEBUG_LABEL(commandBuffer, "main pass");
+        _vk.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        VkViewport viewport = {};
+        viewport.width = (float) renderExtent.width;
+        viewport.height = (float) renderExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        _vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        _vk.vkCmdSetScissor(commandBuffer, 0, 1, &renderPassInfo.renderArea);
+
+        /* Queries can't span subpasses, each one is measured on its own */
+        if (_depthPrepass) {
+            DEBUG_LABEL(commandBuffer, "depth prepass");
+            _pipelineStatistics.begin(commandBuffer, _currentFrame, kDepthPrepass);
+            _renderQueue.record(_vk, commandBuffer, _depthPipelines, _meshes);
+            _pipelineStatistics.end(commandBuffer, _currentFrame, kDepthPrepass);
+        }
+
+        {
+            if (_depthPrepass) {
+                _vk.vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+            }
+            DEBUG_LABEL(commandBuffer, "shading");
+            _pipelineStatistics.begin(commandBuffer, _currentFrame, kShadingPass);
+            _renderQueue.record(_vk, commandBuffer, _pipelines, _meshes);
+            _pipelineStatistics.end(commandBuffer, _currentFrame, kShadingPass);
+        }
 
-        vkCmdBindPipeline(_commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipeline);
+        _vk.vkCmdEndRenderPass(commandBuffer);
+    }
 
-        vkCmdDraw(_commandBuffers[i], 3, 1, 0, 0);
+    if (_dynamicResolution.enabled()) {
+        DEBUG_LABEL(commandBuffer, "upscale");
+        _recordUpscale(commandBuffer, _swapChainImages[imageIndex], renderExtent);
+    }
 
-        vkCmdEndRenderPass(_commandBuffers[i]);
+    if (_timestampMask) {
+        _vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _timestampQueries, _currentFrame * kTimestampsPerFrame + 1);
+    }
 
-        if (vkEndCommandBuffer(_commandBuffers[i]) != VK_SUCCESS) {
-            throw std::runtime_error("ERROR failed to record command buffer!");
-        }
+    if (_vk.vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to record command buffer!");
     }
 }
 
-void VulkanEngine::_drawFrame() {
+void VulkanEngine::_recordUpscale(VkCommandBuffer commandBuffer, VkImage swapChainImage, VkExtent2D renderExtent) {
+    /* The render pass left the scene ready to be read, only the swap chain image needs a transition */
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = swapChainImage;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    /* The image available semaphore is waited for at the transfer stage, the barrier chains to it */
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkImageBlit blit = {};
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.mipLevel = 0;
+    blit.srcSubresource.baseArrayLayer = 0;
+    blit.srcSubresource.layerCount = 1;
+    blit.srcOffsets[1] = {int32_t(renderExtent.width), int32_t(renderExtent.height), 1};
+    blit.dstSubresource = blit.srcSubresource;
+    blit.dstOffsets[1] = {int32_t(_swapChainExtent.width), int32_t(_swapChainExtent.height), 1};
+
+    _vk.vkCmdBlitImage(commandBuffer, _sceneAttachment.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, _upscaleFilter);
+
+    /* Presentation waits on the render finished semaphore, which covers every stage */
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void VulkanEngine::_drawFrame(const FrameState& state) {
+    PROFILE_ZONE("draw frame");
+
+    /* Sorted before waiting, so it overlaps with the GPU */
+    {
+        PROFILE_ZONE("sort");
+        _renderQueue.sort(state.commands);
+    }
+
+    /* The command buffer and semaphores of this frame are free once its fence signals */
+    VkFence inFlightFence = _inFlightFences[_currentFrame];
+    {
+        PROFILE_ZONE("wait fence");
+        _vk.vkWaitForFences(_device, 1, &inFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    }
+    _vk.vkResetFences(_device, 1, &inFlightFence);
+
+    /* So are its queries */
+    _readTimestamps(_currentFrame);
+    _pipelineStatistics.collect(_currentFrame);
+
+    /* The previous use of this frame slot is complete, so is everything retired during it */
+    _deletionQueue.beginFrame(_currentFrame);
+
+    /* Evictions are retired into the bucket of this frame */
+    _memoryBudget.beginFrame(state.frame);
+
     uint32_t imageIndex;
-    vkAcquireNextImageKHR(_device, _swapChain, std::numeric_limits<uint64_t>::max(),
-            _imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    {
+        PROFILE_ZONE("acquire");
+        _vk.vkAcquireNextImageKHR(_device, _swapChain, std::numeric_limits<uint64_t>::max(),
+                _imageAvailableSemaphores[_currentFrame], VK_NULL_HANDLE, &imageIndex);
+    }
+
+    VkCommandBuffer commandBuffer = _commandBuffers[_currentFrame];
+    {
+        PROFILE_ZONE("record");
+        _recordCommandBuffer(commandBuffer, imageIndex);
+    }
 
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = {_imageAvailableSemaphore};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkSemaphore waitSemaphores[] = {_imageAvailableSemaphores[_currentFrame]};
+    VkPipelineStageFlags waitStages[] = {_dynamicResolution.enabled() ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &_commandBuffers[imageIndex];
+    submitInfo.pCommandBuffers = &commandBuffer;
 
-    VkSemaphore signalSemaphores[] = {_renderFinishedSemaphore};
+    VkSemaphore signalSemaphores[] = {_renderFinishedSemaphores[_currentFrame]};
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    if (vkQueueSubmit(_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
-        throw std::runtime_error("ERROR failed to submit draw command buffer!");
+    {
+        PROFILE_ZONE("submit");
+        _submitTicks[_currentFrame] = _timestampMask ? Profiler::now() : 0;
+        if (_vk.vkQueueSubmit(_graphicsQueue, 1, &submitInfo, inFlightFence) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to submit draw command buffer!");
+        }
     }
 
     VkPresentInfoKHR presentInfo = {};
@@ -881,17 +1701,120 @@ void VulkanEngine::_drawFrame() {
 
     presentInfo.pResults = nullptr; // Optional
 
-    vkQueuePresentKHR(_presentQueue, &presentInfo);
+    {
+        PROFILE_ZONE("present");
+        _vk.vkQueuePresentKHR(_presentQueue, &presentInfo);
+    }
+
+    if (_firstFrame) {
+        _firstFrame = false;
+        auto now = std::chrono::steady_clock::now();
+        std::cout << "Time to first frame: " << std::chrono::duration<double, std::milli>(now - _startTime).count() << " ms" << std::endl;
+
+        /* Startup is over, dump it for chrome://tracing or ui.perfetto.dev */
+        _startupTrace.record("first frame", "step", _startTime, now);
+        std::ofstream trace(kStartupTraceFile);
+        _startupTrace.writeChromeTrace(trace);
+        _startupTrace.report(std::cout);
+    }
+
+    _currentFrame = (_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
-void VulkanEngine::_createSemaphores() {
+void VulkanEngine::_createSyncObjects() {
+    resizeHandles(_imageAvailableSemaphores, MAX_FRAMES_IN_FLIGHT, _device);
+    resizeHandles(_renderFinishedSemaphores, MAX_FRAMES_IN_FLIGHT, _device);
+    resizeHandles(_inFlightFences, MAX_FRAMES_IN_FLIGHT, _device);
+
     VkSemaphoreCreateInfo semaphoreInfo = {};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, _imageAvailableSemaphore.replace()) != VK_SUCCESS ||
-            vkCreateSemaphore(_device, &semaphoreInfo, nullptr, _renderFinishedSemaphore.replace()) != VK_SUCCESS) {
-        throw std::runtime_error("ERROR failed to create semaphores!");
+    /* Created signaled, so the first wait on each of them returns right away */
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        if (STARTUP_CALL(vkCreateSemaphore, _device, &semaphoreInfo, hostAllocator(VK_OBJECT_TYPE_SEMAPHORE),
+                         _imageAvailableSemaphores[i].replace()) != VK_SUCCESS ||
+                STARTUP_CALL(vkCreateSemaphore, _device, &semaphoreInfo, hostAllocator(VK_OBJECT_TYPE_SEMAPHORE),
+                             _renderFinishedSemaphores[i].replace()) != VK_SUCCESS ||
+                STARTUP_CALL(vkCreateFence, _device, &fenceInfo, hostAllocator(VK_OBJECT_TYPE_FENCE),
+                             _inFlightFences[i].replace()) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to create synchronization objects!");
+        }
+        DEBUG_NAME(_imageAvailableSemaphores[i], "frame " + std::to_string(i) + " image available");
+        DEBUG_NAME(_renderFinishedSemaphores[i], "frame " + std::to_string(i) + " render finished");
+        DEBUG_NAME(_inFlightFences[i], "frame " + std::to_string(i) + " in flight");
+    }
+}
+
+uint32_t VulkanEngine::_timestampValidBits() {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(_physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    return queueFamilies[_findQueueFamilies(_physicalDevice).graphicsFamily].timestampValidBits;
+}
+
+void VulkanEngine::_createTimestampQueries() {
+    _submitTicks.assign(MAX_FRAMES_IN_FLIGHT, 0);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(_physicalDevice, &properties);
+
+    /* Frames are only profiled on the CPU if the graphics queue can't write timestamps */
+    uint32_t validBits = _timestampValidBits();
+    if (validBits == 0) {
+        std::cout << "Timestamps not supported by the graphics queue, GPU time won't be profiled" << std::endl;
+        return;
+    }
+
+    VkQueryPoolCreateInfo queryPoolInfo = {};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = MAX_FRAMES_IN_FLIGHT * kTimestampsPerFrame;
+
+    if (STARTUP_CALL(vkCreateQueryPool, _device, &queryPoolInfo, hostAllocator(VK_OBJECT_TYPE_QUERY_POOL),
+                     _timestampQueries.replace()) != VK_SUCCESS) {
+        throw std::runtime_error("ERROR failed to create timestamp query pool!");
+    }
+    DEBUG_NAME(_timestampQueries, "frame timestamps");
+
+    _timestampMask = validBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << validBits) - 1;
+    _timestampPeriod = properties.limits.timestampPeriod;
+}
+
+void VulkanEngine::_createStatisticsQueries() {
+    if (!_enabledFeatures.pipelineStatisticsQuery) {
+        if (std::getenv(kPipelineStatisticsVariable)) {
+            std::cout << "Pipeline statistics queries not supported by the device" << std::endl;
+        }
+        return;
+    }
+
+    _pipelineStatistics.init(_vk, kStatisticsPasses, MAX_FRAMES_IN_FLIGHT);
+}
+
+void VulkanEngine::_readTimestamps(uint32_t frame) {
+    if (!_submitTicks[frame]) {
+        return;
+    }
+
+    /* The frame's fence signaled, so there is no need to wait for them */
+    uint64_t timestamps[kTimestampsPerFrame];
+    VkResult result = _vk.vkGetQueryPoolResults(_device, _timestampQueries, frame * kTimestampsPerFrame, kTimestampsPerFrame,
+            sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result == VK_SUCCESS) {
+        uint64_t begin = timestamps[0] & _timestampMask;
+        uint64_t end = timestamps[1] & _timestampMask;
+        uint64_t gpuTime = uint64_t(((end - begin) & _timestampMask) * _timestampPeriod);
+        Profiler::instance().gpuZone("frame", _submitTicks[frame], uint64_t(begin * _timestampPeriod),
+                                     uint64_t(begin * _timestampPeriod) + gpuTime);
+        _dynamicResolution.update(frame, gpuTime);
     }
+    _submitTicks[frame] = 0;
 }
 
 std::vector<char> VulkanEngine::_readFile(const std::string& filename) {
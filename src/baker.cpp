@@ -0,0 +1,224 @@
+/**
+ * @file    baker.cpp
+ * @brief   Offline lighting baker for Wavefront obj meshes
+ *
+ *          Usage: baker <mesh.obj> <output prefix> [resolution] [samples] [threads]
+ *
+ *          Writes <output prefix>.ktx, an RGBA16F lightmap addressed with
+ *          the mesh uvs, and <output prefix>.ao, one R8 unorm ambient
+ *          occlusion value per vertex in the order the mesh is loaded.
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "LightBaker.hpp"
+
+#include <glm/gtc/half_float.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+/**
+ * Position, uv and normal indices of an obj face corner, 0 when missing
+ */
+typedef std::tuple<int, int, int> ObjCorner;
+
+int resolveObjIndex(int index, size_t count) {
+    return index < 0 ? int(count) + index + 1 : index;
+}
+
+/**
+ * Loads the triangles of an obj file, polygons are split as fans. Corners
+ * sharing the same indices share the same vertex.
+ */
+Mesh loadObj(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("ERROR could not open " + path);
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::map<ObjCorner, uint32_t> vertices;
+    bool hasUVs = true;
+    bool hasNormals = true;
+    Mesh mesh;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type == "v") {
+            glm::vec3 p;
+            stream >> p.x >> p.y >> p.z;
+            positions.push_back(p);
+        } else if (type == "vt") {
+            glm::vec2 uv;
+            stream >> uv.x >> uv.y;
+            uvs.push_back(uv);
+        } else if (type == "vn") {
+            glm::vec3 n;
+            stream >> n.x >> n.y >> n.z;
+            normals.push_back(n);
+        } else if (type == "f") {
+            std::vector<uint32_t> face;
+            std::string corner;
+            while (stream >> corner) {
+                int index[3] = {0, 0, 0};
+                std::istringstream fields(corner);
+                std::string field;
+                for (int i = 0; i < 3 && std::getline(fields, field, '/'); ++i) {
+                    index[i] = field.empty() ? 0 : std::atoi(field.c_str());
+                }
+
+                ObjCorner key(resolveObjIndex(index[0], positions.size()),
+                              resolveObjIndex(index[1], uvs.size()),
+                              resolveObjIndex(index[2], normals.size()));
+                if (std::get<0>(key) <= 0 || std::get<0>(key) > int(positions.size()) ||
+                    std::get<1>(key) > int(uvs.size()) || std::get<2>(key) > int(normals.size())) {
+                    throw std::runtime_error("ERROR invalid face in " + path + ": " + line);
+                }
+                hasUVs = hasUVs && std::get<1>(key) > 0;
+                hasNormals = hasNormals && std::get<2>(key) > 0;
+
+                auto vertex = vertices.find(key);
+                if (vertex == vertices.end()) {
+                    vertex = vertices.insert(std::make_pair(key, uint32_t(mesh.positions.size()))).first;
+                    mesh.positions.push_back(positions[std::get<0>(key) - 1]);
+                    mesh.uvs.push_back(std::get<1>(key) ? uvs[std::get<1>(key) - 1] : glm::vec2(0.0f));
+                    mesh.normals.push_back(std::get<2>(key) ? glm::normalize(normals[std::get<2>(key) - 1]) : glm::vec3(0.0f));
+                }
+                face.push_back(vertex->second);
+            }
+
+            for (size_t i = 2; i < face.size(); ++i) {
+                uint32_t triangle[] = {face[0], face[i - 1], face[i]};
+                mesh.indices.insert(mesh.indices.end(), triangle, triangle + 3);
+            }
+        }
+    }
+
+    if (!hasUVs) {
+        mesh.uvs.clear();
+    }
+    if (!hasNormals) {
+        mesh.normals.clear();
+    }
+    return mesh;
+}
+
+/**
+ * KTX 1.1 container with a single RGBA16F image, which the runtime can
+ * copy as is into a VK_FORMAT_R16G16B16A16_SFLOAT image
+ */
+void writeKtx(const std::string& path, const LightBaker::Lightmap& lightmap) {
+    const uint8_t identifier[] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    const uint32_t GL_HALF_FLOAT = 0x140B;
+    const uint32_t GL_RGBA = 0x1908;
+    const uint32_t GL_RGBA16F = 0x881A;
+
+    std::vector<glm::half> texels(lightmap.texels.size() * 4);
+    glm::packHalf(&lightmap.texels[0].x, texels.data(), texels.size());
+
+    uint32_t header[] = {
+        0x04030201,                                                      /* endianness */
+        GL_HALF_FLOAT,                                                   /* glType */
+        2,                                                               /* glTypeSize */
+        GL_RGBA,                                                         /* glFormat */
+        GL_RGBA16F,                                                      /* glInternalFormat */
+        GL_RGBA,                                                         /* glBaseInternalFormat */
+        lightmap.width,
+        lightmap.height,
+        0,                                                               /* pixelDepth */
+        0,                                                               /* numberOfArrayElements */
+        1,                                                               /* numberOfFaces */
+        1,                                                               /* numberOfMipmapLevels */
+        0                                                                /* bytesOfKeyValueData */
+    };
+    uint32_t imageSize = uint32_t(texels.size() * sizeof(glm::half));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(identifier), sizeof(identifier));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(&imageSize), sizeof(imageSize));
+    file.write(reinterpret_cast<const char *>(texels.data()), imageSize);
+    if (!file) {
+        throw std::runtime_error("ERROR could not write " + path);
+    }
+}
+
+void writeAO(const std::string& path, const std::vector<float>& ao) {
+    std::vector<uint8_t> values(ao.size());
+    for (size_t i = 0; i < ao.size(); ++i) {
+        values[i] = uint8_t(glm::clamp(ao[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(values.data()), values.size());
+    if (!file) {
+        throw std::runtime_error("ERROR could not write " + path);
+    }
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <mesh.obj> <output prefix> [resolution] [samples] [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    LightBaker::Settings settings;
+    if (argc > 3) {
+        settings.width = settings.height = uint32_t(std::atoi(argv[3]));
+    }
+    if (argc > 4) {
+        settings.samples = uint32_t(std::atoi(argv[4]));
+    }
+    if (argc > 5) {
+        settings.threads = uint32_t(std::atoi(argv[5]));
+    }
+    std::string prefix = argv[2];
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        Mesh mesh = loadObj(argv[1]);
+        std::cout << "Loaded " << mesh.positions.size() << " vertices, " << mesh.indices.size() / 3 << " triangles in "
+                  << secondsSince(start) << " s" << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        LightBaker baker(mesh, settings);
+        std::cout << "Built hierarchy in " << secondsSince(start) << " s" << std::endl;
+
+        if (!mesh.uvs.empty()) {
+            start = std::chrono::steady_clock::now();
+            writeKtx(prefix + ".ktx", baker.bakeLightmap());
+            std::cout << "Baked " << settings.width << "x" << settings.height << " lightmap in "
+                      << secondsSince(start) << " s" << std::endl;
+        } else {
+            std::cout << "No uvs, skipping the lightmap" << std::endl;
+        }
+
+        start = std::chrono::steady_clock::now();
+        writeAO(prefix + ".ao", baker.bakeVertexAO());
+        std::cout << "Baked vertex ambient occlusion in " << secondsSince(start) << " s" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
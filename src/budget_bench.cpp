@@ -0,0 +1,203 @@
+/**
+ * @file    budget_bench.cpp
+ * @brief   Eviction of MemoryBudget: fills a capped budget with streamable
+ *          blocks used in a known order, then allocates until it evicts
+ *
+ *          Checks the least recently used blocks go first, in order, and
+ *          that the heap ends under the low mark. Exits with an error if
+ *          not. No window needed.
+ *
+ *          Usage: budget_bench [device index]
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "HostAllocator.hpp"
+#include "MemoryBudget.hpp"
+#include "VDeleter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const VkDeviceSize kBlockSize = 1 << 20;
+const VkDeviceSize kBudget = 64 * kBlockSize;
+
+/**
+ * Streamables filling the budget, under the high mark (95%) of
+ * MemoryBudget so registering them evicts nothing
+ */
+const uint32_t kStreamables = 56;
+
+/**
+ * Low mark of MemoryBudget, eviction goes on until the heap is under it
+ */
+const double kLowWater = 0.85;
+
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        VkApplicationInfo appInfo = {};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pApplicationName = "budget_bench";
+        appInfo.apiVersion = VK_API_VERSION_1_0;
+
+        VkInstanceCreateInfo instanceInfo = {};
+        instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instanceInfo.pApplicationInfo = &appInfo;
+
+        VDeleter<VkInstance> instance;
+        if (vkCreateInstance(&instanceInfo, hostAllocator(VK_OBJECT_TYPE_INSTANCE), &instance) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR creating Vulkan instance");
+        }
+
+        uint32_t deviceCount = 0;
+        vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+        std::vector<VkPhysicalDevice> devices(deviceCount);
+        vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+        uint32_t deviceIndex = argc > 1 ? uint32_t(std::atoi(argv[1])) : 0;
+        if (deviceIndex >= devices.size()) {
+            throw std::runtime_error("ERROR no physical device " + std::to_string(deviceIndex));
+        }
+        VkPhysicalDevice physicalDevice = devices[deviceIndex];
+
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+        /* Memory is allocated from the device, any queue does */
+        float queuePriority = 1.0f;
+        VkDeviceQueueCreateInfo queueInfo = {};
+        queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueInfo.queueFamilyIndex = 0;
+        queueInfo.queueCount = 1;
+        queueInfo.pQueuePriorities = &queuePriority;
+
+        VkDeviceCreateInfo deviceInfo = {};
+        deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceInfo.queueCreateInfoCount = 1;
+        deviceInfo.pQueueCreateInfos = &queueInfo;
+
+        VDeleter<VkDevice> device;
+        if (vkCreateDevice(physicalDevice, &deviceInfo, hostAllocator(VK_OBJECT_TYPE_DEVICE), &device) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to create logical device!");
+        }
+
+        MemoryBudget budget;
+        budget.init(instance, physicalDevice, false);
+        budget.limit(kBudget);
+
+        /* Video memory if there is any, it is what streaming saves */
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        uint32_t memoryType = 0;
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+            if (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+                memoryType = i;
+                break;
+            }
+        }
+        uint32_t heap = memoryProperties.memoryTypes[memoryType].heapIndex;
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = kBlockSize;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        /**
+         * Nothing is in flight, so evicting frees the block right away
+         * instead of retiring it through a DeletionQueue
+         */
+        std::vector<uint32_t> evicted;
+        std::vector<VkDeviceMemory> blocks(kStreamables);
+        std::vector<uint64_t> streamables(kStreamables);
+        uint64_t frame = 1;
+        budget.beginFrame(frame);
+        for (uint32_t block = 0; block < kStreamables; ++block) {
+            VkDeviceMemory memory;
+            if (budget.allocate(device, allocInfo, &memory) != VK_SUCCESS) {
+                throw std::runtime_error("ERROR failed to allocate block " + std::to_string(block));
+            }
+            blocks[block] = memory;
+            streamables[block] = budget.addStreamable(memoryType, kBlockSize, [&, block]() {
+                evicted.push_back(block);
+                budget.free(device, blocks[block]);
+                blocks[block] = VK_NULL_HANDLE;
+            });
+        }
+        if (!evicted.empty()) {
+            throw std::runtime_error("ERROR filling the budget evicted " + std::to_string(evicted.size()) + " blocks");
+        }
+
+        /* Every block is used by a frame of its own, in a random order, the least recently used first */
+        std::vector<uint32_t> useOrder(kStreamables);
+        for (uint32_t block = 0; block < kStreamables; ++block) {
+            useOrder[block] = block;
+        }
+        std::shuffle(useOrder.begin(), useOrder.end(), std::mt19937(1));
+        for (uint32_t block : useOrder) {
+            budget.beginFrame(++frame);
+            budget.touch(streamables[block]);
+        }
+        budget.beginFrame(++frame);
+
+        /* Blocks that can't be evicted, allocated until some streamables have to go */
+        std::vector<VkDeviceMemory> pinned;
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration evicting{0};
+        while (evicted.empty()) {
+            auto allocateStart = std::chrono::steady_clock::now();
+            VkDeviceMemory memory;
+            if (budget.allocate(device, allocInfo, &memory) != VK_SUCCESS) {
+                throw std::runtime_error("ERROR failed to allocate pinned block " + std::to_string(pinned.size()));
+            }
+            evicting = std::chrono::steady_clock::now() - allocateStart;
+            pinned.push_back(memory);
+        }
+        auto total = std::chrono::steady_clock::now() - start;
+
+        for (size_t i = 0; i < evicted.size(); ++i) {
+            if (evicted[i] != useOrder[i]) {
+                throw std::runtime_error("ERROR eviction " + std::to_string(i) + " took block " + std::to_string(evicted[i]) +
+                                         ", the least recently used was " + std::to_string(useOrder[i]));
+            }
+        }
+
+        VkDeviceSize usage = budget.heaps()[heap].usage;
+        VkDeviceSize lowWater = VkDeviceSize(double(budget.heaps()[heap].budget) * kLowWater);
+        if (usage > lowWater) {
+            throw std::runtime_error("ERROR heap left at " + std::to_string(usage >> 20) + " MB, above the low mark of " +
+                                     std::to_string(lowWater >> 20) + " MB");
+        }
+
+        std::cout << "Device:                " << props.deviceName << std::endl;
+        std::cout << "Budget:                " << (kBudget >> 20) << " MB of " << (kBlockSize >> 20) << " MB blocks" << std::endl;
+        std::cout << "Pinned until eviction: " << pinned.size() << " blocks" << std::endl;
+        std::cout << "Evicted:               " << evicted.size() << " blocks, least recently used first" << std::endl;
+        std::cout << "Heap usage after:      " << (usage >> 20) << " MB, low mark " << (lowWater >> 20) << " MB" << std::endl;
+        std::cout << "Evicting allocation:   " << std::chrono::duration<double, std::micro>(evicting).count() << " us" << std::endl;
+        std::cout << "Pinned allocations:    " << std::chrono::duration<double, std::micro>(total).count() << " us" << std::endl;
+
+        for (VkDeviceMemory memory : pinned) {
+            budget.free(device, memory);
+        }
+        for (uint32_t block = 0; block < kStreamables; ++block) {
+            if (blocks[block] != VK_NULL_HANDLE) {
+                budget.removeStreamable(streamables[block]);
+                budget.free(device, blocks[block]);
+            }
+        }
+        budget.report(std::cout);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file    bvh_bench.cpp
+ * @brief   Ray tracing throughput of glm::bvh over a procedural terrain mesh
+ *
+ *          Usage: bvh_bench [grid size] [threads]
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "Mesh.hpp"
+
+#include <glm/gtx/bvh.hpp>
+#include <glm/gtx/noise_batch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint32_t kImageWidth = 1024;
+const uint32_t kImageHeight = 1024;
+const int kRepetitions = 4;
+
+/**
+ * Terrain of gridSize x gridSize quads over [-1, 1]², displaced with
+ * fractal perlin noise
+ */
+Mesh makeTerrain(uint32_t gridSize) {
+    Mesh mesh;
+    uint32_t side = gridSize + 1;
+
+    std::vector<float> heights(side * side);
+    glm::perlinFbm(glm::vec2(0.0f), glm::vec2(8.0f / gridSize), side, side, 5, 2.0f, 0.5f, heights.data(), 0);
+
+    mesh.positions.reserve(side * side);
+    for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+            glm::vec2 xy = glm::vec2(x, y) / float(gridSize) * 2.0f - 1.0f;
+            mesh.positions.push_back(glm::vec3(xy, heights[y * side + x] * 0.25f));
+        }
+    }
+
+    mesh.indices.reserve(gridSize * gridSize * 6);
+    for (uint32_t y = 0; y < gridSize; ++y) {
+        for (uint32_t x = 0; x < gridSize; ++x) {
+            uint32_t i = y * side + x;
+            uint32_t quad[] = {i, i + 1, i + side, i + 1, i + side + 1, i + side};
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+
+    return mesh;
+}
+
+/**
+ * Rays of one thread: a band of rows of the image, row major so that
+ * consecutive rays, and so the packets, are coherent
+ */
+struct RayBand {
+    glm::vec3soa origins;
+    glm::vec3soa directions;
+    glm::vec3soa hits;
+    std::vector<uint32_t> triangles;
+    std::vector<float> distances;
+    std::unique_ptr<bool[]> occluded;
+};
+
+void makePrimaryRays(RayBand& band, uint32_t firstRow, uint32_t lastRow) {
+    glm::vec3 eye(0.0f, -2.0f, 1.5f);
+    glm::vec3 forward = glm::normalize(-eye);
+    glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 0.0f, 1.0f)));
+    glm::vec3 up = glm::cross(right, forward);
+
+    size_t count = (lastRow - firstRow) * kImageWidth;
+    band.origins.resize(count);
+    band.directions.resize(count);
+    band.hits.resize(count);
+    band.triangles.resize(count);
+    band.distances.assign(count, 0.0f);
+    band.occluded.reset(new bool[count]);
+
+    size_t i = 0;
+    for (uint32_t y = firstRow; y < lastRow; ++y) {
+        for (uint32_t x = 0; x < kImageWidth; ++x, ++i) {
+            glm::vec2 ndc = (glm::vec2(x, y) + 0.5f) / glm::vec2(kImageWidth, kImageHeight) * 2.0f - 1.0f;
+            band.origins.set(i, eye);
+            band.directions.set(i, glm::normalize(forward + right * ndc.x + up * ndc.y));
+        }
+    }
+}
+
+void resetHits(RayBand& band) {
+    for (size_t i = 0; i < band.hits.size(); ++i) {
+        band.hits.set(i, glm::vec3(0.0f, 0.0f, 100.0f));
+    }
+}
+
+/**
+ * Turns the primary hits into shadow rays towards a directional light,
+ * which are far less coherent than the primary ones
+ */
+void makeShadowRays(RayBand& band) {
+    glm::vec3 toLight = glm::normalize(glm::vec3(0.4f, 0.3f, 1.0f));
+    for (size_t i = 0; i < band.hits.size(); ++i) {
+        float distance = band.hits[i].z;
+        bool hit = distance < 100.0f;
+        band.origins.set(i, band.origins[i] + band.directions[i] * distance + toLight * 1e-4f);
+        band.directions.set(i, toLight);
+        band.distances[i] = hit ? 100.0f : 0.0f;
+    }
+}
+
+/**
+ * Runs trace over every band, one thread per band, and returns the rays
+ * per second over kRepetitions runs
+ */
+double measure(std::vector<RayBand>& bands, const std::function<void(RayBand&)>& prepare, const std::function<void(RayBand&)>& trace) {
+    size_t rays = 0;
+    double seconds = 0.0;
+
+    for (int r = 0; r < kRepetitions; ++r) {
+        for (auto& band : bands) {
+            prepare(band);
+            rays += band.origins.size();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < bands.size(); ++i) {
+            workers.push_back(std::thread(trace, std::ref(bands[i])));
+        }
+        trace(bands[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return rays / seconds;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t gridSize = argc > 1 ? uint32_t(std::atoi(argv[1])) : 512;
+    uint32_t threads = argc > 2 ? uint32_t(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+    if (gridSize == 0 || threads == 0 || threads > kImageHeight) {
+        std::cerr << "Usage: " << argv[0] << " [grid size] [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Mesh mesh = makeTerrain(gridSize);
+
+    auto start = std::chrono::steady_clock::now();
+    glm::bvh bvh(mesh.positions.data(), mesh.indices.data(), mesh.indices.size(), threads);
+    double buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Triangles:       " << bvh.size() << std::endl;
+    std::cout << "Nodes:           " << bvh.nodes().size() << std::endl;
+    std::cout << "Build:           " << buildTime << " ms on " << threads << " thread(s)" << std::endl;
+    std::cout << "Packet width:    " << int(glm::detail::soa_packet<float>::size) << std::endl;
+
+    std::vector<RayBand> bands(threads);
+    uint32_t rowsPerBand = (kImageHeight + threads - 1) / threads;
+    for (uint32_t i = 0; i < threads; ++i) {
+        uint32_t firstRow = std::min(i * rowsPerBand, kImageHeight);
+        makePrimaryRays(bands[i], firstRow, std::min(firstRow + rowsPerBand, kImageHeight));
+    }
+
+    double single = measure(bands, resetHits, [&bvh](RayBand& band) {
+        for (size_t i = 0; i < band.origins.size(); ++i) {
+            glm::vec3 hit = band.hits[i];
+            if (bvh.intersect(band.origins[i], band.directions[i], hit, band.triangles[i])) {
+                band.hits.set(i, hit);
+            }
+        }
+    });
+    double packet = measure(bands, resetHits, [&bvh](RayBand& band) {
+        bvh.intersect(band.origins, band.directions, band.hits, band.triangles.data());
+    });
+
+    for (auto& band : bands) {
+        makeShadowRays(band);
+    }
+    double shadow = measure(bands, [](RayBand&) {}, [&bvh](RayBand& band) {
+        bvh.occluded(band.origins, band.directions, band.distances.data(), band.occluded.get());
+    });
+
+    std::cout << "Closest, single: " << single * 1e-6 << " Mrays/s" << std::endl;
+    std::cout << "Closest, packet: " << packet * 1e-6 << " Mrays/s" << std::endl;
+    std::cout << "Shadow, packet:  " << shadow * 1e-6 << " Mrays/s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
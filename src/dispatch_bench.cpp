@@ -0,0 +1,172 @@
+/**
+ * @file    dispatch_bench.cpp
+ * @brief   Cost of a device call through the loader trampolines and
+ *          through a DeviceDispatch table
+ *
+ *          Records vkCmdSetViewport, about the cheapest command there is,
+ *          on the first device with a graphics queue. No window needed.
+ *
+ *          Usage: dispatch_bench [device index]
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "DeviceDispatch.hpp"
+#include "HostAllocator.hpp"
+#include "VDeleter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const uint32_t kCallsPerBatch = 1 << 16;
+const uint32_t kBatches = 32;
+const uint32_t kRounds = 5;
+
+/**
+ * Records kBatches command buffers of kCallsPerBatch calls of record and
+ * returns the best time per call of kRounds, in nanoseconds. Beginning
+ * and ending the command buffers isn't timed.
+ */
+template <typename Record>
+double nanosecondsPerCall(VkCommandBuffer commandBuffer, Record record) {
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    double best = 1e30;
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        std::chrono::steady_clock::duration total{0};
+
+        for (uint32_t batch = 0; batch < kBatches; ++batch) {
+            if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+                throw std::runtime_error("ERROR failed to begin recording command buffer!");
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            record(kCallsPerBatch);
+            total += std::chrono::steady_clock::now() - start;
+
+            vkEndCommandBuffer(commandBuffer);
+        }
+
+        best = std::min(best, std::chrono::duration<double, std::nano>(total).count() / (kCallsPerBatch * kBatches));
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        VkApplicationInfo appInfo = {};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pApplicationName = "dispatch_bench";
+        appInfo.apiVersion = VK_API_VERSION_1_0;
+
+        VkInstanceCreateInfo instanceInfo = {};
+        instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instanceInfo.pApplicationInfo = &appInfo;
+
+        VDeleter<VkInstance> instance;
+        if (vkCreateInstance(&instanceInfo, hostAllocator(VK_OBJECT_TYPE_INSTANCE), &instance) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR creating Vulkan instance");
+        }
+
+        uint32_t deviceCount = 0;
+        vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+        std::vector<VkPhysicalDevice> devices(deviceCount);
+        vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+        uint32_t deviceIndex = argc > 1 ? uint32_t(std::atoi(argv[1])) : 0;
+        if (deviceIndex >= devices.size()) {
+            throw std::runtime_error("ERROR no physical device " + std::to_string(deviceIndex));
+        }
+        VkPhysicalDevice physicalDevice = devices[deviceIndex];
+
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        uint32_t graphicsFamily = 0;
+        while (graphicsFamily < queueFamilyCount && !(queueFamilies[graphicsFamily].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            graphicsFamily++;
+        }
+        if (graphicsFamily == queueFamilyCount) {
+            throw std::runtime_error("ERROR no graphics queue on " + std::string(props.deviceName));
+        }
+
+        float queuePriority = 1.0f;
+        VkDeviceQueueCreateInfo queueInfo = {};
+        queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueInfo.queueFamilyIndex = graphicsFamily;
+        queueInfo.queueCount = 1;
+        queueInfo.pQueuePriorities = &queuePriority;
+
+        VkDeviceCreateInfo deviceInfo = {};
+        deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceInfo.queueCreateInfoCount = 1;
+        deviceInfo.pQueueCreateInfos = &queueInfo;
+
+        VDeleter<VkDevice> device;
+        if (vkCreateDevice(physicalDevice, &deviceInfo, hostAllocator(VK_OBJECT_TYPE_DEVICE), &device) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to create logical device!");
+        }
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = graphicsFamily;
+
+        VDeleter<VkCommandPool> commandPool{device};
+        if (vkCreateCommandPool(device, &poolInfo, hostAllocator(VK_OBJECT_TYPE_COMMAND_POOL), &commandPool) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to create command pool!");
+        }
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("ERROR failed to allocate command buffers!");
+        }
+
+        DeviceDispatch vk;
+        vk.load(device);
+
+        VkViewport viewport = {0.0f, 0.0f, 1920.0f, 1080.0f, 0.0f, 1.0f};
+
+        double loader = nanosecondsPerCall(commandBuffer, [&](uint32_t calls) {
+            for (uint32_t i = 0; i < calls; ++i) {
+                vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            }
+        });
+        double table = nanosecondsPerCall(commandBuffer, [&](uint32_t calls) {
+            for (uint32_t i = 0; i < calls; ++i) {
+                vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            }
+        });
+
+        std::cout << "Device:                " << props.deviceName << std::endl;
+        std::cout << "Calls:                 " << kCallsPerBatch * kBatches << " x " << kRounds << " rounds" << std::endl;
+        std::cout << "Loader trampoline:     " << loader << " ns/call" << std::endl;
+        std::cout << "Dispatch table:        " << table << " ns/call" << std::endl;
+        std::cout << "Saved:                 " << loader - table << " ns/call" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
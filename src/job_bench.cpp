@@ -0,0 +1,91 @@
+/**
+ * @file    job_bench.cpp
+ * @brief   Scheduling overhead of JobSystem with empty jobs
+ *
+ *          Usage: job_bench [threads]
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "JobSystem.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+const uint32_t kFlatJobs = 1 << 20;
+const uint32_t kTreeDepth = 20;
+const uint32_t kChainJobs = 1 << 16;
+
+/**
+ * Runs test and returns its duration per job in nanoseconds
+ */
+template <typename Test>
+double nanosecondsPerJob(uint32_t jobs, Test test) {
+    auto start = std::chrono::steady_clock::now();
+    test();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / jobs;
+}
+
+/**
+ * Every job but the leaves queues two children, so jobs are created on
+ * every thread and spread by stealing
+ */
+void spawnTree(JobSystem& jobs, JobSystem::Counter& counter, uint32_t depth) {
+    if (depth == 0) {
+        return;
+    }
+    for (int i = 0; i < 2; ++i) {
+        jobs.run([&jobs, &counter, depth]() { spawnTree(jobs, counter, depth - 1); }, &counter);
+    }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t threads = argc > 1 ? uint32_t(std::atoi(argv[1])) : 0;
+    JobSystem jobs(threads);
+
+    std::cout << "Threads:               " << jobs.threadCount() << std::endl;
+
+    /* Jobs all queued by the main thread, the others steal them */
+    double flat = nanosecondsPerJob(kFlatJobs, [&jobs]() {
+        JobSystem::Counter counter;
+        for (uint32_t i = 0; i < kFlatJobs; ++i) {
+            jobs.run([]() {}, &counter);
+        }
+        jobs.wait(counter);
+    });
+    std::cout << "Flat:                  " << flat << " ns/job" << std::endl;
+
+    uint32_t treeJobs = (2u << kTreeDepth) - 2;
+    double tree = nanosecondsPerJob(treeJobs, [&jobs]() {
+        JobSystem::Counter counter;
+        spawnTree(jobs, counter, kTreeDepth);
+        jobs.wait(counter);
+    });
+    std::cout << "Recursive:             " << tree << " ns/job" << std::endl;
+
+    double parallelFor = nanosecondsPerJob(kFlatJobs, [&jobs]() {
+        jobs.parallelFor(kFlatJobs, 1, [](size_t, size_t) {});
+    });
+    std::cout << "parallelFor:           " << parallelFor << " ns/job" << std::endl;
+
+    /* Every job waits for the previous one, which measures the latency of releasing a dependency */
+    double chain = nanosecondsPerJob(kChainJobs, [&jobs]() {
+        std::unique_ptr<JobSystem::Counter[]> counters(new JobSystem::Counter[kChainJobs]);
+        jobs.run([]() {}, &counters[0]);
+        for (uint32_t i = 1; i < kChainJobs; ++i) {
+            jobs.run([]() {}, &counters[i], &counters[i - 1]);
+        }
+        jobs.wait(counters[kChainJobs - 1]);
+        for (uint32_t i = 0; i < kChainJobs; ++i) {
+            jobs.wait(counters[i]);
+        }
+    });
+    std::cout << "Dependency chain:      " << chain << " ns/job" << std::endl;
+
+    return EXIT_SUCCESS;
+}
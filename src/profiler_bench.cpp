@@ -0,0 +1,131 @@
+/**
+ * @file    profiler_bench.cpp
+ * @brief   Cost of a PROFILE_ZONE with the capture stopped and running, on
+ *          one thread and on every hardware thread at once
+ *
+ *          The two clock reads of a zone are timed on their own too, they
+ *          are most of its cost and far slower on some virtual machines.
+ *          Zones are recorded in batches that fit a ring, with a pause for
+ *          the writer thread to drain them in between, so no event is
+ *          dropped and every zone pays for the push. The pauses aren't
+ *          timed.
+ *
+ *          Usage: profiler_bench [trace path]
+ *
+ * @author	Roberto Cano (http://www.robertocano.es)
+ */
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * Half a ring, the writer thread may not have drained all of the last
+ * batch when the next one starts
+ */
+const uint32_t kZonesPerBatch = 1 << 13;
+const uint32_t kBatches = 16;
+const uint32_t kRounds = 5;
+
+/**
+ * Longer than the drain period of the Profiler
+ */
+const std::chrono::milliseconds kDrainWait(100);
+
+/**
+ * Records kBatches batches of kZonesPerBatch empty zones and returns the
+ * best time per zone of kRounds, in nanoseconds
+ */
+double nanosecondsPerZone() {
+    double best = 1e30;
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        std::chrono::steady_clock::duration total{0};
+
+        for (uint32_t batch = 0; batch < kBatches; ++batch) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t zone = 0; zone < kZonesPerBatch; ++zone) {
+                PROFILE_ZONE("profiler_bench zone");
+            }
+            total += std::chrono::steady_clock::now() - start;
+
+            if (Profiler::instance().capturing()) {
+                std::this_thread::sleep_for(kDrainWait);
+            }
+        }
+
+        best = std::min(best, std::chrono::duration<double, std::nano>(total).count() / (kZonesPerBatch * kBatches));
+    }
+    return best;
+}
+
+/**
+ * Best time of the two Profiler::now() of a zone, in nanoseconds
+ */
+double nanosecondsPerClockPair() {
+    double best = 1e30;
+    uint64_t sum = 0;
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t zone = 0; zone < kZonesPerBatch * kBatches; ++zone) {
+            sum += Profiler::now() - Profiler::now();
+        }
+        auto total = std::chrono::steady_clock::now() - start;
+        best = std::min(best, std::chrono::duration<double, std::nano>(total).count() / (kZonesPerBatch * kBatches));
+    }
+
+    /* Used, so the reads aren't optimized away */
+    return sum == 1 ? 0.0 : best;
+}
+
+/**
+ * nanosecondsPerZone on threads threads at once, the slowest of them
+ */
+double nanosecondsPerZone(uint32_t threads) {
+    std::vector<double> results(threads);
+    std::vector<std::thread> workers;
+    for (uint32_t thread = 0; thread < threads; ++thread) {
+        workers.emplace_back([&results, thread]() {
+            results[thread] = nanosecondsPerZone();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return *std::max_element(results.begin(), results.end());
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "profiler_bench.json";
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    /* The ring of the main thread is created outside the timed loops */
+    Profiler::instance().setThreadName("profiler_bench");
+
+    double clock = nanosecondsPerClockPair();
+    double stopped = nanosecondsPerZone();
+
+    if (!Profiler::instance().start(path)) {
+        std::cerr << "ERROR can't write " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    double capturing = nanosecondsPerZone();
+    double capturingAll = nanosecondsPerZone(threads);
+    Profiler::instance().stop();
+
+    std::cout << "Clock reads:            " << clock << " ns per zone" << std::endl;
+    std::cout << "Capture stopped:        " << stopped << " ns per zone" << std::endl;
+    std::cout << "Capturing, 1 thread:    " << capturing << " ns per zone" << std::endl;
+    std::cout << "Capturing, all threads: " << capturingAll << " ns per zone, slowest of " << threads << std::endl;
+    std::cout << "Trace:                  " << path << std::endl;
+
+    return EXIT_SUCCESS;
+}